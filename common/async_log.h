@@ -0,0 +1,732 @@
+#ifndef COMMON_ASYNC_LOG_H
+#define COMMON_ASYNC_LOG_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Journal asynchrone à faible latence, pour remplacer `std::cout << ... << std::endl` sur les
+// chemins chauds (pas de verrou du flux ni de flush par ligne dans le thread appelant) :
+//
+//   - chaque thread écrit dans son propre anneau SPSC (un producteur, un consommateur, sans verrou) ;
+//   - l'appel ne formate rien : il copie l'adresse de la chaîne de format (un littéral, vérifié à
+//     la compilation avec le nombre de {}), l'heure et les arguments en binaire ;
+//   - un thread de fond vide les anneaux, formate et écrit par gros blocs, en texte, ou en binaire
+//     compact (arguments tels quels, chaque format écrit une seule fois) relu ensuite par decode() ;
+//   - anneau plein : le message est perdu et compté (drop) ou l'appelant attend (block).
+//
+// Volontairement en C++20 : utilisé aussi par les exemples de cpp_20.
+//
+//     async_log::session logging;                         // démarre, vide et arrête à la fin de main
+//     async_log::info("Temperature: {} °C", value);
+//
+// Hors session (avant, après, ou sans session), chaque message est formaté et écrit sur la
+// sortie standard par l'appelant, de façon synchrone.
+namespace async_log {
+
+    enum class level : std::uint8_t { debug, info, warning, error };
+
+    enum class overflow { drop, block };
+
+    enum class output { text, binary };
+
+    struct config {
+        std::string path;                       // vide : sortie standard (texte seulement)
+        output format = output::text;
+        overflow policy = overflow::drop;
+        std::size_t ring_bytes = 1 << 20;       // par thread, arrondi à une puissance de 2
+        level min_level = level::info;
+        bool timestamps = false;                // texte : préfixe heure, thread et niveau
+    };
+
+    namespace detail {
+
+        enum class tag : std::uint8_t { i64, u64, f32, f64, boolean, character, string };
+
+        template <typename T>
+        concept string_like = std::convertible_to<const T&, std::string_view>;
+
+        template <typename T>
+        concept loggable = std::integral<T> || std::floating_point<T> || string_like<T>;
+
+        // Nombre de {} d'un format, {{ et }} étant des accolades littérales
+        consteval std::size_t count_placeholders(const char* s) {
+            std::size_t count = 0;
+            for (; *s; ++s) {
+                if (s[0] == '{' && s[1] == '{') ++s;
+                else if (s[0] == '}' && s[1] == '}') ++s;
+                else if (s[0] == '{' && s[1] == '}') ++count, ++s;
+            }
+            return count;
+        }
+
+        // Appelée seulement si le nombre de {} ne correspond pas : erreur à la compilation
+        inline void placeholder_count_mismatch() {}
+
+        template <loggable T>
+        std::size_t encoded_size(const T& value) {
+            if constexpr (string_like<T>) return 1 + sizeof(std::uint32_t) + std::string_view(value).size();
+            else if constexpr (std::same_as<T, bool> || std::same_as<T, char>) return 2;
+            else if constexpr (std::same_as<T, float>) return 1 + sizeof(float);
+            else return 9;
+        }
+
+        template <typename V>
+        char* put(char* out, tag t, const V& value) {
+            *out++ = static_cast<char>(t);
+            std::memcpy(out, &value, sizeof value);
+            return out + sizeof value;
+        }
+
+        template <loggable T>
+        char* encode(char* out, const T& value) {
+            if constexpr (string_like<T>) {
+                const std::string_view text(value);
+                out = put(out, tag::string, static_cast<std::uint32_t>(text.size()));
+                std::memcpy(out, text.data(), text.size());
+                return out + text.size();
+            } else if constexpr (std::same_as<T, bool>) {
+                return put(out, tag::boolean, static_cast<std::uint8_t>(value));
+            } else if constexpr (std::same_as<T, char>) {
+                return put(out, tag::character, value);
+            } else if constexpr (std::same_as<T, float>) {
+                return put(out, tag::f32, value);
+            } else if constexpr (std::floating_point<T>) {
+                return put(out, tag::f64, static_cast<double>(value));
+            } else if constexpr (std::is_signed_v<T>) {
+                return put(out, tag::i64, static_cast<std::int64_t>(value));
+            } else {
+                return put(out, tag::u64, static_cast<std::uint64_t>(value));
+            }
+        }
+
+        // Arguments à la suite les uns des autres (rien à écrire pour un message sans argument)
+        template <loggable... Args>
+        void encode_all([[maybe_unused]] char* out, const Args&... args) {
+            ((out = encode(out, args)), ...);
+        }
+
+        template <typename V>
+        bool take(const char*& in, const char* end, V& value) {
+            if (static_cast<std::size_t>(end - in) < sizeof value) return false;
+            std::memcpy(&value, in, sizeof value);
+            in += sizeof value;
+            return true;
+        }
+
+        template <typename V>
+        void append_number(std::string& out, V value) {
+            char digits[32];
+            const auto result = std::to_chars(digits, digits + sizeof digits, value);
+            out.append(digits, result.ptr);
+        }
+
+        // Ajoute à out le format avec ses {} remplacés par les arguments encodés ; false si
+        // les arguments manquent ou sont invalides
+        inline bool format_payload(std::string_view format, const char* payload, std::size_t size, std::string& out) {
+            const char* in = payload;
+            const char* const end = payload + size;
+            for (std::size_t i = 0; i < format.size(); ++i) {
+                const char c = format[i];
+                const char next = i + 1 < format.size() ? format[i + 1] : '\0';
+                if ((c == '{' || c == '}') && next == c) {
+                    out += c;
+                    ++i;
+                    continue;
+                }
+                if (c != '{' || next != '}') {
+                    out += c;
+                    continue;
+                }
+                ++i;
+                if (in == end) return false;
+                switch (static_cast<tag>(*in++)) {
+                    case tag::i64: { std::int64_t v; if (!take(in, end, v)) return false; append_number(out, v); break; }
+                    case tag::u64: { std::uint64_t v; if (!take(in, end, v)) return false; append_number(out, v); break; }
+                    case tag::f32: { float v; if (!take(in, end, v)) return false; append_number(out, v); break; }
+                    case tag::f64: { double v; if (!take(in, end, v)) return false; append_number(out, v); break; }
+                    case tag::boolean: { std::uint8_t v; if (!take(in, end, v)) return false; out += v ? "true" : "false"; break; }
+                    case tag::character: { char v; if (!take(in, end, v)) return false; out += v; break; }
+                    case tag::string: {
+                        std::uint32_t length;
+                        if (!take(in, end, length) || static_cast<std::size_t>(end - in) < length) return false;
+                        out.append(in, length);
+                        in += length;
+                        break;
+                    }
+                    default: return false;
+                }
+            }
+            return true;
+        }
+
+        inline std::uint64_t now_ns() {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        inline std::string_view level_name(level l) {
+            switch (l) {
+                case level::debug: return "DEBUG";
+                case level::info: return "INFO ";
+                case level::warning: return "WARN ";
+                case level::error: return "ERROR";
+            }
+            return "?    ";
+        }
+
+        // "[HH:MM:SS.uuuuuu T3 INFO ] " (heure UTC)
+        inline void append_prefix(std::string& out, std::uint64_t timestamp, std::uint32_t thread, level l) {
+            const std::uint64_t micros = timestamp / 1000 % 1'000'000;
+            const std::uint64_t seconds = timestamp / 1'000'000'000 % 86400;
+            char text[40];
+            const auto two = [&](char* p, std::uint64_t v) { p[0] = static_cast<char>('0' + v / 10); p[1] = static_cast<char>('0' + v % 10); };
+            text[0] = '[';
+            two(text + 1, seconds / 3600);
+            text[3] = ':';
+            two(text + 4, seconds / 60 % 60);
+            text[6] = ':';
+            two(text + 7, seconds % 60);
+            text[9] = '.';
+            std::uint64_t rest = micros;
+            for (int i = 15; i >= 10; --i, rest /= 10) text[i] = static_cast<char>('0' + rest % 10);
+            out.append(text, 16);
+            out += " T";
+            append_number(out, thread);
+            out += ' ';
+            out += level_name(l);
+            out += "] ";
+        }
+
+        // En-tête de chaque message dans l'anneau, suivi des arguments encodés ; tailles multiples de 8
+        struct record_header {
+            std::uint32_t size;             // en-tête compris ; avec padding_flag : saut jusqu'au début de l'anneau
+            level lvl;
+            std::uint8_t tail_padding;      // octets de bourrage après les arguments
+            std::uint16_t unused;
+            const char* format;
+            std::uint64_t timestamp;        // ns depuis l'epoch
+        };
+        static_assert(sizeof(record_header) == 24);
+
+        inline constexpr std::uint32_t padding_flag = 0x80000000u;
+
+        // Anneau d'octets à un producteur (le thread propriétaire) et un consommateur (le thread de
+        // fond). Positions croissantes sur 64 bits ; chacun garde une copie locale de la position
+        // de l'autre et ne relit l'atomique que quand elle ne suffit plus.
+        class ring {
+        public:
+            ring(std::size_t bytes, std::uint32_t thread)
+                    : capacity_(std::bit_ceil(std::max<std::size_t>(bytes, 4096))), mask_(capacity_ - 1),
+                      data_(new char[capacity_]), thread_(thread) {}
+
+            std::size_t capacity() const { return capacity_; }
+            std::uint32_t thread() const { return thread_; }
+
+            // n multiple de 8 ; nullptr si l'anneau est plein
+            char* reserve(std::size_t n) {
+                const std::uint64_t head = head_.load(std::memory_order_relaxed);
+                const std::size_t offset = head & mask_;
+                const std::size_t contiguous = capacity_ - offset;
+                const std::size_t needed = n <= contiguous ? n : n + contiguous;
+                if (capacity_ - (head - cached_tail_) < needed) {
+                    cached_tail_ = tail_.load(std::memory_order_acquire);
+                    if (capacity_ - (head - cached_tail_) < needed) return nullptr;
+                }
+                if (n <= contiguous) return data_.get() + offset;
+                // Pas la place avant la fin : marque de saut, le message commence au début
+                const std::uint32_t skip = static_cast<std::uint32_t>(contiguous) | padding_flag;
+                std::memcpy(data_.get() + offset, &skip, sizeof skip);
+                head_.store(head + contiguous, std::memory_order_release);
+                return data_.get();
+            }
+
+            void commit(std::size_t n) {
+                head_.store(head_.load(std::memory_order_relaxed) + n, std::memory_order_release);
+            }
+
+            void count_drop() { dropped_.fetch_add(1, std::memory_order_relaxed); }
+            std::uint64_t take_dropped() { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+            // Publication en cours par le propriétaire : stop() attend qu'elle se termine.
+            // seq_cst : l'écriture précède la relecture de running_ (voir backend::begin_write)
+            void begin_write() { writing_.store(true); }
+            void end_write() { writing_.store(false, std::memory_order_release); }
+            bool writing() const { return writing_.load(); }
+
+            void close() { closed_.store(true, std::memory_order_release); }
+            bool closed() const { return closed_.load(std::memory_order_acquire); }
+            bool empty() const { return tail_.load(std::memory_order_relaxed) == head_.load(std::memory_order_acquire); }
+
+            // visit(header, arguments, taille) pour chaque message publié ; rend le nombre de messages
+            template <typename Visit>
+            std::size_t drain(Visit&& visit) {
+                const std::uint64_t head = head_.load(std::memory_order_acquire);
+                std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+                std::size_t count = 0;
+                while (tail != head) {
+                    const char* p = data_.get() + (tail & mask_);
+                    std::uint32_t size;
+                    std::memcpy(&size, p, sizeof size);
+                    if (size & padding_flag) {
+                        tail += size & ~padding_flag;
+                        continue;
+                    }
+                    record_header header;
+                    std::memcpy(&header, p, sizeof header);
+                    visit(header, p + sizeof header, size - sizeof header - header.tail_padding);
+                    tail += size;
+                    ++count;
+                }
+                tail_.store(tail, std::memory_order_release);
+                return count;
+            }
+
+        private:
+            const std::size_t capacity_;
+            const std::size_t mask_;
+            std::unique_ptr<char[]> data_;
+            const std::uint32_t thread_;
+            std::uint64_t cached_tail_ = 0;
+            alignas(64) std::atomic<std::uint64_t> head_{0};
+            alignas(64) std::atomic<std::uint64_t> tail_{0};
+            alignas(64) std::atomic<std::uint64_t> dropped_{0};
+            std::atomic<bool> closed_{false};
+            std::atomic<bool> writing_{false};
+        };
+
+        // Termine la publication à la sortie de log(), quel que soit le chemin
+        struct write_scope {
+            ring& r;
+            ~write_scope() { r.end_write(); }
+        };
+
+        // Fichier binaire : "ALOG" + version sur 4 octets, puis des enregistrements (ordre des
+        // octets de la machine) :
+        //   'F' id:u32 longueur:u32 texte                 chaîne de format, une fois par format
+        //   'M' format:u32 thread:u32 niveau:u8 heure:u64 taille:u32 arguments
+        //   'D' thread:u32 nombre:u64                     messages perdus, anneau plein
+        inline constexpr char file_magic[8] = {'A', 'L', 'O', 'G', 1, 0, 0, 0};
+
+        template <typename V>
+        void append_raw(std::string& out, const V& value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof value);
+        }
+
+        // Sortie du thread de fond, tamponnée et écrite par blocs
+        class sink {
+        public:
+            void open(const config& settings) {
+                format_ = settings.format;
+                timestamps_ = settings.timestamps;
+                formats_.clear();
+                if (settings.path.empty()) {
+                    fd_ = STDOUT_FILENO;
+                    owned_ = false;
+                    format_ = output::text;
+                } else {
+                    fd_ = ::open(settings.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+                    owned_ = fd_ >= 0;
+                }
+                if (format_ == output::binary) buffer_.append(file_magic, sizeof file_magic);
+            }
+
+            void close() {
+                flush();
+                if (owned_) ::close(fd_);
+                fd_ = -1;
+                owned_ = false;
+            }
+
+            void message(const record_header& header, const char* payload, std::size_t size, std::uint32_t thread) {
+                if (format_ == output::text) {
+                    if (timestamps_) append_prefix(buffer_, header.timestamp, thread, header.lvl);
+                    if (!format_payload(header.format, payload, size, buffer_)) buffer_ += " <arguments invalides>";
+                    buffer_ += '\n';
+                } else {
+                    auto [it, added] = formats_.try_emplace(header.format, static_cast<std::uint32_t>(formats_.size()));
+                    if (added) {
+                        const std::string_view text(header.format);
+                        buffer_ += 'F';
+                        append_raw(buffer_, it->second);
+                        append_raw(buffer_, static_cast<std::uint32_t>(text.size()));
+                        buffer_ += text;
+                    }
+                    buffer_ += 'M';
+                    append_raw(buffer_, it->second);
+                    append_raw(buffer_, thread);
+                    append_raw(buffer_, header.lvl);
+                    append_raw(buffer_, header.timestamp);
+                    append_raw(buffer_, static_cast<std::uint32_t>(size));
+                    buffer_.append(payload, size);
+                }
+                if (buffer_.size() >= (std::size_t{1} << 16)) flush();
+            }
+
+            void dropped(std::uint32_t thread, std::uint64_t count) {
+                if (format_ == output::text) {
+                    buffer_ += "[async_log] ";
+                    append_number(buffer_, count);
+                    buffer_ += " messages perdus (anneau plein, thread ";
+                    append_number(buffer_, thread);
+                    buffer_ += ")\n";
+                } else {
+                    buffer_ += 'D';
+                    append_raw(buffer_, thread);
+                    append_raw(buffer_, count);
+                }
+            }
+
+            void flush() {
+                std::size_t written = 0;
+                while (fd_ >= 0 && written < buffer_.size()) {
+                    const ssize_t n = ::write(fd_, buffer_.data() + written, buffer_.size() - written);
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n <= 0) break;
+                    written += static_cast<std::size_t>(n);
+                }
+                buffer_.clear();
+            }
+
+        private:
+            int fd_ = -1;
+            bool owned_ = false;
+            output format_ = output::text;
+            bool timestamps_ = false;
+            std::string buffer_;
+            std::unordered_map<const char*, std::uint32_t> formats_;
+        };
+
+        // Arguments encodés d'un message écrit hors session
+        inline std::string& direct_buffer() {
+            thread_local std::string buffer;
+            return buffer;
+        }
+
+        // Anneaux de tous les threads et thread de fond ; un seul par processus
+        class backend {
+        public:
+            static backend& instance() {
+                static backend b;
+                return b;
+            }
+
+            ~backend() { stop(); }
+
+            void start(config settings) {
+                std::lock_guard lock(control_);
+                start_locked(std::move(settings));
+            }
+
+            // Hors session : message formaté et écrit sur la sortie standard par l'appelant
+            void write_now(const char* format, const char* payload, std::size_t size) {
+                std::string line;
+                if (!format_payload(format, payload, size, line)) line += " <arguments invalides>";
+                line += '\n';
+                std::lock_guard lock(direct_mutex_);
+                for (std::size_t written = 0; written < line.size();) {
+                    const ssize_t n = ::write(STDOUT_FILENO, line.data() + written, line.size() - written);
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n <= 0) break;
+                    written += static_cast<std::size_t>(n);
+                }
+            }
+
+            void stop() {
+                std::lock_guard lock(control_);
+                stop_locked();
+            }
+
+            // Attend que tout ce qui a été publié avant l'appel soit écrit
+            void flush() {
+                if (!running_.load(std::memory_order_acquire)) return;
+                std::unique_lock lock(flush_mutex_);
+                const std::uint64_t target = flush_requested_.fetch_add(1, std::memory_order_acq_rel) + 1;
+                flush_done_cv_.wait(lock, [&] { return flush_done_ >= target || !running_.load(std::memory_order_acquire); });
+            }
+
+            bool running() const { return running_.load(std::memory_order_acquire); }
+
+            // Anneau du thread appelant marqué en écriture, nullptr hors session. Soit la relecture
+            // voit l'arrêt et le message part en direct, soit stop() voit la marque et attend le
+            // commit avant le dernier vidage : aucun message publié n'est perdu.
+            ring* begin_write() {
+                if (!running()) return nullptr;
+                ring& r = local_ring();
+                r.begin_write();
+                if (running_.load()) return &r;
+                r.end_write();
+                return nullptr;
+            }
+            level min_level() const { return min_level_.load(std::memory_order_relaxed); }
+            overflow policy() const { return policy_.load(std::memory_order_relaxed); }
+            std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+            ring& local_ring() {
+                // Fermé à la sortie du thread ; le thread de fond le libère une fois vide
+                struct producer {
+                    std::shared_ptr<ring> r;
+                    ~producer() { if (r) r->close(); }
+                };
+                thread_local producer local;
+                if (!local.r) local.r = make_ring();
+                return *local.r;
+            }
+
+        private:
+            backend() = default;
+
+            void start_locked(config settings) {
+                stop_locked();
+                min_level_.store(settings.min_level, std::memory_order_relaxed);
+                policy_.store(settings.policy, std::memory_order_relaxed);
+                ring_bytes_.store(settings.ring_bytes, std::memory_order_relaxed);
+                sink_.open(settings);
+                stopping_.store(false, std::memory_order_relaxed);
+                running_.store(true, std::memory_order_release);
+                worker_ = std::thread([this] { run(); });
+            }
+
+            std::shared_ptr<ring> make_ring() {
+                std::lock_guard lock(rings_mutex_);
+                auto r = std::make_shared<ring>(ring_bytes_.load(std::memory_order_relaxed), next_thread_++);
+                rings_.push_back(r);
+                generation_.fetch_add(1, std::memory_order_release);
+                return r;
+            }
+
+            void stop_locked() {
+                if (!worker_.joinable()) return;
+                running_.store(false);  // seq_cst : voir begin_write()
+                // Publications commencées avant l'arrêt : terminées avant le dernier vidage
+                std::vector<std::shared_ptr<ring>> rings;
+                {
+                    std::lock_guard lock(rings_mutex_);
+                    rings = rings_;
+                }
+                for (const auto& r : rings) {
+                    while (r->writing()) std::this_thread::yield();
+                }
+                stopping_.store(true, std::memory_order_release);
+                worker_.join();
+                sink_.close();
+                std::lock_guard lock(flush_mutex_);
+                flush_done_cv_.notify_all();
+            }
+
+            void run() {
+                std::vector<std::shared_ptr<ring>> rings;
+                std::uint64_t seen_generation = ~std::uint64_t{0};
+                auto pause = std::chrono::microseconds(20);
+                for (;;) {
+                    // Lus avant de vider : tout ce qui a été publié avant stop() ou flush() sera écrit
+                    const bool stopping = stopping_.load(std::memory_order_acquire);
+                    const std::uint64_t flush_target = flush_requested_.load(std::memory_order_acquire);
+                    if (generation_.load(std::memory_order_acquire) != seen_generation) {
+                        std::lock_guard lock(rings_mutex_);
+                        rings = rings_;
+                        seen_generation = generation_.load(std::memory_order_relaxed);
+                    }
+
+                    std::size_t handled = 0;
+                    bool retired = false;
+                    for (const auto& r : rings) {
+                        const bool closed = r->closed();
+                        handled += r->drain([&](const record_header& header, const char* payload, std::size_t size) {
+                            sink_.message(header, payload, size, r->thread());
+                        });
+                        if (const std::uint64_t lost = r->take_dropped()) {
+                            sink_.dropped(r->thread(), lost);
+                            dropped_.fetch_add(lost, std::memory_order_relaxed);
+                        }
+                        retired |= closed && r->empty();
+                    }
+                    if (retired) {
+                        std::lock_guard lock(rings_mutex_);
+                        std::erase_if(rings_, [](const auto& r) { return r->closed() && r->empty(); });
+                        generation_.fetch_add(1, std::memory_order_release);
+                    }
+
+                    if (handled == 0 || stopping || flush_target != flush_seen_) sink_.flush();
+                    if (flush_target != flush_seen_) {
+                        flush_seen_ = flush_target;
+                        std::lock_guard lock(flush_mutex_);
+                        flush_done_ = flush_target;
+                        flush_done_cv_.notify_all();
+                    }
+                    if (stopping) return;
+                    if (handled == 0) {
+                        std::this_thread::sleep_for(pause);
+                        pause = std::min(pause * 2, std::chrono::microseconds(1000));
+                    } else {
+                        pause = std::chrono::microseconds(20);
+                    }
+                }
+            }
+
+            std::mutex control_;
+            std::thread worker_;
+            std::atomic<bool> running_{false};
+            std::atomic<bool> stopping_{false};     // demande au thread de fond de finir
+            std::mutex direct_mutex_;
+            std::atomic<level> min_level_{level::info};
+            std::atomic<overflow> policy_{overflow::drop};
+            std::atomic<std::size_t> ring_bytes_{std::size_t{1} << 20};
+            std::atomic<std::uint64_t> dropped_{0};
+
+            std::mutex rings_mutex_;
+            std::vector<std::shared_ptr<ring>> rings_;
+            std::atomic<std::uint64_t> generation_{0};
+            std::uint32_t next_thread_ = 0;
+
+            std::mutex flush_mutex_;
+            std::condition_variable flush_done_cv_;
+            std::atomic<std::uint64_t> flush_requested_{0};
+            std::uint64_t flush_seen_ = 0;
+            std::uint64_t flush_done_ = 0;
+
+            sink sink_;
+        };
+
+    }  // namespace detail
+
+    // Chaîne de format : un littéral, dont le nombre de {} doit correspondre aux arguments
+    template <typename... Args>
+    struct format_string {
+        const char* text;
+
+        template <std::size_t N>
+        consteval format_string(const char (&s)[N]) : text(s) {
+            if (detail::count_placeholders(s) != sizeof...(Args)) detail::placeholder_count_mismatch();
+        }
+    };
+
+    inline void start(config settings = {}) { detail::backend::instance().start(std::move(settings)); }
+    inline void stop() { detail::backend::instance().stop(); }
+    inline void flush() { detail::backend::instance().flush(); }
+
+    // Messages perdus depuis le démarrage (politique drop)
+    inline std::uint64_t dropped() { return detail::backend::instance().dropped(); }
+
+    // Démarre le journal et le vide à la fin de la portée (typiquement au début de main)
+    class session {
+    public:
+        explicit session(config settings = {}) { start(std::move(settings)); }
+        ~session() { stop(); }
+        session(const session&) = delete;
+        session& operator=(const session&) = delete;
+    };
+
+    template <detail::loggable... Args>
+    void log(level lvl, format_string<std::type_identity_t<Args>...> format, const Args&... args) {
+        detail::backend& backend = detail::backend::instance();
+        if (lvl < backend.min_level()) return;
+        const std::size_t payload = (std::size_t{0} + ... + detail::encoded_size(args));
+        detail::ring* const writer = backend.begin_write();
+        if (writer == nullptr) {
+            // Pas de session (pas encore, ou déjà arrêtée) : écriture synchrone, rien ne se perd
+            std::string& encoded = detail::direct_buffer();
+            encoded.resize(payload);
+            detail::encode_all(encoded.data(), args...);
+            backend.write_now(format.text, encoded.data(), payload);
+            return;
+        }
+        detail::ring& r = *writer;
+        const detail::write_scope scope{r};
+
+        const std::size_t size = (sizeof(detail::record_header) + payload + 7) & ~std::size_t{7};
+        if (size > r.capacity() / 2) {
+            r.count_drop();
+            return;
+        }
+        char* out = r.reserve(size);
+        while (out == nullptr) {
+            if (backend.policy() == overflow::drop || !backend.running()) {
+                r.count_drop();
+                return;
+            }
+            std::this_thread::yield();
+            out = r.reserve(size);
+        }
+        const detail::record_header header{static_cast<std::uint32_t>(size), lvl,
+                                           static_cast<std::uint8_t>(size - sizeof(detail::record_header) - payload), 0,
+                                           format.text, detail::now_ns()};
+        std::memcpy(out, &header, sizeof header);
+        detail::encode_all(out + sizeof header, args...);
+        r.commit(size);
+    }
+
+    template <detail::loggable... Args>
+    void debug(format_string<std::type_identity_t<Args>...> format, const Args&... args) { log(level::debug, format, args...); }
+
+    template <detail::loggable... Args>
+    void info(format_string<std::type_identity_t<Args>...> format, const Args&... args) { log(level::info, format, args...); }
+
+    template <detail::loggable... Args>
+    void warning(format_string<std::type_identity_t<Args>...> format, const Args&... args) { log(level::warning, format, args...); }
+
+    template <detail::loggable... Args>
+    void error(format_string<std::type_identity_t<Args>...> format, const Args&... args) { log(level::error, format, args...); }
+
+    // Relit un journal binaire et l'écrit en texte, préfixé de l'heure, du thread et du niveau ;
+    // false si le fichier est invalide ou tronqué (les messages précédents sont écrits)
+    inline bool decode(std::istream& in, std::ostream& out) {
+        char magic[sizeof detail::file_magic];
+        if (!in.read(magic, sizeof magic) || std::memcmp(magic, detail::file_magic, sizeof magic) != 0) return false;
+        std::vector<std::string> formats;
+        std::string payload;
+        std::string line;
+        const auto read = [&](auto& value) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof value)); };
+        for (char kind; in.get(kind);) {
+            line.clear();
+            if (kind == 'F') {
+                std::uint32_t id, length;
+                if (!read(id) || !read(length) || id != formats.size()) return false;
+                formats.emplace_back(length, '\0');
+                if (!in.read(formats.back().data(), length)) return false;
+            } else if (kind == 'M') {
+                std::uint32_t id, thread, size;
+                level lvl;
+                std::uint64_t timestamp;
+                if (!read(id) || !read(thread) || !read(lvl) || !read(timestamp) || !read(size) || id >= formats.size()) return false;
+                payload.resize(size);
+                if (!in.read(payload.data(), size)) return false;
+                detail::append_prefix(line, timestamp, thread, lvl);
+                if (!detail::format_payload(formats[id], payload.data(), size, line)) return false;
+                out << line << '\n';
+            } else if (kind == 'D') {
+                std::uint32_t thread;
+                std::uint64_t count;
+                if (!read(thread) || !read(count)) return false;
+                out << "[async_log] " << count << " messages perdus (anneau plein, thread " << thread << ")\n";
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}  // namespace async_log
+
+#endif //COMMON_ASYNC_LOG_H
@@ -0,0 +1,307 @@
+#ifndef COMMON_CORO_TRACE_H
+#define COMMON_CORO_TRACE_H
+
+#include <coroutine>
+#include <string>
+
+// Traces des coroutines : création, suspension, reprise et fin de chaque frame, horodatées au
+// compteur TSC dans un tampon par thread (sans verrou ni allocation après le premier bloc).
+// write_chrome_json() les met au format JSON de Chrome / Perfetto (chrome://tracing,
+// ui.perfetto.dev) : une tranche par période d'exécution, sur le thread qui l'a exécutée,
+// et une flèche de chaque suspension vers la reprise, d'un thread à l'autre.
+//
+// Activé par -DCORO_TRACE=1 (option CORO_TRACE de CMake : cibles cpp_20, download et
+// coroutine_generator). Sinon les crochets sont des fonctions vides et frame_slot un type
+// vide : il ne reste rien dans le code compilé.
+//
+// Crochets à placer :
+//   - constructeur du promise_type        created(frame_of(*this), "nom")
+//   - initial_suspend / yield_value       suspended(frame_of(*this)) si la coroutine se suspend
+//   - final_suspend                       completed(frame_of(*this))
+//   - côté appelant, avant handle.resume() resumed(handle.address())
+//   - awaitables : un membre [[no_unique_address]] frame_slot, suspend(handle) dans
+//     await_suspend et resume() dans await_resume
+#ifndef CORO_TRACE
+#define CORO_TRACE 0
+#endif
+
+#if CORO_TRACE
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace coro_trace {
+
+    inline constexpr bool enabled = CORO_TRACE != 0;
+
+    template <typename Promise>
+    const void* frame_of(Promise& promise) {
+        return std::coroutine_handle<Promise>::from_promise(promise).address();
+    }
+
+#if CORO_TRACE
+
+    namespace detail {
+
+        enum class event : std::uint8_t { create, suspend, resume, complete };
+
+        struct record {
+            std::uint64_t tsc;
+            const void* frame;
+            const char* name;       // create seulement
+            event kind;
+        };
+
+        // Blocs chaînés : le thread propriétaire ajoute, l'export lit ce qui est publié
+        struct chunk {
+            std::array<record, 4096> records;
+            std::atomic<std::size_t> count{0};
+            std::atomic<chunk*> next{nullptr};
+        };
+
+        struct buffer {
+            explicit buffer(std::uint32_t id) : thread(id) {}
+            ~buffer() {
+                for (chunk* c = first.next.load(); c != nullptr;) {
+                    chunk* next = c->next.load();
+                    delete c;
+                    c = next;
+                }
+            }
+
+            void append(const record& r) {
+                std::size_t n = last->count.load(std::memory_order_relaxed);
+                if (n == last->records.size()) {
+                    auto* fresh = new chunk;
+                    last->next.store(fresh, std::memory_order_release);
+                    last = fresh;
+                    n = 0;
+                }
+                last->records[n] = r;
+                last->count.store(n + 1, std::memory_order_release);
+            }
+
+            const std::uint32_t thread;
+            chunk first;
+            chunk* last = &first;
+        };
+
+        inline std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+        }
+
+        inline std::uint64_t steady_ns() {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // Tampons de tous les threads ; ils survivent aux threads (détachés) qui les ont remplis
+        struct registry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<buffer>> buffers;
+            // Point de référence TSC / horloge, pour convertir les ticks en nanosecondes
+            const std::uint64_t origin_ticks = ticks();
+            const std::uint64_t origin_ns = steady_ns();
+
+            static registry& instance() {
+                static registry r;
+                return r;
+            }
+        };
+
+        inline buffer& local() {
+            thread_local std::shared_ptr<buffer> mine = [] {
+                registry& r = registry::instance();
+                std::lock_guard lock(r.mutex);
+                auto b = std::make_shared<buffer>(static_cast<std::uint32_t>(r.buffers.size()));
+                r.buffers.push_back(b);
+                return b;
+            }();
+            return *mine;
+        }
+
+        inline void add(event kind, const void* frame, const char* name = nullptr) {
+            local().append({ticks(), frame, name, kind});
+        }
+
+        inline void append_escaped(std::string& out, const char* text) {
+            for (; *text; ++text) {
+                const char c = *text;
+                if (c == '"' || c == '\\') out += '\\';
+                if (static_cast<unsigned char>(c) < 0x20) continue;
+                out += c;
+            }
+        }
+
+    }  // namespace detail
+
+    inline void created(const void* frame, const char* name) { detail::add(detail::event::create, frame, name); }
+    inline void suspended(const void* frame) { detail::add(detail::event::suspend, frame); }
+    inline void resumed(const void* frame) { detail::add(detail::event::resume, frame); }
+    inline void completed(const void* frame) { detail::add(detail::event::complete, frame); }
+
+    // Frame suspendue par un awaitable, pour tracer sa reprise
+    class frame_slot {
+    public:
+        void suspend(std::coroutine_handle<> handle) {
+            frame_ = handle.address();
+            suspended(frame_);
+        }
+        void resume() const {
+            if (frame_) resumed(frame_);
+        }
+
+    private:
+        const void* frame_ = nullptr;
+    };
+
+    // Écrit les événements enregistrés jusqu'ici (à appeler quand les coroutines sont au repos)
+    inline bool write_chrome_json(const std::string& path) {
+        struct entry {
+            detail::record r;
+            std::uint32_t thread;
+        };
+        detail::registry& registry = detail::registry::instance();
+        std::vector<entry> entries;
+        std::vector<std::uint32_t> threads;
+        {
+            std::lock_guard lock(registry.mutex);
+            for (const auto& b : registry.buffers) {
+                threads.push_back(b->thread);
+                for (const detail::chunk* c = &b->first; c != nullptr; c = c->next.load(std::memory_order_acquire)) {
+                    const std::size_t n = c->count.load(std::memory_order_acquire);
+                    for (std::size_t i = 0; i < n; ++i) entries.push_back({c->records[i], b->thread});
+                }
+            }
+        }
+        std::stable_sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) { return a.r.tsc < b.r.tsc; });
+
+        // Ticks -> µs : étalonnage sur toute la durée écoulée (au moins 20 ms)
+        std::uint64_t now_ticks = detail::ticks(), now_ns = detail::steady_ns();
+        while (now_ns - registry.origin_ns < 20'000'000) {
+            std::this_thread::yield();
+            now_ticks = detail::ticks();
+            now_ns = detail::steady_ns();
+        }
+        const double us_per_tick = static_cast<double>(now_ns - registry.origin_ns) / 1000.0 /
+                                   static_cast<double>(std::max<std::uint64_t>(now_ticks - registry.origin_ticks, 1));
+        const auto us = [&](std::uint64_t t) {
+            return static_cast<double>(static_cast<std::int64_t>(t - registry.origin_ticks)) * us_per_tick;
+        };
+
+        std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        char line[512];
+        bool first = true;
+        const auto emit = [&](const char* text) {
+            if (!first) out += ",\n";
+            first = false;
+            out += text;
+        };
+        for (std::uint32_t t : threads) {
+            std::snprintf(line, sizeof line, R"({"ph":"M","pid":1,"tid":%u,"name":"thread_name","args":{"name":"thread %u"}})", t, t);
+            emit(line);
+        }
+
+        // État de chaque frame : période d'exécution en cours ou suspension en attente de reprise
+        struct frame_state {
+            std::string name = "coroutine";
+            std::uint64_t since = 0;
+            std::uint32_t thread = 0;
+            bool running = false;
+            bool suspended = false;
+        };
+        std::unordered_map<const void*, frame_state> frames;
+        std::uint64_t flow = 0;
+        const auto slice = [&](const frame_state& f, std::uint64_t end) {
+            out += first ? "" : ",\n";
+            first = false;
+            out += R"({"ph":"X","pid":1,"cat":"coroutine","name":")";
+            detail::append_escaped(out, f.name.c_str());
+            std::snprintf(line, sizeof line, R"(","tid":%u,"ts":%.3f,"dur":%.3f})", f.thread, us(f.since), us(end) - us(f.since));
+            out += line;
+        };
+        for (const entry& e : entries) {
+            frame_state& f = frames[e.r.frame];
+            switch (e.r.kind) {
+                case detail::event::create:
+                    f = frame_state{};
+                    if (e.r.name) f.name = e.r.name;
+                    f.since = e.r.tsc;
+                    f.thread = e.thread;
+                    f.running = true;
+                    break;
+                case detail::event::suspend:
+                    if (f.running) slice(f, e.r.tsc);
+                    f.running = false;
+                    f.suspended = true;
+                    f.since = e.r.tsc;
+                    f.thread = e.thread;
+                    break;
+                case detail::event::resume:
+                    if (f.suspended) {
+                        // Flèche : fin de la tranche suspendue -> début de la tranche reprise
+                        ++flow;
+                        std::snprintf(line, sizeof line,
+                                      R"({"ph":"s","pid":1,"cat":"coroutine","name":"reprise","id":%llu,"tid":%u,"ts":%.3f})",
+                                      static_cast<unsigned long long>(flow), f.thread, std::max(us(f.since) - 0.001, 0.0));
+                        emit(line);
+                        std::snprintf(line, sizeof line,
+                                      R"({"ph":"f","bp":"e","pid":1,"cat":"coroutine","name":"reprise","id":%llu,"tid":%u,"ts":%.3f})",
+                                      static_cast<unsigned long long>(flow), e.thread, us(e.r.tsc));
+                        emit(line);
+                    }
+                    f.suspended = false;
+                    f.running = true;
+                    f.since = e.r.tsc;
+                    f.thread = e.thread;
+                    break;
+                case detail::event::complete:
+                    if (f.running) slice(f, e.r.tsc);
+                    frames.erase(e.r.frame);
+                    break;
+            }
+        }
+        out += "\n]}\n";
+
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        const bool written = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+        return std::fclose(file) == 0 && written;
+    }
+
+#else
+
+    inline void created(const void*, const char*) {}
+    inline void suspended(const void*) {}
+    inline void resumed(const void*) {}
+    inline void completed(const void*) {}
+
+    class frame_slot {
+    public:
+        void suspend(std::coroutine_handle<>) {}
+        void resume() const {}
+    };
+
+    inline bool write_chrome_json(const std::string&) { return false; }
+
+#endif
+
+}  // namespace coro_trace
+
+#endif //COMMON_CORO_TRACE_H
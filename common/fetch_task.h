@@ -0,0 +1,110 @@
+#ifndef COMMON_FETCH_TASK_H
+#define COMMON_FETCH_TASK_H
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include "async_log.h"
+#include "coro_trace.h"
+#include "runtime_metrics.h"
+
+// Coroutine fetch_data de l'atelier 3 (cpp_20/solution_workshop_3_s_3.cpp) : la requête est
+// journalisée, la coroutine attend un délai simulé sur un thread à part, puis rend
+// "Données reçues pour : " + requête. AsyncTask garde la poignée dans un shared_ptr.
+// Partagée avec cpp_23/bench_alloc, qui compte les allocations de ce chemin tel quel.
+//
+// Volontairement en C++20 : utilisé par les exemples de cpp_20.
+namespace fetch_task {
+
+    // Coroutines créées / terminées, durée des suspensions et durée de vie, exportées à la fin
+    inline runtime_metrics::coroutine_metrics metrics("fetch_data");
+
+    // Awaitable personnalisé pour simuler une attente asynchrone
+    struct Awaitable {
+        std::chrono::nanoseconds delay;
+        std::uint64_t suspended_at = 0;
+        [[no_unique_address]] coro_trace::frame_slot trace;
+
+        explicit Awaitable(std::chrono::nanoseconds d) : delay(d) {}
+
+        bool await_ready() const noexcept { return false; }  // La coroutine n'est pas prête immédiatement
+        void await_suspend(std::coroutine_handle<> handle) {
+            suspended_at = runtime_metrics::now_ns();
+            trace.suspend(handle);
+            std::thread([handle, delay = delay]() {
+                std::this_thread::sleep_for(delay);  // Délai simulé
+                handle.resume();  // Reprend la coroutine après l'attente
+            }).detach();
+        }
+        void await_resume() const noexcept {
+            trace.resume();
+            metrics.on_resume(runtime_metrics::now_ns() - suspended_at);
+        }
+    };
+
+    // Classe de gestion de coroutine avec un `promise_type`
+    struct AsyncTask {
+        struct promise_type;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        std::shared_ptr<handle_type> coro;  // Utilisation de shared_ptr pour une gestion de mémoire sécurisée
+        std::shared_ptr<std::atomic<bool>> finished;  // Levé quand la coroutine est suspendue à la fin
+
+        AsyncTask(handle_type h) : coro(std::make_shared<handle_type>(h)), finished(h.promise().finished) {}
+        ~AsyncTask() { if (coro && coro.use_count() == 1 && finished->load(std::memory_order_acquire)) coro->destroy(); }
+
+        // Attend la fin de la coroutine, reprise sur un autre thread, puis rend son résultat
+        std::string get() {
+            finished->wait(false, std::memory_order_acquire);
+            return coro->promise().result;
+        }
+
+        struct promise_type {
+            std::string result;
+            std::uint64_t created_at = runtime_metrics::now_ns();
+            std::shared_ptr<std::atomic<bool>> finished = std::make_shared<std::atomic<bool>>(false);
+
+            // Lève `finished` une fois la coroutine suspendue : la frame peut alors être lue et détruite
+            struct final_awaiter {
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(handle_type h) const noexcept {
+                    const auto flag = h.promise().finished;  // Copie : la frame peut disparaître dès le store
+                    flag->store(true, std::memory_order_release);
+                    flag->notify_all();
+                }
+                void await_resume() const noexcept {}
+            };
+
+            promise_type() {
+                metrics.on_start();
+                coro_trace::created(coro_trace::frame_of(*this), "fetch_data");
+            }
+
+            auto get_return_object() { return AsyncTask{handle_type::from_promise(*this)}; }
+            auto initial_suspend() { return std::suspend_never{}; }  // Ne suspend pas immédiatement
+            auto final_suspend() noexcept {  // Suspend après le retour
+                metrics.on_complete(runtime_metrics::now_ns() - created_at);
+                coro_trace::completed(coro_trace::frame_of(*this));
+                return final_awaiter{};
+            }
+
+            void return_value(std::string value) { result = std::move(value); }
+            void unhandled_exception() { std::exit(1); }
+        };
+    };
+
+    // Coroutine pour simuler la récupération de données de manière asynchrone
+    inline AsyncTask fetch_data(const std::string& request, std::chrono::nanoseconds delay = std::chrono::seconds(2)) {
+        async_log::info("Traitement de la requête : {}", request);
+        co_await Awaitable(delay);  // Simule une attente non bloquante
+        co_return "Données reçues pour : " + request;  // Retourne le résultat
+    }
+
+}  // namespace fetch_task
+
+#endif //COMMON_FETCH_TASK_H
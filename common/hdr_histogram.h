@@ -0,0 +1,118 @@
+#ifndef COMMON_HDR_HISTOGRAM_H
+#define COMMON_HDR_HISTOGRAM_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Histogramme à plage dynamique (style HdrHistogram) : les valeurs sont rangées
+// dans des sous-buckets linéaires à l'intérieur de buckets en puissance de deux,
+// ce qui garde une précision relative constante (2^-(sub_bucket_bits-1)) sur toute la plage.
+class hdr_histogram {
+public:
+    // 11 bits de sous-buckets : ~0.1% de précision ; 44 bits de plage : ~4.8 h en nanosecondes
+    explicit hdr_histogram(int sub_bucket_bits = 11, int max_value_bits = 44)
+            : sub_bucket_bits_(sub_bucket_bits),
+              half_count_(std::uint64_t{1} << (sub_bucket_bits - 1)),
+              max_value_(max_value_bits >= 64 ? std::numeric_limits<std::uint64_t>::max()
+                                              : (std::uint64_t{1} << max_value_bits) - 1),
+              counts_((std::size_t{1} << sub_bucket_bits) + (max_value_bits - sub_bucket_bits) * half_count_, 0) {}
+
+    void record(std::uint64_t value, std::uint64_t count = 1) {
+        value = std::min(value, max_value_);
+        counts_[index_of(value)] += count;
+        total_ += count;
+        sum_ += static_cast<double>(value) * static_cast<double>(count);
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const hdr_histogram& other) {
+        const std::size_t n = std::min(counts_.size(), other.counts_.size());
+        for (std::size_t i = 0; i < n; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    void reset() {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        sum_ = 0;
+        min_ = std::numeric_limits<std::uint64_t>::max();
+        max_ = 0;
+    }
+
+    std::uint64_t count() const { return total_; }
+    std::uint64_t min() const { return total_ ? min_ : 0; }
+    std::uint64_t max() const { return max_; }
+    double mean() const { return total_ ? sum_ / static_cast<double>(total_) : 0.0; }
+
+    // Plus grande valeur équivalente au percentile demandé (0..100)
+    std::uint64_t value_at_percentile(double percentile) const {
+        if (total_ == 0) {
+            return 0;
+        }
+        percentile = std::clamp(percentile, 0.0, 100.0);
+        auto target = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(total_) + 0.5);
+        target = std::max<std::uint64_t>(target, 1);
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return std::min(highest_equivalent(i), max_);
+            }
+        }
+        return max_;
+    }
+
+private:
+    // Valeurs < 2^bits : un compteur par valeur. Au-delà, décalage m = largeur - bits
+    // et on garde les `bits` bits de poids fort.
+    std::size_t index_of(std::uint64_t value) const {
+        const int width = std::bit_width(value);
+        if (width <= sub_bucket_bits_) {
+            return static_cast<std::size_t>(value);
+        }
+        const int shift = width - sub_bucket_bits_;
+        const std::uint64_t top = value >> shift;
+        return (std::size_t{1} << sub_bucket_bits_) + (shift - 1) * half_count_ + (top - half_count_);
+    }
+
+    std::uint64_t lowest_equivalent(std::size_t index) const {
+        const std::size_t linear = std::size_t{1} << sub_bucket_bits_;
+        if (index < linear) {
+            return index;
+        }
+        const std::size_t shift = (index - linear) / half_count_ + 1;
+        const std::uint64_t top = (index - linear) % half_count_ + half_count_;
+        return top << shift;
+    }
+
+    std::uint64_t highest_equivalent(std::size_t index) const {
+        const std::size_t linear = std::size_t{1} << sub_bucket_bits_;
+        if (index < linear) {
+            return index;
+        }
+        const std::size_t shift = (index - linear) / half_count_ + 1;
+        return lowest_equivalent(index) + (std::uint64_t{1} << shift) - 1;
+    }
+
+    int sub_bucket_bits_;
+    std::uint64_t half_count_;
+    std::uint64_t max_value_;
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t total_ = 0;
+    double sum_ = 0;
+    std::uint64_t min_ = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_ = 0;
+};
+
+#endif //COMMON_HDR_HISTOGRAM_H
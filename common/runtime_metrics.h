@@ -0,0 +1,502 @@
+#ifndef COMMON_RUNTIME_METRICS_H
+#define COMMON_RUNTIME_METRICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "hdr_histogram.h"
+
+// Métriques d'exécution du pool de threads et des coroutines, à faible coût :
+//
+//   - chaque worker (ou chaque thread, pour les coroutines) écrit dans son propre emplacement,
+//     aligné sur une ligne de cache : quelques compteurs et deux histogrammes HDR, sous un petit
+//     verrou que seul un instantané vient disputer ;
+//   - snapshot() additionne les emplacements un par un, sans arrêter les workers ;
+//   - to_prometheus() met un instantané au format texte de Prometheus ; exporter l'écrit
+//     périodiquement dans un fichier et/ou le sert en HTTP sur 127.0.0.1.
+//
+// Durées en nanosecondes (horloge monotone), exportées en secondes. En C++20 : les
+// coroutines de cpp_20 l'utilisent aussi.
+namespace runtime_metrics {
+
+    inline std::uint64_t now_ns() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // ~0,8 % de précision jusqu'à ~18 min, 35 Kio par histogramme
+    inline hdr_histogram make_histogram() { return hdr_histogram(8, 40); }
+
+    namespace detail {
+
+        class spin_lock {
+        public:
+            void lock() {
+                while (flag_.test_and_set(std::memory_order_acquire)) {
+                    while (flag_.test(std::memory_order_relaxed)) std::this_thread::yield();
+                }
+            }
+            void unlock() { flag_.clear(std::memory_order_release); }
+
+        private:
+            std::atomic_flag flag_;
+        };
+
+        // Numéro du thread courant, attribué à son premier passage
+        inline std::size_t thread_index() {
+            static std::atomic<std::size_t> next{0};
+            thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+
+        inline void append_number(std::string& out, double value) {
+            char digits[32];
+            const auto result = std::to_chars(digits, digits + sizeof digits, value);
+            out.append(digits, result.ptr);
+        }
+
+        inline void append_number(std::string& out, std::uint64_t value) {
+            char digits[24];
+            const auto result = std::to_chars(digits, digits + sizeof digits, value);
+            out.append(digits, result.ptr);
+        }
+
+        // name="valeur" avec \, " et retour à la ligne échappés
+        inline std::string label(std::string_view name, std::string_view value) {
+            std::string out(name);
+            out += "=\"";
+            for (char c : value) {
+                if (c == '\\' || c == '"') out += '\\';
+                if (c == '\n') {
+                    out += "\\n";
+                    continue;
+                }
+                out += c;
+            }
+            out += '"';
+            return out;
+        }
+
+        inline void append_family(std::string& out, std::string_view name, std::string_view type, std::string_view help) {
+            out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+            out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+        }
+
+        template <typename V>
+        void append_sample(std::string& out, std::string_view name, std::string_view labels, V value) {
+            out.append(name).append("{").append(labels).append("} ");
+            append_number(out, value);
+            out += '\n';
+        }
+
+        // Résumé Prometheus : quantiles, somme et nombre, en secondes
+        inline void append_summary(std::string& out, std::string_view name, std::string_view help,
+                                   std::string_view labels, const hdr_histogram& h) {
+            append_family(out, name, "summary", help);
+            for (const auto& [quantile, text] : {std::pair{50.0, "0.5"}, {90.0, "0.9"}, {99.0, "0.99"}, {99.9, "0.999"}}) {
+                out.append(name).append("{").append(labels).append(",quantile=\"").append(text).append("\"} ");
+                append_number(out, static_cast<double>(h.value_at_percentile(quantile)) / 1e9);
+                out += '\n';
+            }
+            const std::string base(name);
+            append_sample(out, base + "_sum", labels, h.mean() * static_cast<double>(h.count()) / 1e9);
+            append_sample(out, base + "_count", labels, h.count());
+        }
+
+    }  // namespace detail
+
+    // --- Pool de threads ---
+
+    struct pool_snapshot {
+        struct worker {
+            std::uint64_t tasks = 0;
+            std::uint64_t busy_ns = 0;      // temps hors attente d'une tâche
+            std::uint64_t idle_ns = 0;      // attente d'une tâche (file vide)
+        };
+
+        std::string pool;
+        std::uint32_t sample_every = 1;
+        std::uint64_t submitted = 0;
+        std::uint64_t queue_depth = 0;
+        std::uint64_t max_queue_depth = 0;
+        std::vector<worker> workers;
+        hdr_histogram queue_wait = make_histogram();    // de execute() au début de la tâche (échantillon)
+        hdr_histogram run_time = make_histogram();      // exécution (échantillon)
+
+        // Part du temps des workers hors attente d'une tâche
+        double utilization() const {
+            std::uint64_t busy = 0, total = 0;
+            for (const worker& w : workers) {
+                busy += w.busy_ns;
+                total += w.busy_ns + w.idle_ns;
+            }
+            return total ? static_cast<double>(busy) / static_cast<double>(total) : 0.0;
+        }
+    };
+
+    // Lire l'horloge coûte autant qu'une petite tâche : seule une tâche sur `sample_every` est
+    // chronométrée (attente en file et exécution, dans les histogrammes). Les compteurs voient
+    // toutes les tâches, et l'occupation se déduit du temps d'attente, mesuré seulement quand un
+    // worker trouve la file vide.
+    class pool_metrics {
+    public:
+        pool_metrics(std::string name, std::size_t workers, std::uint32_t sample_every = 64)
+                : name_(std::move(name)), sample_every_(std::max<std::uint32_t>(sample_every, 1)), workers_(workers),
+                  slots_(std::make_unique<slot[]>(workers)), started_ns_(now_ns()) {}
+
+        // Sous le verrou de la file, profondeur après l'ajout : rend l'heure d'entrée en file si
+        // la tâche est chronométrée, 0 sinon
+        std::uint64_t on_submit(std::size_t depth) {
+            const std::uint64_t submitted = submitted_.load(std::memory_order_relaxed) + 1;
+            submitted_.store(submitted, std::memory_order_relaxed);
+            on_depth(depth);
+            if (depth > max_depth_.load(std::memory_order_relaxed)) max_depth_.store(depth, std::memory_order_relaxed);
+            return submitted % sample_every_ == 0 ? now_ns() : 0;
+        }
+
+        void on_depth(std::size_t depth) { depth_.store(depth, std::memory_order_relaxed); }
+
+        // Le worker trouve la file vide et va attendre / vient d'être réveillé
+        void on_idle_begin(std::size_t worker) { slots_[worker].idle_since.store(now_ns(), std::memory_order_relaxed); }
+
+        void on_idle_end(std::size_t worker) {
+            slot& s = slots_[worker];
+            const std::uint64_t since = s.idle_since.load(std::memory_order_relaxed);
+            s.idle_ns.store(s.idle_ns.load(std::memory_order_relaxed) + (now_ns() - since), std::memory_order_relaxed);
+            s.idle_since.store(0, std::memory_order_relaxed);
+        }
+
+        void on_task(std::size_t worker) {
+            slot& s = slots_[worker];
+            s.tasks.store(s.tasks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        // Tâche chronométrée : attente en file et exécution
+        void on_sample(std::size_t worker, std::uint64_t wait_ns, std::uint64_t run_ns) {
+            slot& s = slots_[worker];
+            s.lock.lock();
+            s.queue_wait.record(wait_ns);
+            s.run_time.record(run_ns);
+            s.lock.unlock();
+        }
+
+        // Le worker s'arrête : son temps ne court plus
+        void on_exit(std::size_t worker) { slots_[worker].exited.store(now_ns(), std::memory_order_relaxed); }
+
+        pool_snapshot snapshot() const {
+            pool_snapshot result;
+            result.pool = name_;
+            result.sample_every = sample_every_;
+            result.submitted = submitted_.load(std::memory_order_relaxed);
+            result.queue_depth = depth_.load(std::memory_order_relaxed);
+            result.max_queue_depth = max_depth_.load(std::memory_order_relaxed);
+            result.workers.resize(workers_);
+            const std::uint64_t now = now_ns();
+            for (std::size_t i = 0; i < workers_; ++i) {
+                const slot& s = slots_[i];
+                const std::uint64_t exited = s.exited.load(std::memory_order_relaxed);
+                const std::uint64_t end = exited ? exited : now;
+                const std::uint64_t since = s.idle_since.load(std::memory_order_relaxed);
+                std::uint64_t idle = s.idle_ns.load(std::memory_order_relaxed) + (since && since < end ? end - since : 0);
+                const std::uint64_t elapsed = end > started_ns_ ? end - started_ns_ : 0;
+                idle = std::min(idle, elapsed);
+                result.workers[i] = {s.tasks.load(std::memory_order_relaxed), elapsed - idle, idle};
+                s.lock.lock();
+                result.queue_wait.merge(s.queue_wait);
+                result.run_time.merge(s.run_time);
+                s.lock.unlock();
+            }
+            return result;
+        }
+
+        const std::string& name() const { return name_; }
+
+    private:
+        // Compteurs écrits par un seul worker (load + store, sans instruction atomique lourde)
+        struct alignas(64) slot {
+            std::atomic<std::uint64_t> tasks{0};
+            std::atomic<std::uint64_t> idle_ns{0};
+            std::atomic<std::uint64_t> idle_since{0};
+            std::atomic<std::uint64_t> exited{0};
+            mutable detail::spin_lock lock;
+            hdr_histogram queue_wait = make_histogram();
+            hdr_histogram run_time = make_histogram();
+        };
+
+        std::string name_;
+        std::uint32_t sample_every_;
+        std::size_t workers_;
+        std::unique_ptr<slot[]> slots_;
+        std::uint64_t started_ns_;
+        alignas(64) std::atomic<std::uint64_t> submitted_{0};
+        std::atomic<std::uint64_t> depth_{0};
+        std::atomic<std::uint64_t> max_depth_{0};
+    };
+
+    inline std::string to_prometheus(const pool_snapshot& s) {
+        std::string out;
+        const std::string pool = detail::label("pool", s.pool);
+        detail::append_family(out, "pool_tasks_submitted_total", "counter", "Tâches mises en file");
+        detail::append_sample(out, "pool_tasks_submitted_total", pool, s.submitted);
+        detail::append_family(out, "pool_queue_depth", "gauge", "Tâches en attente dans la file");
+        detail::append_sample(out, "pool_queue_depth", pool, s.queue_depth);
+        detail::append_family(out, "pool_queue_depth_max", "gauge", "Profondeur maximale de la file");
+        detail::append_sample(out, "pool_queue_depth_max", pool, s.max_queue_depth);
+        detail::append_family(out, "pool_utilization_ratio", "gauge", "Part du temps des workers hors attente d'une tâche");
+        detail::append_sample(out, "pool_utilization_ratio", pool, s.utilization());
+
+        detail::append_family(out, "pool_worker_tasks_total", "counter", "Tâches exécutées par worker");
+        for (std::size_t i = 0; i < s.workers.size(); ++i) {
+            detail::append_sample(out, "pool_worker_tasks_total", pool + "," + detail::label("worker", std::to_string(i)), s.workers[i].tasks);
+        }
+        detail::append_family(out, "pool_worker_busy_seconds_total", "counter", "Temps hors attente d'une tâche par worker");
+        for (std::size_t i = 0; i < s.workers.size(); ++i) {
+            detail::append_sample(out, "pool_worker_busy_seconds_total", pool + "," + detail::label("worker", std::to_string(i)),
+                                  static_cast<double>(s.workers[i].busy_ns) / 1e9);
+        }
+        detail::append_family(out, "pool_worker_idle_seconds_total", "counter", "Temps d'attente d'une tâche par worker");
+        for (std::size_t i = 0; i < s.workers.size(); ++i) {
+            detail::append_sample(out, "pool_worker_idle_seconds_total", pool + "," + detail::label("worker", std::to_string(i)),
+                                  static_cast<double>(s.workers[i].idle_ns) / 1e9);
+        }
+        const std::string sampled = " (une tâche sur " + std::to_string(s.sample_every) + ")";
+        detail::append_summary(out, "pool_queue_wait_seconds", "Attente en file avant exécution" + sampled, pool, s.queue_wait);
+        detail::append_summary(out, "pool_task_run_seconds", "Durée d'exécution des tâches" + sampled, pool, s.run_time);
+        return out;
+    }
+
+    // --- Coroutines ---
+
+    struct coroutine_snapshot {
+        struct counters {
+            std::uint64_t started = 0;
+            std::uint64_t completed = 0;
+            std::uint64_t suspensions = 0;
+        };
+
+        std::string name;
+        counters totals;
+        hdr_histogram suspended = make_histogram();     // d'une suspension à la reprise
+        hdr_histogram lifetime = make_histogram();      // de la création à la fin
+
+        std::uint64_t in_flight() const { return totals.started - totals.completed; }
+    };
+
+    // Les coroutines reprennent sur n'importe quel thread : un emplacement par thread, modulo `slots`
+    class coroutine_metrics {
+    public:
+        explicit coroutine_metrics(std::string name, std::size_t slots = 16)
+                : name_(std::move(name)), count_(std::max<std::size_t>(slots, 1)), slots_(std::make_unique<slot[]>(count_)) {}
+
+        // Dans le constructeur du promise_type
+        void on_start() {
+            slot& s = local();
+            s.lock.lock();
+            ++s.counters.started;
+            s.lock.unlock();
+        }
+
+        // Dans await_resume : durée de la suspension
+        void on_resume(std::uint64_t suspended_ns) {
+            slot& s = local();
+            s.lock.lock();
+            ++s.counters.suspensions;
+            s.suspended.record(suspended_ns);
+            s.lock.unlock();
+        }
+
+        // Dans final_suspend : durée de vie de la coroutine
+        void on_complete(std::uint64_t lifetime_ns) {
+            slot& s = local();
+            s.lock.lock();
+            ++s.counters.completed;
+            s.lifetime.record(lifetime_ns);
+            s.lock.unlock();
+        }
+
+        coroutine_snapshot snapshot() const {
+            coroutine_snapshot result;
+            result.name = name_;
+            for (std::size_t i = 0; i < count_; ++i) {
+                const slot& s = slots_[i];
+                s.lock.lock();
+                result.totals.started += s.counters.started;
+                result.totals.completed += s.counters.completed;
+                result.totals.suspensions += s.counters.suspensions;
+                result.suspended.merge(s.suspended);
+                result.lifetime.merge(s.lifetime);
+                s.lock.unlock();
+            }
+            return result;
+        }
+
+    private:
+        // Partagé par les threads de même numéro modulo count_ : tout sous le verrou
+        struct alignas(64) slot {
+            mutable detail::spin_lock lock;
+            coroutine_snapshot::counters counters;
+            hdr_histogram suspended = make_histogram();
+            hdr_histogram lifetime = make_histogram();
+        };
+
+        slot& local() { return slots_[detail::thread_index() % count_]; }
+
+        std::string name_;
+        std::size_t count_;
+        std::unique_ptr<slot[]> slots_;
+    };
+
+    inline std::string to_prometheus(const coroutine_snapshot& s) {
+        std::string out;
+        const std::string name = detail::label("coroutine", s.name);
+        detail::append_family(out, "coroutine_started_total", "counter", "Coroutines créées");
+        detail::append_sample(out, "coroutine_started_total", name, s.totals.started);
+        detail::append_family(out, "coroutine_completed_total", "counter", "Coroutines terminées");
+        detail::append_sample(out, "coroutine_completed_total", name, s.totals.completed);
+        detail::append_family(out, "coroutine_in_flight", "gauge", "Coroutines créées et pas encore terminées");
+        detail::append_sample(out, "coroutine_in_flight", name, s.in_flight());
+        detail::append_family(out, "coroutine_suspensions_total", "counter", "Reprises après suspension");
+        detail::append_sample(out, "coroutine_suspensions_total", name, s.totals.suspensions);
+        detail::append_summary(out, "coroutine_suspended_seconds", "Durée des suspensions", name, s.suspended);
+        detail::append_summary(out, "coroutine_lifetime_seconds", "Durée de vie des coroutines", name, s.lifetime);
+        return out;
+    }
+
+    // --- Export ---
+
+    // Écrit dans un fichier temporaire puis le renomme : un lecteur ne voit jamais de fichier partiel
+    inline bool write_file(const std::string& path, std::string_view text) {
+        const std::string temporary = path + ".tmp";
+        std::FILE* file = std::fopen(temporary.c_str(), "wb");
+        if (!file) return false;
+        const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+        if (std::fclose(file) != 0 || !written) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return std::rename(temporary.c_str(), path.c_str()) == 0;
+    }
+
+    struct export_options {
+        std::string path;                                   // vide : pas de fichier
+        std::uint16_t port = 0;                             // 0 : pas de HTTP ; sinon 127.0.0.1:port
+        std::chrono::milliseconds interval{1000};           // réécriture du fichier
+    };
+
+    // Thread d'export : instantanés pris à chaque écriture du fichier et à chaque requête HTTP
+    // (réponse à toute requête, quel que soit le chemin)
+    class exporter {
+    public:
+        using source = std::function<std::string()>;
+
+        exporter(std::vector<source> sources, export_options options)
+                : sources_(std::move(sources)), options_(std::move(options)) {
+            if (options_.port != 0) listen();
+            thread_ = std::jthread([this](std::stop_token stop) { run(stop); });
+        }
+
+        ~exporter() {
+            thread_.request_stop();
+            if (thread_.joinable()) thread_.join();
+            if (listener_ >= 0) ::close(listener_);
+            if (!options_.path.empty()) write_file(options_.path, render());
+        }
+
+        exporter(const exporter&) = delete;
+        exporter& operator=(const exporter&) = delete;
+
+        // Faux si le port demandé n'a pas pu être ouvert
+        bool listening() const { return listener_ >= 0; }
+
+        std::string render() const {
+            std::string text;
+            for (const source& s : sources_) text += s();
+            return text;
+        }
+
+    private:
+        void listen() {
+            listener_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (listener_ < 0) return;
+            const int yes = 1;
+            ::setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof yes);
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(options_.port);
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (::bind(listener_, reinterpret_cast<const sockaddr*>(&address), sizeof address) != 0 ||
+                ::listen(listener_, 16) != 0) {
+                ::close(listener_);
+                listener_ = -1;
+            }
+        }
+
+        void run(std::stop_token stop) {
+            auto next_write = std::chrono::steady_clock::now();
+            while (!stop.stop_requested()) {
+                const auto now = std::chrono::steady_clock::now();
+                if (!options_.path.empty() && now >= next_write) {
+                    write_file(options_.path, render());
+                    next_write = now + options_.interval;
+                }
+                // Réveil au moins toutes les 100 ms pour voir la demande d'arrêt
+                pollfd fd{listener_, POLLIN, 0};
+                const int timeout = 100;
+                if (listener_ < 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+                } else if (::poll(&fd, 1, timeout) > 0) {
+                    serve();
+                }
+            }
+        }
+
+        void serve() {
+            const int client = ::accept4(listener_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0) return;
+            // Lit la requête (sans l'interpréter) pour que le client ne reçoive pas de RST
+            pollfd fd{client, POLLIN, 0};
+            char request[4096];
+            if (::poll(&fd, 1, 1000) > 0) {
+                [[maybe_unused]] const ssize_t ignored = ::recv(client, request, sizeof request, 0);
+            }
+            const std::string body = render();
+            std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: ";
+            response += std::to_string(body.size());
+            response += "\r\nConnection: close\r\n\r\n";
+            response += body;
+            std::size_t sent = 0;
+            while (sent < response.size()) {
+                const ssize_t n = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break;
+                sent += static_cast<std::size_t>(n);
+            }
+            ::close(client);
+        }
+
+        std::vector<source> sources_;
+        export_options options_;
+        int listener_ = -1;
+        std::jthread thread_;
+    };
+
+}  // namespace runtime_metrics
+
+#endif //COMMON_RUNTIME_METRICS_H
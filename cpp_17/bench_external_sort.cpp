@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "external_sort.h"
+
+// Tri externe d'un fichier de doubles aléatoires : taille de l'entrée et budget mémoire en Mio,
+// répertoire des fichiers (4096 Mio, 400 Mio et "." par défaut). Pour dépasser la mémoire :
+// bench_external_sort 40960 4096 /chemin/vers/disque/local
+// Le fichier trié est relu et vérifié (ordre et nombre de valeurs), puis les fichiers sont supprimés.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    double seconds_since(clock_type::time_point start) {
+        return std::chrono::duration<double>(clock_type::now() - start).count();
+    }
+
+    void row(const char* name, double seconds, double mib) {
+        std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << seconds << std::setprecision(0) << std::setw(12) << mib / seconds << '\n';
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::uint64_t input_mib = argc > 1 ? std::stoull(argv[1]) : 4096;
+    const std::uint64_t budget_mib = argc > 2 ? std::stoull(argv[2]) : 400;
+    const std::string dir = argc > 3 ? argv[3] : ".";
+    const std::string input = dir + "/external_sort.in", output = dir + "/external_sort.out";
+    const std::uint64_t total = (input_mib << 20) / sizeof(double);
+
+    std::cout << "entrée " << input_mib << " Mio, budget " << budget_mib << " Mio, "
+              << std::max(1u, std::thread::hardware_concurrency()) << " coeurs\n"
+              << std::left << std::setw(24) << "phase" << std::right << std::setw(12) << "secondes"
+              << std::setw(12) << "Mio/s" << '\n';
+
+    // Entrée : blocs de 8 Mio de doubles uniformes
+    auto start = clock_type::now();
+    {
+        std::FILE* file = std::fopen(input.c_str(), "wb");
+        if (!file) {
+            std::perror(input.c_str());
+            return 1;
+        }
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> dist(-1e9, 1e9);
+        std::vector<double> block(std::size_t{1} << 20);
+        for (std::uint64_t written = 0; written < total; written += block.size()) {
+            const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(block.size(), total - written));
+            for (std::size_t i = 0; i < n; ++i) block[i] = dist(rng);
+            std::fwrite(block.data(), sizeof(double), n, file);
+        }
+        std::fclose(file);
+    }
+    row("génération", seconds_since(start), static_cast<double>(input_mib));
+
+    external_sort::options opts;
+    opts.memory_budget = budget_mib << 20;
+    opts.temp_dir = dir;
+    start = clock_type::now();
+    const external_sort::stats stats = external_sort::sort_file(input, output, opts);
+    const double total_seconds = seconds_since(start);
+    row("runs", stats.run_seconds, static_cast<double>(input_mib));
+    row("fusion", stats.merge_seconds, static_cast<double>(input_mib) * static_cast<double>(stats.merge_passes));
+    row("tri externe", total_seconds, static_cast<double>(input_mib));
+    std::cout << stats.runs << " runs, " << stats.merge_passes << " passe(s) de fusion\n";
+
+    // Vérification
+    start = clock_type::now();
+    bool sorted = true;
+    std::uint64_t count = 0;
+    {
+        std::FILE* file = std::fopen(output.c_str(), "rb");
+        std::vector<double> block(std::size_t{1} << 20);
+        double previous = -1e300;
+        std::size_t n = 0;
+        while (file && (n = std::fread(block.data(), sizeof(double), block.size(), file)) > 0) {
+            sorted = sorted && block[0] >= previous && std::is_sorted(block.begin(), block.begin() + static_cast<std::ptrdiff_t>(n));
+            previous = block[n - 1];
+            count += n;
+        }
+        if (file) std::fclose(file);
+    }
+    row("vérification", seconds_since(start), static_cast<double>(input_mib));
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+
+    if (!sorted || count != total) {
+        std::cerr << "sortie incorrecte : " << count << " valeurs sur " << total << (sorted ? "" : ", désordre") << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "fs_walk.h"
+
+// Parcours d'une arborescence (/usr par défaut, chemin en argument) avec taille de chaque
+// fichier : recursive_directory_iterator, puis fs_walk sur 1 worker et sur un par coeur,
+// puis deux parcours avec index (le premier l'écrit, le second ne relit que les dossiers
+// modifiés). Les comptes de fichiers et d'octets doivent être les mêmes partout.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    struct totals {
+        std::uint64_t files = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    void row(const char* name, double seconds, const totals& t, std::uint64_t entries) {
+        std::cout << std::left << std::setw(30) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << seconds << std::setprecision(0) << std::setw(14)
+                  << static_cast<double>(entries) / seconds << std::setw(12) << t.files << std::setw(16) << t.bytes << '\n';
+    }
+
+    totals run_walk(const std::string& root, unsigned workers, const std::string& index, fs_walk::stats& stats) {
+        std::vector<totals> parts(workers);
+        fs_walk::options opts;
+        opts.workers = workers;
+        opts.stat = true;
+        opts.index_path = index;
+        stats = fs_walk::walk(root, [&](unsigned w) {
+            return [&part = parts[w]](const fs_walk::entry& e) {
+                if (e.type == fs_walk::file_type::regular) {
+                    ++part.files;
+                    part.bytes += e.meta.size;
+                }
+            };
+        }, opts);
+        totals all;
+        for (const totals& p : parts) {
+            all.files += p.files;
+            all.bytes += p.bytes;
+        }
+        return all;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::string root = argc > 1 ? argv[1] : "/usr";
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const std::string index = (std::filesystem::temp_directory_path() / "bench_fs_walk.index").string();
+    std::remove(index.c_str());
+
+    std::cout << root << ", " << cores << " coeurs\n"
+              << std::left << std::setw(30) << "parcours" << std::right << std::setw(10) << "secondes"
+              << std::setw(14) << "entrées/s" << std::setw(12) << "fichiers" << std::setw(16) << "octets" << '\n';
+
+    {
+        namespace fs = std::filesystem;
+        totals t;
+        std::uint64_t entries = 0;
+        std::error_code ec;
+        const auto start = clock_type::now();
+        for (fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+             it != end; it.increment(ec)) {
+            ++entries;
+            if (it->is_symlink(ec) || !it->is_regular_file(ec)) continue;
+            ++t.files;
+            t.bytes += it->file_size(ec);
+        }
+        row("recursive_directory_iterator", std::chrono::duration<double>(clock_type::now() - start).count(), t, entries);
+    }
+
+    fs_walk::stats stats;
+    for (unsigned workers : {1u, cores}) {
+        const totals t = run_walk(root, workers, "", stats);
+        const std::string name = "fs_walk, " + std::to_string(workers) + " worker(s)";
+        row(name.c_str(), stats.seconds, t, stats.entries);
+        if (workers == cores) std::cout << "  " << stats.directories << " dossiers, " << stats.steals << " vols\n";
+        if (cores == 1) break;
+    }
+
+    totals t = run_walk(root, cores, index, stats);
+    row("fs_walk, écriture de l'index", stats.seconds, t, stats.entries);
+    t = run_walk(root, cores, index, stats);
+    row("fs_walk, avec l'index", stats.seconds, t, stats.entries);
+    std::cout << "  " << stats.reused << " dossiers sur " << stats.directories << " repris de l'index, "
+              << std::filesystem::file_size(index) / 1024 << " Kio d'index\n";
+    std::remove(index.c_str());
+    return 0;
+}
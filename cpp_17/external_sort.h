@@ -0,0 +1,516 @@
+#ifndef CPP_17_EXTERNAL_SORT_H
+#define CPP_17_EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Tri externe d'un fichier binaire de valeurs (double par défaut) plus gros que la mémoire :
+//
+//   1. runs : le fichier est lu par morceaux de la moitié du budget ; pendant qu'un morceau est
+//      trié (une tranche par thread, chaque tranche devient un run) et écrit d'un seul bloc,
+//      le suivant est déjà en lecture dans l'autre moitié ;
+//   2. fusion : un arbre des perdants fusionne k runs ; chaque run est lu par deux blocs
+//      (l'un est consommé pendant que l'autre se remplit) et la sortie est écrite de même.
+//      S'il y a trop de runs pour que chacun ait un bloc d'au moins min_block octets,
+//      des passes intermédiaires les fusionnent par groupes dans un fichier temporaire.
+//
+// Les lectures et écritures passent par deux threads d'E/S (pread / pwrite), le thread
+// appelant ne fait que trier et fusionner. Fichiers temporaires dans temp_dir, supprimés dès
+// leur création (ils disparaissent avec le processus). Erreurs : std::system_error.
+namespace external_sort {
+
+    struct options {
+        std::size_t memory_budget = std::size_t{1} << 30;  // octets, tampons de tri et de fusion
+        unsigned threads = 0;                               // tri des runs ; 0 : un par coeur
+        std::string temp_dir = ".";
+        std::size_t min_block = std::size_t{1} << 20;       // bloc de lecture minimal par run en fusion
+    };
+
+    struct stats {
+        std::uint64_t elements = 0;
+        std::size_t runs = 0;
+        std::size_t merge_passes = 0;       // passes intermédiaires + fusion finale
+        double run_seconds = 0;
+        double merge_seconds = 0;
+    };
+
+    namespace detail {
+
+        [[noreturn]] inline void fail(const std::string& what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        // Descripteur de fichier, lectures et écritures à position explicite
+        class file {
+        public:
+            file(const std::string& path, int flags) : path_(path), fd_(::open(path.c_str(), flags | O_CLOEXEC, 0644)) {
+                if (fd_ < 0) fail("open(" + path + ")");
+            }
+
+            // Fichier anonyme dans `dir` : supprimé tout de suite, vit tant qu'il est ouvert
+            static file temporary(const std::string& dir) {
+                std::string name = dir + "/external_sort.XXXXXX";
+                const int fd = ::mkstemp(name.data());
+                if (fd < 0) fail("mkstemp(" + name + ")");
+                ::unlink(name.c_str());
+                file f;
+                f.path_ = std::move(name);
+                f.fd_ = fd;
+                return f;
+            }
+
+            file(file&& other) noexcept : path_(std::move(other.path_)), fd_(std::exchange(other.fd_, -1)) {}
+            file& operator=(file&& other) noexcept {
+                std::swap(path_, other.path_);
+                std::swap(fd_, other.fd_);
+                return *this;
+            }
+            file(const file&) = delete;
+            file& operator=(const file&) = delete;
+            ~file() {
+                if (fd_ >= 0) ::close(fd_);
+            }
+
+            std::uint64_t size() const {
+                struct stat st{};
+                if (::fstat(fd_, &st) != 0) fail("fstat(" + path_ + ")");
+                return static_cast<std::uint64_t>(st.st_size);
+            }
+
+            void advise_sequential() const { ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL); }
+
+            // Octets lus : moins que demandé seulement en fin de fichier
+            std::size_t read_at(void* data, std::size_t bytes, std::uint64_t offset) const {
+                std::size_t done = 0;
+                while (done < bytes) {
+                    const ssize_t n = ::pread(fd_, static_cast<char*>(data) + done, bytes - done,
+                                              static_cast<off_t>(offset + done));
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n < 0) fail("pread(" + path_ + ")");
+                    if (n == 0) break;
+                    done += static_cast<std::size_t>(n);
+                }
+                return done;
+            }
+
+            void write_at(const void* data, std::size_t bytes, std::uint64_t offset) const {
+                std::size_t done = 0;
+                while (done < bytes) {
+                    const ssize_t n = ::pwrite(fd_, static_cast<const char*>(data) + done, bytes - done,
+                                               static_cast<off_t>(offset + done));
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n < 0) fail("pwrite(" + path_ + ")");
+                    done += static_cast<std::size_t>(n);
+                }
+            }
+
+        private:
+            file() = default;
+
+            std::string path_;
+            int fd_ = -1;
+        };
+
+        // Un thread qui exécute les requêtes d'E/S dans l'ordre ; les exceptions
+        // remontent par les futures
+        class io_worker {
+        public:
+            io_worker() : thread_([this] { run(); }) {}
+
+            ~io_worker() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                }
+                wake_.notify_one();
+                thread_.join();
+            }
+
+            io_worker(const io_worker&) = delete;
+            io_worker& operator=(const io_worker&) = delete;
+
+            template <typename F>
+            std::future<std::invoke_result_t<F>> submit(F job) {
+                auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::move(job));
+                auto result = task->get_future();
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    jobs_.push([task] { (*task)(); });
+                }
+                wake_.notify_one();
+                return result;
+            }
+
+        private:
+            void run() {
+                while (true) {
+                    std::function<void()> job;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        wake_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+                        if (jobs_.empty()) return;
+                        job = std::move(jobs_.front());
+                        jobs_.pop();
+                    }
+                    job();
+                }
+            }
+
+            std::mutex mutex_;
+            std::condition_variable wake_;
+            std::queue<std::function<void()>> jobs_;
+            bool stopping_ = false;
+            std::thread thread_;
+        };
+
+        // Run trié dans un fichier, en éléments
+        struct run {
+            std::uint64_t offset;
+            std::uint64_t count;
+        };
+
+        // Arbre des perdants : chaque noeud interne garde le perdant de son match, la racine
+        // (tree_[0]) le gagnant ; remplacer le gagnant ne rejoue que son chemin, log2(k) comparaisons
+        template <typename T, typename Compare>
+        class loser_tree {
+        public:
+            static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+            loser_tree(std::size_t k, Compare comp) : k_(k), tree_(k, none), keys_(k), done_(k, true), comp_(comp) {}
+
+            // Charger la tête de chaque run (done : run vide), puis build()
+            void set(std::size_t leaf, const T& key) {
+                keys_[leaf] = key;
+                done_[leaf] = false;
+            }
+
+            void build() {
+                std::fill(tree_.begin(), tree_.end(), none);
+                for (std::size_t leaf = 0; leaf < k_; ++leaf) adjust(leaf);
+            }
+
+            bool empty() const { return done_[tree_[0]]; }
+            std::size_t winner() const { return tree_[0]; }
+            const T& top() const { return keys_[tree_[0]]; }
+
+            // Nouvelle tête du run gagnant, ou son épuisement
+            void replace_top(const T& key) {
+                keys_[tree_[0]] = key;
+                adjust(tree_[0]);
+            }
+            void exhaust_top() {
+                done_[tree_[0]] = true;
+                adjust(tree_[0]);
+            }
+
+        private:
+            // Vrai si a passe avant b : les runs épuisés perdent toujours, égalité départagée par l'indice
+            bool beats(std::size_t a, std::size_t b) const {
+                if (done_[a] != done_[b]) return done_[b];
+                if (done_[a]) return a < b;
+                if (comp_(keys_[a], keys_[b])) return true;
+                if (comp_(keys_[b], keys_[a])) return false;
+                return a < b;
+            }
+
+            void adjust(std::size_t leaf) {
+                std::size_t winner = leaf;
+                for (std::size_t node = (leaf + k_) / 2; node > 0; node /= 2) {
+                    if (tree_[node] == none) {  // construction : le premier arrivé attend son adversaire
+                        tree_[node] = winner;
+                        return;
+                    }
+                    if (beats(tree_[node], winner)) std::swap(tree_[node], winner);
+                }
+                tree_[0] = winner;
+            }
+
+            std::size_t k_;
+            std::vector<std::size_t> tree_;
+            std::vector<T> keys_;
+            std::vector<unsigned char> done_;     // pas de vector<bool> : lu à chaque comparaison
+            Compare comp_;
+        };
+
+        // Lecture d'un run par deux blocs : l'un est consommé, l'autre se remplit
+        template <typename T>
+        class run_reader {
+        public:
+            run_reader(const file& in, run r, std::size_t block, io_worker& io)
+                    : in_(&in), io_(&io), next_(r.offset), end_(r.offset + r.count), front_(block), back_(block) {
+                request();
+                refill();
+            }
+
+            // Une lecture en cours vise back_ : l'attendre avant de libérer le bloc
+            run_reader(run_reader&&) noexcept = default;
+            ~run_reader() {
+                if (pending_.valid()) pending_.wait();
+            }
+
+            bool exhausted() const { return pos_ == size_; }
+            const T& head() const { return front_[pos_]; }
+
+            void pop() {
+                if (++pos_ == size_) refill();
+            }
+
+        private:
+            void request() {
+                if (next_ == end_) return;
+                const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(back_.size(), end_ - next_));
+                const std::uint64_t offset = next_ * sizeof(T);
+                T* data = back_.data();
+                const file* in = in_;
+                pending_ = io_->submit([in, data, count, offset] {
+                    if (in->read_at(data, count * sizeof(T), offset) != count * sizeof(T)) {
+                        errno = EIO;
+                        fail("run tronqué");
+                    }
+                    return count;
+                });
+                next_ += count;
+            }
+
+            void refill() {
+                pos_ = size_ = 0;
+                if (!pending_.valid()) return;
+                size_ = pending_.get();
+                std::swap(front_, back_);
+                request();
+            }
+
+            const file* in_;
+            io_worker* io_;
+            std::uint64_t next_;
+            std::uint64_t end_;
+            std::vector<T> front_;
+            std::vector<T> back_;
+            std::size_t pos_ = 0;
+            std::size_t size_ = 0;
+            std::future<std::size_t> pending_;
+        };
+
+        // Écriture séquentielle par deux blocs : l'un se remplit pendant que l'autre s'écrit
+        template <typename T>
+        class run_writer {
+        public:
+            run_writer(const file& out, std::uint64_t offset, std::size_t block, io_worker& io)
+                    : out_(&out), io_(&io), next_(offset), buffers_{std::vector<T>(block), std::vector<T>(block)} {}
+
+            ~run_writer() {
+                for (auto& p : pending_) {
+                    if (p.valid()) p.wait();
+                }
+            }
+
+            void push(const T& value) {
+                buffers_[current_][fill_] = value;
+                if (++fill_ == buffers_[current_].size()) flush();
+            }
+
+            // Écrit le reste et attend la fin des écritures ; renvoie la position de fin
+            std::uint64_t finish() {
+                flush();
+                for (auto& p : pending_) {
+                    if (p.valid()) p.get();
+                }
+                return next_;
+            }
+
+        private:
+            void flush() {
+                if (fill_ == 0) return;
+                const T* data = buffers_[current_].data();
+                const std::size_t bytes = fill_ * sizeof(T);
+                const std::uint64_t offset = next_ * sizeof(T);
+                const file* out = out_;
+                pending_[current_] = io_->submit([out, data, bytes, offset] { out->write_at(data, bytes, offset); });
+                next_ += fill_;
+                fill_ = 0;
+                current_ ^= 1;
+                if (pending_[current_].valid()) pending_[current_].get();
+            }
+
+            const file* out_;
+            io_worker* io_;
+            std::uint64_t next_;
+            std::vector<T> buffers_[2];
+            std::future<void> pending_[2];
+            std::size_t current_ = 0;
+            std::size_t fill_ = 0;
+        };
+
+        // Fusion de runs consécutifs de `in` à la position `offset` (éléments) de `out`
+        template <typename T, typename Compare>
+        run merge(const file& in, const run* first, std::size_t k, const file& out, std::uint64_t offset,
+                  std::size_t block, io_worker& reader, io_worker& writer, Compare comp) {
+            std::vector<run_reader<T>> readers;
+            readers.reserve(k);
+            loser_tree<T, Compare> tree(k, comp);
+            for (std::size_t i = 0; i < k; ++i) {
+                readers.emplace_back(in, first[i], block, reader);
+                if (!readers[i].exhausted()) tree.set(i, readers[i].head());
+            }
+            tree.build();
+
+            run_writer<T> output(out, offset, block, writer);
+            while (!tree.empty()) {
+                output.push(tree.top());
+                run_reader<T>& source = readers[tree.winner()];
+                source.pop();
+                if (source.exhausted()) {
+                    tree.exhaust_top();
+                } else {
+                    tree.replace_top(source.head());
+                }
+            }
+            const std::uint64_t end = output.finish();
+            return {offset, end - offset};
+        }
+
+        // Tri parallèle d'un morceau : une tranche par thread, chaque tranche est un run
+        template <typename T, typename Compare>
+        void sort_slices(std::vector<T>& data, std::size_t count, unsigned threads, std::uint64_t first,
+                         std::vector<run>& runs, Compare comp) {
+            const std::size_t slices = std::max<std::size_t>(1, std::min<std::size_t>(threads, count / 4096));
+            std::vector<std::thread> workers;
+            for (std::size_t s = 0; s < slices; ++s) {
+                const std::size_t begin = count * s / slices, end = count * (s + 1) / slices;
+                runs.push_back({first + begin, end - begin});
+                if (s + 1 == slices) {
+                    std::sort(data.begin() + begin, data.begin() + end, comp);
+                } else {
+                    workers.emplace_back([&data, begin, end, comp] { std::sort(data.begin() + begin, data.begin() + end, comp); });
+                }
+            }
+            for (auto& w : workers) w.join();
+        }
+
+    }  // namespace detail
+
+    // Trie le fichier `input` (valeurs T brutes, ordre des octets de la machine) dans `output`
+    template <typename T = double, typename Compare = std::less<T>>
+    stats sort_file(const std::string& input, const std::string& output, const options& opts = {}, Compare comp = {}) {
+        static_assert(std::is_trivially_copyable_v<T>, "sort_file lit et écrit les valeurs octet par octet");
+        using clock_type = std::chrono::steady_clock;
+        const unsigned threads = opts.threads != 0 ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+        const std::size_t budget = std::max<std::size_t>(opts.memory_budget / sizeof(T), 1024);
+
+        stats result;
+        detail::file in(input, O_RDONLY);
+        in.advise_sequential();
+        const std::uint64_t total = in.size() / sizeof(T);
+        result.elements = total;
+        detail::io_worker reader, writer;
+
+        // 1. Runs : deux moitiés du budget, lecture de l'une pendant le tri et l'écriture de l'autre
+        auto start = clock_type::now();
+        detail::file runs_file = detail::file::temporary(opts.temp_dir);
+        std::vector<detail::run> runs;
+        {
+            const std::size_t chunk = budget / 2;
+            std::vector<T> halves[2] = {std::vector<T>(static_cast<std::size_t>(std::min<std::uint64_t>(chunk, total))),
+                                        std::vector<T>(static_cast<std::size_t>(std::min<std::uint64_t>(chunk, total)))};
+            std::shared_future<void> written[2];
+            std::future<std::size_t> loading[2];
+            const auto load = [&](int half, std::uint64_t first) {
+                const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(chunk, total - first));
+                T* data = halves[half].data();
+                std::shared_future<void> previous = written[half];
+                loading[half] = reader.submit([&in, data, count, first, previous] {
+                    if (previous.valid()) previous.get();  // la moitié doit être écrite avant d'être relue
+                    if (in.read_at(data, count * sizeof(T), first * sizeof(T)) != count * sizeof(T)) {
+                        errno = EIO;
+                        detail::fail("entrée tronquée");
+                    }
+                    return count;
+                });
+            };
+            // En cas d'erreur, attendre les E/S qui visent encore les deux moitiés
+            const auto drain = [&] {
+                for (auto& l : loading) {
+                    if (l.valid()) l.wait();
+                }
+                for (auto& w : written) {
+                    if (w.valid()) w.wait();
+                }
+            };
+            std::uint64_t first = 0;
+            int half = 0;
+            try {
+                if (total > 0) load(0, 0);
+                while (first < total) {
+                    const std::size_t count = loading[half].get();
+                    if (first + count < total) load(half ^ 1, first + count);
+                    detail::sort_slices(halves[half], count, threads, first, runs, comp);
+                    const T* data = halves[half].data();
+                    const std::uint64_t offset = first * sizeof(T);
+                    written[half] = writer.submit([&runs_file, data, count, offset] {
+                        runs_file.write_at(data, count * sizeof(T), offset);
+                    }).share();
+                    first += count;
+                    half ^= 1;
+                }
+                for (auto& w : written) {
+                    if (w.valid()) w.get();
+                }
+            } catch (...) {
+                drain();
+                throw;
+            }
+        }
+        result.runs = runs.size();
+        result.run_seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+
+        // 2. Fusion : au plus fan_in runs à la fois, deux blocs par run et deux pour la sortie
+        start = clock_type::now();
+        const std::size_t min_block = std::max<std::size_t>(opts.min_block / sizeof(T), 1);
+        const std::size_t blocks = budget / (2 * min_block);
+        const std::size_t fan_in = blocks > 3 ? blocks - 1 : 2;
+        detail::file current = std::move(runs_file);
+        while (runs.size() > fan_in) {
+            detail::file next = detail::file::temporary(opts.temp_dir);
+            std::vector<detail::run> merged;
+            const std::size_t block = budget / (2 * (fan_in + 1));
+            std::uint64_t offset = 0;
+            for (std::size_t i = 0; i < runs.size(); i += fan_in) {
+                const std::size_t k = std::min(fan_in, runs.size() - i);
+                merged.push_back(detail::merge<T>(current, &runs[i], k, next, offset, block, reader, writer, comp));
+                offset += merged.back().count;
+            }
+            runs = std::move(merged);
+            current = std::move(next);
+            ++result.merge_passes;
+        }
+        detail::file out(output, O_WRONLY | O_CREAT | O_TRUNC);
+        if (!runs.empty()) {
+            const std::size_t block = std::max<std::size_t>(budget / (2 * (runs.size() + 1)), 1);
+            detail::merge<T>(current, runs.data(), runs.size(), out, 0, block, reader, writer, comp);
+        }
+        ++result.merge_passes;
+        result.merge_seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+        return result;
+    }
+
+}  // namespace external_sort
+
+#endif //CPP_17_EXTERNAL_SORT_H
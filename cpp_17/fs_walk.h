@@ -0,0 +1,501 @@
+#ifndef CPP_17_FS_WALK_H
+#define CPP_17_FS_WALK_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Parcours parallèle d'une arborescence, plus rapide qu'un recursive_directory_iterator :
+//
+//   - chaque worker a sa file de dossiers ; il traite les siens en profondeur (fin de file) et,
+//     quand elle est vide, vole la moitié la plus ancienne de la file d'un autre (les dossiers
+//     les moins profonds, donc les plus gros sous-arbres) ;
+//   - les entrées sont lues par getdents64 dans un tampon de 64 Kio par worker, leurs
+//     métadonnées (si demandées) par statx relatif au dossier ouvert : seul le chemin de chaque
+//     dossier est construit, celui d'un fichier seulement si le visiteur appelle entry::path() ;
+//   - prune écarte des sous-arbres (.git, build...), match choisit les entrées visitées ;
+//   - avec index_path, un index binaire compact garde, pour chaque dossier, sa date de
+//     modification et ses entrées : au parcours suivant un dossier dont la date n'a pas changé
+//     n'est pas relu, ses entrées viennent de l'index. La date d'un dossier ne change qu'à la
+//     création, suppression ou au renommage d'une entrée : les métadonnées des fichiers
+//     modifiés sur place restent celles de l'index. Un dossier lu en partie (droits, erreur
+//     de getdents64 ou de statx) n'y entre pas : il sera relu au parcours suivant.
+//
+// Le visiteur est appelé depuis les workers : un visiteur par worker, construit par la fabrique
+// passée à walk(). Les erreurs d'un dossier (droits, disparition) sont comptées et le parcours
+// continue ; une racine illisible lève std::filesystem::filesystem_error.
+namespace fs_walk {
+
+    enum class file_type : std::uint8_t { unknown, regular, directory, symlink, other };
+
+    struct metadata {
+        std::uint64_t size = 0;
+        std::int64_t mtime_ns = 0;
+        std::uint32_t mode = 0;
+        bool valid = false;             // faux sans options::stat
+    };
+
+    struct entry {
+        std::string_view directory;     // chemin du dossier parent
+        std::string_view name;
+        file_type type = file_type::unknown;
+        metadata meta;
+        unsigned depth = 0;             // 1 : enfant direct de la racine
+
+        std::filesystem::path path() const {
+            std::string full;
+            full.reserve(directory.size() + 1 + name.size());
+            full.append(directory);
+            if (full.empty() || full.back() != '/') full.push_back('/');  // racine "/"
+            full.append(name);
+            return full;
+        }
+    };
+
+    struct options {
+        unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+        bool stat = false;                                  // statx de chaque entrée
+        unsigned max_depth = static_cast<unsigned>(-1);
+        std::function<bool(const entry&)> prune;            // dossiers à ne pas parcourir
+        std::function<bool(const entry&)> match;            // entrées à visiter (toutes si vide)
+        std::string index_path;                             // vide : pas d'index
+    };
+
+    struct stats {
+        std::uint64_t directories = 0;  // dossiers parcourus
+        std::uint64_t reused = 0;       // dont repris de l'index sans relecture
+        std::uint64_t entries = 0;
+        std::uint64_t visited = 0;
+        std::uint64_t errors = 0;
+        std::uint64_t steals = 0;
+        double seconds = 0;
+    };
+
+    // Filtres usuels pour prune / match
+    inline std::function<bool(const entry&)> name_is(std::string name) {
+        return [name = std::move(name)](const entry& e) { return e.name == name; };
+    }
+
+    inline std::function<bool(const entry&)> extension_is(std::string extension) {
+        return [extension = std::move(extension)](const entry& e) {
+            return e.type == file_type::regular && e.name.size() > extension.size() &&
+                   e.name.compare(e.name.size() - extension.size(), extension.size(), extension) == 0;
+        };
+    }
+
+    namespace detail {
+
+        struct dir_job {
+            std::string path;
+            unsigned depth;
+        };
+
+        struct alignas(64) work_queue {
+            std::mutex mutex;
+            std::deque<dir_job> jobs;
+        };
+
+        // Enregistrement getdents64 du noyau
+        struct linux_dirent64 {
+            std::uint64_t d_ino;
+            std::int64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[1];
+        };
+
+        inline file_type from_dirent(unsigned char t) {
+            switch (t) {
+                case DT_REG: return file_type::regular;
+                case DT_DIR: return file_type::directory;
+                case DT_LNK: return file_type::symlink;
+                case DT_UNKNOWN: return file_type::unknown;
+                default: return file_type::other;
+            }
+        }
+
+        inline file_type from_mode(std::uint32_t mode) {
+            if (S_ISREG(mode)) return file_type::regular;
+            if (S_ISDIR(mode)) return file_type::directory;
+            if (S_ISLNK(mode)) return file_type::symlink;
+            return file_type::other;
+        }
+
+        inline bool stat_at(int dirfd, const char* name, int flags, metadata& meta) {
+            struct statx stx{};
+            if (::statx(dirfd, name, flags | AT_STATX_DONT_SYNC,
+                        STATX_TYPE | STATX_MODE | STATX_SIZE | STATX_MTIME, &stx) != 0) {
+                return false;
+            }
+            meta.size = stx.stx_size;
+            meta.mtime_ns = static_cast<std::int64_t>(stx.stx_mtime.tv_sec) * 1'000'000'000 + stx.stx_mtime.tv_nsec;
+            meta.mode = stx.stx_mode;
+            meta.valid = true;
+            return true;
+        }
+
+        // Index : "FSWI", version, puis un enregistrement par dossier
+        //   u32 longueur du chemin, chemin, i64 date du dossier (ns), u32 nombre d'entrées,
+        //   puis par entrée : u8 type (bit 7 : métadonnées présentes), u16 longueur du nom, nom,
+        //   u64 taille, i64 date (ns), u32 mode
+        inline constexpr char index_magic[4] = {'F', 'S', 'W', 'I'};
+        inline constexpr std::uint32_t index_version = 1;
+
+        template <typename V>
+        void put(std::string& out, V value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof value);
+        }
+
+        template <typename V>
+        V get(const char*& in) {
+            V value;
+            std::memcpy(&value, in, sizeof value);
+            in += sizeof value;
+            return value;
+        }
+
+        class index_writer {
+        public:
+            void begin_directory(std::string_view path, std::int64_t mtime_ns) {
+                record_at_ = out_.size();
+                put(out_, static_cast<std::uint32_t>(path.size()));
+                out_.append(path);
+                put(out_, mtime_ns);
+                count_at_ = out_.size();
+                put(out_, std::uint32_t{0});
+                count_ = 0;
+            }
+
+            void add(const entry& e) {
+                put(out_, static_cast<std::uint8_t>(static_cast<std::uint8_t>(e.type) | (e.meta.valid ? 0x80 : 0)));
+                put(out_, static_cast<std::uint16_t>(e.name.size()));
+                out_.append(e.name);
+                put(out_, e.meta.size);
+                put(out_, e.meta.mtime_ns);
+                put(out_, e.meta.mode);
+                ++count_;
+            }
+
+            void end_directory() { std::memcpy(&out_[count_at_], &count_, sizeof count_); }
+
+            // Dossier lu en partie (ouverture, getdents64 ou statx en échec) : pas d'enregistrement,
+            // le parcours suivant le relira
+            void drop_directory() { out_.resize(record_at_); }
+
+            // Dossier inchangé : l'enregistrement de l'ancien index est recopié tel quel
+            void copy(std::string_view record) { out_.append(record); }
+
+            const std::string& bytes() const { return out_; }
+
+        private:
+            std::string out_;
+            std::size_t record_at_ = 0;
+            std::size_t count_at_ = 0;
+            std::uint32_t count_ = 0;
+        };
+
+        // Ancien index chargé en mémoire : dossier -> enregistrement
+        class index_reader {
+        public:
+            struct record {
+                std::int64_t mtime_ns;
+                std::string_view bytes;     // enregistrement complet
+                const char* entries;
+                std::uint32_t count;
+                bool metadata;              // toutes les entrées ont leurs métadonnées
+            };
+
+            bool load(const std::string& path) {
+                std::ifstream in(path, std::ios::binary);
+                if (!in) return false;
+                data_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                if (data_.size() < 8 || std::memcmp(data_.data(), index_magic, 4) != 0) return fail();
+                const char* p = data_.data() + 4;
+                const char* end = data_.data() + data_.size();
+                if (get<std::uint32_t>(p) != index_version) return fail();
+                while (p < end) {
+                    const char* start = p;
+                    if (end - p < 4) return fail();
+                    const auto length = get<std::uint32_t>(p);
+                    if (static_cast<std::size_t>(end - p) < length + 12u) return fail();
+                    const std::string_view dir(p, length);
+                    p += length;
+                    record r{get<std::int64_t>(p), {}, nullptr, get<std::uint32_t>(p), true};
+                    r.entries = p;
+                    for (std::uint32_t i = 0; i < r.count; ++i) {
+                        if (end - p < 3) return fail();
+                        if ((get<std::uint8_t>(p) & 0x80) == 0) r.metadata = false;
+                        const auto name = get<std::uint16_t>(p);
+                        if (static_cast<std::size_t>(end - p) < name + 20u) return fail();
+                        p += name + 20;
+                    }
+                    r.bytes = std::string_view(start, static_cast<std::size_t>(p - start));
+                    records_.emplace(dir, r);
+                }
+                return true;
+            }
+
+            const record* find(std::string_view dir) const {
+                const auto it = records_.find(dir);
+                return it == records_.end() ? nullptr : &it->second;
+            }
+
+            // Entrées d'un enregistrement, dans l'ordre
+            template <typename F>
+            static void for_each(const record& r, std::string_view dir, unsigned depth, F&& f) {
+                const char* p = r.entries;
+                for (std::uint32_t i = 0; i < r.count; ++i) {
+                    entry e;
+                    e.directory = dir;
+                    e.depth = depth;
+                    const auto type = get<std::uint8_t>(p);
+                    e.type = static_cast<file_type>(type & 0x7f);
+                    const auto length = get<std::uint16_t>(p);
+                    e.name = std::string_view(p, length);
+                    p += length;
+                    e.meta.size = get<std::uint64_t>(p);
+                    e.meta.mtime_ns = get<std::int64_t>(p);
+                    e.meta.mode = get<std::uint32_t>(p);
+                    e.meta.valid = (type & 0x80) != 0;
+                    f(e);
+                }
+            }
+
+        private:
+            bool fail() {
+                records_.clear();
+                return false;
+            }
+
+            std::string data_;
+            std::unordered_map<std::string_view, record> records_;
+        };
+
+        inline void write_index(const std::string& path, const std::vector<index_writer>& parts) {
+            const std::string tmp = path + ".tmp";
+            {
+                std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+                out.write(index_magic, 4);
+                out.write(reinterpret_cast<const char*>(&index_version), sizeof index_version);
+                for (const auto& part : parts) out.write(part.bytes().data(), static_cast<std::streamsize>(part.bytes().size()));
+                if (!out) return;
+            }
+            std::rename(tmp.c_str(), path.c_str());
+        }
+
+    }  // namespace detail
+
+    template <typename MakeVisitor>
+    stats walk(const std::filesystem::path& root, MakeVisitor&& make_visitor, const options& opts = {}) {
+        using clock_type = std::chrono::steady_clock;
+        const auto start = clock_type::now();
+        const unsigned workers = std::max(1u, opts.workers);
+
+        std::string root_path = root.string();
+        while (root_path.size() > 1 && root_path.back() == '/') root_path.pop_back();
+        metadata root_meta;
+        if (!detail::stat_at(AT_FDCWD, root_path.c_str(), 0, root_meta) || !S_ISDIR(root_meta.mode)) {
+            throw std::filesystem::filesystem_error("fs_walk", root, std::error_code(errno ? errno : ENOTDIR, std::generic_category()));
+        }
+
+        detail::index_reader previous;
+        const bool indexed = !opts.index_path.empty();
+        if (indexed) previous.load(opts.index_path);
+
+        std::vector<detail::work_queue> queues(workers);
+        std::vector<detail::index_writer> index_parts(indexed ? workers : 0);
+        std::vector<stats> per_worker(workers);
+        std::atomic<std::uint64_t> pending{1};
+        queues[0].jobs.push_back({root_path, 0});
+
+        const auto work = [&](unsigned w) {
+            auto visit = make_visitor(w);
+            stats& st = per_worker[w];
+            detail::work_queue& own = queues[w];
+            std::vector<char> buffer(64 << 10);
+            std::vector<detail::dir_job> children;
+
+            // Une entrée lue : visite, et file d'attente si c'est un dossier à parcourir
+            const auto handle = [&](const entry& e) {
+                ++st.entries;
+                if (!opts.match || opts.match(e)) {
+                    ++st.visited;
+                    visit(e);
+                }
+                if (e.type == file_type::directory && e.depth < opts.max_depth && !(opts.prune && opts.prune(e))) {
+                    std::string child;
+                    child.reserve(e.directory.size() + 1 + e.name.size());
+                    child.append(e.directory);
+                    if (child.back() != '/') child.push_back('/');  // racine "/"
+                    child.append(e.name);
+                    children.push_back({std::move(child), e.depth});
+                }
+            };
+
+            const auto process = [&](const detail::dir_job& job) {
+                ++st.directories;
+                const unsigned depth = job.depth + 1;
+                const std::string_view dir = job.path;
+
+                if (indexed) {
+                    metadata dir_meta;
+                    if (!detail::stat_at(AT_FDCWD, job.path.c_str(), 0, dir_meta)) {
+                        ++st.errors;
+                        return;
+                    }
+                    // Sans métadonnées dans l'index, un parcours avec options::stat doit relire
+                    if (const auto* record = previous.find(dir);
+                        record && record->mtime_ns == dir_meta.mtime_ns && (record->metadata || !opts.stat)) {
+                        ++st.reused;
+                        index_parts[w].copy(record->bytes);
+                        detail::index_reader::for_each(*record, dir, depth, handle);
+                        return;
+                    }
+                    index_parts[w].begin_directory(dir, dir_meta.mtime_ns);
+                }
+
+                const int fd = ::open(job.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                if (fd < 0) {
+                    ++st.errors;
+                    if (indexed) index_parts[w].drop_directory();
+                    return;
+                }
+                bool complete = true;
+                while (true) {
+                    const long n = ::syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+                    if (n < 0) {
+                        ++st.errors;
+                        complete = false;
+                    }
+                    if (n <= 0) break;
+                    for (long offset = 0; offset < n;) {
+                        const auto* d = reinterpret_cast<const detail::linux_dirent64*>(buffer.data() + offset);
+                        offset += d->d_reclen;
+                        const char* name = d->d_name;
+                        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+                        entry e;
+                        e.directory = dir;
+                        e.name = name;
+                        e.depth = depth;
+                        e.type = detail::from_dirent(d->d_type);
+                        if (opts.stat || e.type == file_type::unknown) {
+                            if (detail::stat_at(fd, name, AT_SYMLINK_NOFOLLOW, e.meta)) {
+                                e.type = detail::from_mode(e.meta.mode);
+                                if (!opts.stat) e.meta = metadata{};
+                            } else {
+                                ++st.errors;
+                                complete = false;
+                            }
+                        }
+                        if (indexed) index_parts[w].add(e);
+                        handle(e);
+                    }
+                }
+                ::close(fd);
+                if (indexed) {
+                    if (complete) {
+                        index_parts[w].end_directory();
+                    } else {
+                        index_parts[w].drop_directory();
+                    }
+                }
+            };
+
+            std::size_t idle_rounds = 0;
+            while (true) {
+                detail::dir_job job;
+                bool found = false;
+                {
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    if (!own.jobs.empty()) {
+                        job = std::move(own.jobs.back());
+                        own.jobs.pop_back();
+                        found = true;
+                    }
+                }
+                // Vol : la moitié la plus ancienne (les dossiers les moins profonds) d'une autre file
+                for (unsigned k = 1; !found && k < workers; ++k) {
+                    detail::work_queue& victim = queues[(w + k) % workers];
+                    std::deque<detail::dir_job> stolen;
+                    {
+                        std::lock_guard<std::mutex> lock(victim.mutex);
+                        const std::size_t take = (victim.jobs.size() + 1) / 2;
+                        std::move(victim.jobs.begin(), victim.jobs.begin() + static_cast<std::ptrdiff_t>(take),
+                                  std::back_inserter(stolen));
+                        victim.jobs.erase(victim.jobs.begin(), victim.jobs.begin() + static_cast<std::ptrdiff_t>(take));
+                    }
+                    if (stolen.empty()) continue;
+                    ++st.steals;
+                    job = std::move(stolen.front());
+                    stolen.pop_front();
+                    found = true;
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    std::move(stolen.begin(), stolen.end(), std::back_inserter(own.jobs));
+                }
+                if (!found) {
+                    if (pending.load(std::memory_order_acquire) == 0) return;
+                    if (++idle_rounds < 64) {
+                        std::this_thread::yield();
+                    } else {
+                        std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    }
+                    continue;
+                }
+                idle_rounds = 0;
+
+                children.clear();
+                process(job);
+                if (!children.empty()) {
+                    pending.fetch_add(children.size(), std::memory_order_relaxed);
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    for (auto& c : children) own.jobs.push_back(std::move(c));
+                }
+                pending.fetch_sub(1, std::memory_order_release);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned w = 1; w < workers; ++w) threads.emplace_back(work, w);
+        work(0);
+        for (auto& t : threads) t.join();
+
+        if (indexed) detail::write_index(opts.index_path, index_parts);
+
+        stats total;
+        for (const stats& s : per_worker) {
+            total.directories += s.directories;
+            total.reused += s.reused;
+            total.entries += s.entries;
+            total.visited += s.visited;
+            total.errors += s.errors;
+            total.steals += s.steals;
+        }
+        total.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+        return total;
+    }
+
+}  // namespace fs_walk
+
+#endif //CPP_17_FS_WALK_H
@@ -10,6 +10,7 @@
 #include <vector>
 #include <type_traits>
 #include "globalvar.h"
+#include "fs_walk.h"
 
 // 1. Inline variable (C++17)
 //inline const int global_value = 42;
@@ -91,6 +92,27 @@ void checkFileSystem() {
     if (!std::filesystem::exists(path)) {
         std::cout << path << " does not exist.\n";
     }
+
+    // Parallel walk of the parent directory: regular .txt files and their total size, one counter per worker
+    fs_walk::options options;
+    std::vector<std::pair<std::size_t, std::uintmax_t>> perWorker(options.workers);
+    options.stat = true;
+    options.match = fs_walk::extension_is(".txt");
+    options.prune = fs_walk::name_is(".git");
+    const fs_walk::stats stats = fs_walk::walk(path.parent_path(), [&](unsigned worker) {
+        return [&counts = perWorker[worker]](const fs_walk::entry& entry) {
+            ++counts.first;
+            counts.second += entry.meta.size;
+        };
+    }, options);
+    std::size_t files = 0;
+    std::uintmax_t bytes = 0;
+    for (const auto& [count, size] : perWorker) {
+        files += count;
+        bytes += size;
+    }
+    std::cout << files << " .txt files (" << bytes << " bytes) in " << stats.directories << " directories under "
+              << path.parent_path() << '\n';
 }
 
 // 8. std::any (C++17)
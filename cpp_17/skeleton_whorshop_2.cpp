@@ -1,9 +1,11 @@
 #include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <cstdlib>
 #include <execution>
 #include <iostream>
 #include <vector>
+#include "external_sort.h"
 
 auto now()
 {
@@ -58,6 +60,20 @@ void exercise2()
         const auto toc = now();
         std::cout << ms(toc - tic) << "\n";
     }
+    {
+        // Tri hors mémoire : les mêmes valeurs dans un fichier, 16 Mo de tampons pour 80 Mo de données
+        std::FILE* file = std::fopen("exercise2.bin", "wb");
+        std::fwrite(c.data(), sizeof(double), c.size(), file);
+        std::fclose(file);
+        external_sort::options opts;
+        opts.memory_budget = 16 << 20;
+        const auto tic = now();
+        external_sort::sort_file("exercise2.bin", "exercise2.sorted.bin", opts);
+        const auto toc = now();
+        std::cout << ms(toc - tic) << "\n";
+        std::remove("exercise2.bin");
+        std::remove("exercise2.sorted.bin");
+    }
 }
 
 
@@ -1,8 +1,173 @@
 //
 // Created by Ihab ABADI on 05/11/2024.
 //
+module;
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
 export module Module1;
 
 export int add(int a, int b) {
     return a + b;
-}
\ No newline at end of file
+}
+
+// Noyaux arithmétiques sur des tableaux : out[i] = a[i] op b[i] (op c[i] pour fma), pour
+// tous les types entiers et flottants.
+//
+//     std::vector<float> a(n), b(n), out(n);
+//     simd::add<float>(a, b, out);                        // meilleur jeu d'instructions
+//     simd::mul<std::int64_t>(x, y, z, simd::isa::avx2);  // jeu imposé (bancs d'essai)
+//
+//   - le nombre de voies est fixé à la compilation pour chaque couple (type, jeu d'instructions) :
+//     simd::lanes<T, I> ;
+//   - le jeu d'instructions est choisi à l'exécution (AVX-512 F/BW/DQ/VL, puis AVX2 + FMA,
+//     sinon scalaire) une fois pour toutes ;
+//   - la fin du tableau (moins d'un vecteur) passe par des chargements et écritures masqués :
+//     AVX-512 pour toutes les tailles, AVX2 pour les éléments de 4 et 8 octets ; AVX2 n'a pas de
+//     masque sur 1 et 2 octets, la fin passe alors par un vecteur sur la pile (memcpy) ;
+//   - entiers : add, sub et mul modulo 2^n comme les instructions (pas de comportement indéfini
+//     en signé), fma = a * b + c ; saturating_add borne au minimum / maximum du type.
+//     Flottants : fma avec un seul arrondi, saturating_add = add (IEEE sature déjà à l'infini).
+//   - les trois tableaux (quatre pour fma) doivent avoir la même taille, sinon
+//     std::invalid_argument ; out peut être l'une des entrées.
+export namespace simd {
+
+    template <typename T>
+    concept Numeric = (std::integral<T> && !std::same_as<std::remove_cv_t<T>, bool>) || std::floating_point<T>;
+
+    enum class isa { scalar, avx2, avx512 };
+
+    constexpr const char* name(isa which) {
+        switch (which) {
+            case isa::avx2: return "avx2";
+            case isa::avx512: return "avx512";
+            default: return "scalaire";
+        }
+    }
+
+    // Défini dans Module1_simd.cpp
+    bool supported(isa which);
+
+    isa best() {
+        static const isa detected = supported(isa::avx512) ? isa::avx512 : supported(isa::avx2) ? isa::avx2 : isa::scalar;
+        return detected;
+    }
+
+    // Types traités par les jeux vectoriels (long double et __int128 restent scalaires)
+    template <typename T>
+    concept Vectorizable = Numeric<T> && sizeof(T) <= 8 && (std::integral<T> || std::same_as<T, float> || std::same_as<T, double>);
+
+    template <Numeric T, isa I>
+    inline constexpr std::size_t lanes = !Vectorizable<T> || I == isa::scalar ? 1 : (I == isa::avx2 ? 32 : 64) / sizeof(T);
+
+}
+
+namespace simd::detail {
+
+    enum class op { add, sub, mul, fma, saturating_add };
+
+    // Représentation des éléments : seuls la taille, le signe et le caractère flottant comptent
+    enum class kind { i8, u8, i16, u16, i32, u32, i64, u64, f32, f64 };
+
+    template <typename T>
+    constexpr kind kind_of() {
+        static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "pas de noyau pour cette taille");
+        if constexpr (std::same_as<T, float>) return kind::f32;
+        else if constexpr (std::same_as<T, double>) return kind::f64;
+        else if constexpr (sizeof(T) == 1) return std::is_signed_v<T> ? kind::i8 : kind::u8;
+        else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? kind::i16 : kind::u16;
+        else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? kind::i32 : kind::u32;
+        else return std::is_signed_v<T> ? kind::i64 : kind::u64;
+    }
+
+    using kernel = void (*)(const void* a, const void* b, const void* c, void* out, std::size_t n);
+
+    // Noyau vectoriel pour (jeu, opération, représentation), nullptr pour le scalaire (Module1_simd.cpp)
+    kernel find(isa which, op o, kind k);
+
+    // Lance std::invalid_argument (Module1_simd.cpp : <stdexcept> dans l'interface du module fait
+    // mal compiler std::span côté importateur avec GCC 12)
+    [[noreturn]] void fail(const char* message);
+
+    // Référence scalaire : arithmétique modulo 2^n sur les entiers
+    template <op O, typename T>
+    T scalar_step(T a, T b, T c) {
+        if constexpr (std::floating_point<T>) {
+            if constexpr (O == op::add || O == op::saturating_add) return a + b;
+            if constexpr (O == op::sub) return a - b;
+            if constexpr (O == op::mul) return a * b;
+            if constexpr (O == op::fma) return std::fma(a, b, c);
+        } else {
+            using U = std::make_unsigned_t<std::conditional_t<(sizeof(T) < sizeof(int)), int, T>>;
+            const U x = static_cast<U>(a), y = static_cast<U>(b);
+            if constexpr (O == op::add) return static_cast<T>(x + y);
+            if constexpr (O == op::sub) return static_cast<T>(x - y);
+            if constexpr (O == op::mul) return static_cast<T>(x * y);
+            if constexpr (O == op::fma) return static_cast<T>(x * y + static_cast<U>(c));
+            if constexpr (O == op::saturating_add) {
+                constexpr T low = std::numeric_limits<T>::min(), high = std::numeric_limits<T>::max();
+                if constexpr (std::is_unsigned_v<T>) {
+                    return a > high - b ? high : static_cast<T>(a + b);
+                } else {
+                    if (b > 0 && a > high - b) return high;
+                    if (b < 0 && a < low - b) return low;
+                    return static_cast<T>(a + b);
+                }
+            }
+        }
+    }
+
+    template <op O, typename T>
+    void run_scalar(const T* a, const T* b, const T* c, T* out, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) out[i] = scalar_step<O>(a[i], b[i], O == op::fma ? c[i] : T{});
+    }
+
+    template <op O, typename T>
+    void apply(isa which, std::span<const T> a, std::span<const T> b, std::span<const T> c, std::span<T> out) {
+        if (a.size() != out.size() || b.size() != out.size() || (O == op::fma && c.size() != out.size())) {
+            fail("simd : tableaux de tailles différentes");
+        }
+        if (!supported(which)) fail("simd : jeu d'instructions indisponible sur ce processeur");
+        if constexpr (Vectorizable<T>) {
+            if (const kernel k = find(which, O, kind_of<T>())) return k(a.data(), b.data(), c.data(), out.data(), out.size());
+        }
+        run_scalar<O>(a.data(), b.data(), c.data(), out.data(), out.size());
+    }
+
+}
+
+export namespace simd {
+
+    template <Numeric T>
+    void add(std::span<const T> a, std::span<const T> b, std::span<T> out, isa which = best()) {
+        detail::apply<detail::op::add>(which, a, b, {}, out);
+    }
+
+    template <Numeric T>
+    void sub(std::span<const T> a, std::span<const T> b, std::span<T> out, isa which = best()) {
+        detail::apply<detail::op::sub>(which, a, b, {}, out);
+    }
+
+    template <Numeric T>
+    void mul(std::span<const T> a, std::span<const T> b, std::span<T> out, isa which = best()) {
+        detail::apply<detail::op::mul>(which, a, b, {}, out);
+    }
+
+    // out = a * b + c
+    template <Numeric T>
+    void fma(std::span<const T> a, std::span<const T> b, std::span<const T> c, std::span<T> out, isa which = best()) {
+        detail::apply<detail::op::fma>(which, a, b, c, out);
+    }
+
+    template <Numeric T>
+    void saturating_add(std::span<const T> a, std::span<const T> b, std::span<T> out, isa which = best()) {
+        detail::apply<detail::op::saturating_add>(which, a, b, {}, out);
+    }
+
+}
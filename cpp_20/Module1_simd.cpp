@@ -0,0 +1,413 @@
+//
+// Noyaux vectoriels de simd (Module1) : une unité d'implémentation à part, les régions
+// #pragma GCC target ne pouvant pas passer dans l'interface compilée du module.
+//
+module;
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define MODULE1_X86 1
+#else
+#define MODULE1_X86 0
+#endif
+
+module Module1;
+
+namespace simd {
+
+    bool supported(isa which) {
+#if MODULE1_X86
+        switch (which) {
+            case isa::avx512:
+                return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                       __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl");
+            case isa::avx2:
+                return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            default:
+                return true;
+        }
+#else
+        return which == isa::scalar;
+#endif
+    }
+
+}
+
+namespace simd::detail {
+
+    void fail(const char* message) {
+        throw std::invalid_argument(message);
+    }
+
+#if MODULE1_X86
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+    // Registre selon le type d'élément. Des spécialisations plutôt que std::conditional_t :
+    // passés en argument de template, les types __m256 perdent leurs attributs (-Wignored-attributes)
+    template <typename T>
+    struct avx2_register {
+        using type = __m256i;
+    };
+
+    template <>
+    struct avx2_register<float> {
+        using type = __m256;
+    };
+
+    template <>
+    struct avx2_register<double> {
+        using type = __m256d;
+    };
+
+    template <typename T>
+    struct avx2 {
+        using reg = typename avx2_register<T>::type;
+        static constexpr std::size_t lanes = 32 / sizeof(T);
+        static constexpr bool maskable = sizeof(T) >= 4;
+
+        static reg load(const T* p) {
+            if constexpr (std::same_as<T, float>) return _mm256_loadu_ps(p);
+            else if constexpr (std::same_as<T, double>) return _mm256_loadu_pd(p);
+            else return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        static void store(T* p, reg v) {
+            if constexpr (std::same_as<T, float>) _mm256_storeu_ps(p, v);
+            else if constexpr (std::same_as<T, double>) _mm256_storeu_pd(p, v);
+            else _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+        }
+
+        // Voies [0, rest) actives
+        static __m256i tail_mask(std::size_t rest) {
+            if constexpr (sizeof(T) == 4) {
+                return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(rest)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+            } else {
+                return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(rest)), _mm256_setr_epi64x(0, 1, 2, 3));
+            }
+        }
+
+        static reg load_masked(const T* p, __m256i mask) {
+            if constexpr (std::same_as<T, float>) return _mm256_maskload_ps(p, mask);
+            else if constexpr (std::same_as<T, double>) return _mm256_maskload_pd(p, mask);
+            else if constexpr (sizeof(T) == 4) return _mm256_maskload_epi32(reinterpret_cast<const int*>(p), mask);
+            else return _mm256_maskload_epi64(reinterpret_cast<const long long*>(p), mask);
+        }
+
+        static void store_masked(T* p, reg v, __m256i mask) {
+            if constexpr (std::same_as<T, float>) _mm256_maskstore_ps(p, mask, v);
+            else if constexpr (std::same_as<T, double>) _mm256_maskstore_pd(p, mask, v);
+            else if constexpr (sizeof(T) == 4) _mm256_maskstore_epi32(reinterpret_cast<int*>(p), mask, v);
+            else _mm256_maskstore_epi64(reinterpret_cast<long long*>(p), mask, v);
+        }
+
+        static reg add(reg a, reg b) {
+            if constexpr (std::same_as<T, float>) return _mm256_add_ps(a, b);
+            else if constexpr (std::same_as<T, double>) return _mm256_add_pd(a, b);
+            else if constexpr (sizeof(T) == 1) return _mm256_add_epi8(a, b);
+            else if constexpr (sizeof(T) == 2) return _mm256_add_epi16(a, b);
+            else if constexpr (sizeof(T) == 4) return _mm256_add_epi32(a, b);
+            else return _mm256_add_epi64(a, b);
+        }
+
+        static reg sub(reg a, reg b) {
+            if constexpr (std::same_as<T, float>) return _mm256_sub_ps(a, b);
+            else if constexpr (std::same_as<T, double>) return _mm256_sub_pd(a, b);
+            else if constexpr (sizeof(T) == 1) return _mm256_sub_epi8(a, b);
+            else if constexpr (sizeof(T) == 2) return _mm256_sub_epi16(a, b);
+            else if constexpr (sizeof(T) == 4) return _mm256_sub_epi32(a, b);
+            else return _mm256_sub_epi64(a, b);
+        }
+
+        static reg mul(reg a, reg b) {
+            if constexpr (std::same_as<T, float>) {
+                return _mm256_mul_ps(a, b);
+            } else if constexpr (std::same_as<T, double>) {
+                return _mm256_mul_pd(a, b);
+            } else if constexpr (sizeof(T) == 1) {
+                // Pas de produit sur 8 bits : octets pairs et impairs multipliés sur 16 bits
+                const __m256i even = _mm256_mullo_epi16(a, b);
+                const __m256i odd = _mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+                return _mm256_or_si256(_mm256_and_si256(even, _mm256_set1_epi16(0x00FF)), _mm256_slli_epi16(odd, 8));
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm256_mullo_epi16(a, b);
+            } else if constexpr (sizeof(T) == 4) {
+                return _mm256_mullo_epi32(a, b);
+            } else {
+                // Pas de produit sur 64 bits : bas * bas + (bas * haut + haut * bas) << 32
+                const __m256i low = _mm256_mul_epu32(a, b);
+                const __m256i cross = _mm256_mullo_epi32(a, _mm256_shuffle_epi32(b, 0xB1));
+                const __m256i high = _mm256_slli_epi64(_mm256_add_epi32(cross, _mm256_srli_epi64(cross, 32)), 32);
+                return _mm256_add_epi64(low, high);
+            }
+        }
+
+        static reg fma(reg a, reg b, reg c) {
+            if constexpr (std::same_as<T, float>) return _mm256_fmadd_ps(a, b, c);
+            else if constexpr (std::same_as<T, double>) return _mm256_fmadd_pd(a, b, c);
+            else return add(mul(a, b), c);
+        }
+
+        static reg saturating_add(reg a, reg b) {
+            constexpr bool is_signed = std::is_signed_v<T>;
+            if constexpr (std::floating_point<T>) {
+                return add(a, b);
+            } else if constexpr (sizeof(T) == 1) {
+                return is_signed ? _mm256_adds_epi8(a, b) : _mm256_adds_epu8(a, b);
+            } else if constexpr (sizeof(T) == 2) {
+                return is_signed ? _mm256_adds_epi16(a, b) : _mm256_adds_epu16(a, b);
+            } else {
+                const __m256i sum = add(a, b);
+                if constexpr (!is_signed) {
+                    // Débordement si la somme est plus petite que a : tous les bits à 1
+                    __m256i overflow;
+                    if constexpr (sizeof(T) == 4) {
+                        overflow = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_max_epu32(sum, a), sum), _mm256_set1_epi32(-1));
+                    } else {
+                        const __m256i bias = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+                        overflow = _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias), _mm256_xor_si256(sum, bias));
+                    }
+                    return _mm256_or_si256(sum, overflow);
+                } else {
+                    // Débordement si a et b sont de même signe et la somme de l'autre ; borne selon le signe de a
+                    const __m256i flags = _mm256_and_si256(_mm256_xor_si256(a, sum), _mm256_xor_si256(b, sum));
+                    __m256i overflow, bound;
+                    if constexpr (sizeof(T) == 4) {
+                        overflow = _mm256_srai_epi32(flags, 31);
+                        bound = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(std::numeric_limits<int>::max()));
+                    } else {
+                        const __m256i zero = _mm256_setzero_si256();
+                        overflow = _mm256_cmpgt_epi64(zero, flags);
+                        bound = _mm256_xor_si256(_mm256_cmpgt_epi64(zero, a), _mm256_set1_epi64x(std::numeric_limits<long long>::max()));
+                    }
+                    return _mm256_blendv_epi8(sum, bound, overflow);
+                }
+            }
+        }
+
+        template <op O>
+        static reg step(reg a, reg b, reg c) {
+            if constexpr (O == op::add) return add(a, b);
+            if constexpr (O == op::sub) return sub(a, b);
+            if constexpr (O == op::mul) return mul(a, b);
+            if constexpr (O == op::fma) return fma(a, b, c);
+            if constexpr (O == op::saturating_add) return saturating_add(a, b);
+        }
+
+        template <op O>
+        static void run(const T* a, const T* b, const T* c, T* out, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                store(out + i, step<O>(load(a + i), load(b + i), O == op::fma ? load(c + i) : reg{}));
+            }
+            const std::size_t rest = n - i;
+            if (rest == 0) return;
+            if constexpr (maskable) {
+                const __m256i mask = tail_mask(rest);
+                const reg z = O == op::fma ? load_masked(c + i, mask) : reg{};
+                store_masked(out + i, step<O>(load_masked(a + i, mask), load_masked(b + i, mask), z), mask);
+            } else {
+                T x[lanes]{}, y[lanes]{}, z[lanes]{};
+                std::memcpy(x, a + i, rest * sizeof(T));
+                std::memcpy(y, b + i, rest * sizeof(T));
+                if constexpr (O == op::fma) std::memcpy(z, c + i, rest * sizeof(T));
+                store(x, step<O>(load(x), load(y), load(z)));
+                std::memcpy(out + i, x, rest * sizeof(T));
+            }
+        }
+    };
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512dq,avx512vl,fma")
+
+    template <typename T>
+    struct avx512_register {
+        using type = __m512i;
+    };
+
+    template <>
+    struct avx512_register<float> {
+        using type = __m512;
+    };
+
+    template <>
+    struct avx512_register<double> {
+        using type = __m512d;
+    };
+
+    template <typename T>
+    struct avx512 {
+        using reg = typename avx512_register<T>::type;
+        static constexpr std::size_t lanes = 64 / sizeof(T);
+
+        static std::uint64_t tail_mask(std::size_t rest) { return (std::uint64_t{1} << rest) - 1; }
+
+        static reg load_masked(const T* p, std::uint64_t mask) {
+            if constexpr (std::same_as<T, float>) return _mm512_maskz_loadu_ps(static_cast<__mmask16>(mask), p);
+            else if constexpr (std::same_as<T, double>) return _mm512_maskz_loadu_pd(static_cast<__mmask8>(mask), p);
+            else if constexpr (sizeof(T) == 1) return _mm512_maskz_loadu_epi8(static_cast<__mmask64>(mask), p);
+            else if constexpr (sizeof(T) == 2) return _mm512_maskz_loadu_epi16(static_cast<__mmask32>(mask), p);
+            else if constexpr (sizeof(T) == 4) return _mm512_maskz_loadu_epi32(static_cast<__mmask16>(mask), p);
+            else return _mm512_maskz_loadu_epi64(static_cast<__mmask8>(mask), p);
+        }
+
+        static void store_masked(T* p, reg v, std::uint64_t mask) {
+            if constexpr (std::same_as<T, float>) _mm512_mask_storeu_ps(p, static_cast<__mmask16>(mask), v);
+            else if constexpr (std::same_as<T, double>) _mm512_mask_storeu_pd(p, static_cast<__mmask8>(mask), v);
+            else if constexpr (sizeof(T) == 1) _mm512_mask_storeu_epi8(p, static_cast<__mmask64>(mask), v);
+            else if constexpr (sizeof(T) == 2) _mm512_mask_storeu_epi16(p, static_cast<__mmask32>(mask), v);
+            else if constexpr (sizeof(T) == 4) _mm512_mask_storeu_epi32(p, static_cast<__mmask16>(mask), v);
+            else _mm512_mask_storeu_epi64(p, static_cast<__mmask8>(mask), v);
+        }
+
+        static reg load(const T* p) {
+            if constexpr (std::same_as<T, float>) return _mm512_loadu_ps(p);
+            else if constexpr (std::same_as<T, double>) return _mm512_loadu_pd(p);
+            else return _mm512_loadu_si512(p);
+        }
+
+        static void store(T* p, reg v) {
+            if constexpr (std::same_as<T, float>) _mm512_storeu_ps(p, v);
+            else if constexpr (std::same_as<T, double>) _mm512_storeu_pd(p, v);
+            else _mm512_storeu_si512(p, v);
+        }
+
+        static reg add(reg a, reg b) {
+            if constexpr (std::same_as<T, float>) return _mm512_add_ps(a, b);
+            else if constexpr (std::same_as<T, double>) return _mm512_add_pd(a, b);
+            else if constexpr (sizeof(T) == 1) return _mm512_add_epi8(a, b);
+            else if constexpr (sizeof(T) == 2) return _mm512_add_epi16(a, b);
+            else if constexpr (sizeof(T) == 4) return _mm512_add_epi32(a, b);
+            else return _mm512_add_epi64(a, b);
+        }
+
+        static reg sub(reg a, reg b) {
+            if constexpr (std::same_as<T, float>) return _mm512_sub_ps(a, b);
+            else if constexpr (std::same_as<T, double>) return _mm512_sub_pd(a, b);
+            else if constexpr (sizeof(T) == 1) return _mm512_sub_epi8(a, b);
+            else if constexpr (sizeof(T) == 2) return _mm512_sub_epi16(a, b);
+            else if constexpr (sizeof(T) == 4) return _mm512_sub_epi32(a, b);
+            else return _mm512_sub_epi64(a, b);
+        }
+
+        static reg mul(reg a, reg b) {
+            if constexpr (std::same_as<T, float>) {
+                return _mm512_mul_ps(a, b);
+            } else if constexpr (std::same_as<T, double>) {
+                return _mm512_mul_pd(a, b);
+            } else if constexpr (sizeof(T) == 1) {
+                const __m512i even = _mm512_mullo_epi16(a, b);
+                const __m512i odd = _mm512_mullo_epi16(_mm512_srli_epi16(a, 8), _mm512_srli_epi16(b, 8));
+                return _mm512_or_si512(_mm512_and_si512(even, _mm512_set1_epi16(0x00FF)), _mm512_slli_epi16(odd, 8));
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm512_mullo_epi16(a, b);
+            } else if constexpr (sizeof(T) == 4) {
+                return _mm512_mullo_epi32(a, b);
+            } else {
+                return _mm512_mullo_epi64(a, b);
+            }
+        }
+
+        static reg fma(reg a, reg b, reg c) {
+            if constexpr (std::same_as<T, float>) return _mm512_fmadd_ps(a, b, c);
+            else if constexpr (std::same_as<T, double>) return _mm512_fmadd_pd(a, b, c);
+            else return add(mul(a, b), c);
+        }
+
+        static reg saturating_add(reg a, reg b) {
+            constexpr bool is_signed = std::is_signed_v<T>;
+            if constexpr (std::floating_point<T>) {
+                return add(a, b);
+            } else if constexpr (sizeof(T) == 1) {
+                return is_signed ? _mm512_adds_epi8(a, b) : _mm512_adds_epu8(a, b);
+            } else if constexpr (sizeof(T) == 2) {
+                return is_signed ? _mm512_adds_epi16(a, b) : _mm512_adds_epu16(a, b);
+            } else {
+                const __m512i sum = add(a, b);
+                if constexpr (!is_signed) {
+                    if constexpr (sizeof(T) == 4) {
+                        return _mm512_mask_mov_epi32(sum, _mm512_cmplt_epu32_mask(sum, a), _mm512_set1_epi32(-1));
+                    } else {
+                        return _mm512_mask_mov_epi64(sum, _mm512_cmplt_epu64_mask(sum, a), _mm512_set1_epi64(-1));
+                    }
+                } else {
+                    const __m512i flags = _mm512_and_si512(_mm512_xor_si512(a, sum), _mm512_xor_si512(b, sum));
+                    if constexpr (sizeof(T) == 4) {
+                        const __m512i bound = _mm512_mask_mov_epi32(_mm512_set1_epi32(std::numeric_limits<int>::max()), _mm512_movepi32_mask(a), _mm512_set1_epi32(std::numeric_limits<int>::min()));
+                        return _mm512_mask_mov_epi32(sum, _mm512_movepi32_mask(flags), bound);
+                    } else {
+                        const __m512i bound = _mm512_mask_mov_epi64(_mm512_set1_epi64(std::numeric_limits<long long>::max()), _mm512_movepi64_mask(a), _mm512_set1_epi64(std::numeric_limits<long long>::min()));
+                        return _mm512_mask_mov_epi64(sum, _mm512_movepi64_mask(flags), bound);
+                    }
+                }
+            }
+        }
+
+        template <op O>
+        static reg step(reg a, reg b, reg c) {
+            if constexpr (O == op::add) return add(a, b);
+            if constexpr (O == op::sub) return sub(a, b);
+            if constexpr (O == op::mul) return mul(a, b);
+            if constexpr (O == op::fma) return fma(a, b, c);
+            if constexpr (O == op::saturating_add) return saturating_add(a, b);
+        }
+
+        template <op O>
+        static void run(const T* a, const T* b, const T* c, T* out, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                store(out + i, step<O>(load(a + i), load(b + i), O == op::fma ? load(c + i) : reg{}));
+            }
+            if (i == n) return;
+            const std::uint64_t mask = tail_mask(n - i);
+            const reg z = O == op::fma ? load_masked(c + i, mask) : reg{};
+            store_masked(out + i, step<O>(load_masked(a + i, mask), load_masked(b + i, mask), z), mask);
+        }
+    };
+
+#pragma GCC pop_options
+
+    // Signature commune : un noyau par (jeu, opération, type)
+    template <template <typename> class V, op O, typename T>
+    void erased(const void* a, const void* b, const void* c, void* out, std::size_t n) {
+        V<T>::template run<O>(static_cast<const T*>(a), static_cast<const T*>(b), static_cast<const T*>(c), static_cast<T*>(out), n);
+    }
+
+    // Dans l'ordre de kind
+    template <template <typename> class V, op O>
+    constexpr std::array<kernel, 10> row{
+            &erased<V, O, std::int8_t>, &erased<V, O, std::uint8_t>, &erased<V, O, std::int16_t>,
+            &erased<V, O, std::uint16_t>, &erased<V, O, std::int32_t>, &erased<V, O, std::uint32_t>,
+            &erased<V, O, std::int64_t>, &erased<V, O, std::uint64_t>, &erased<V, O, float>, &erased<V, O, double>};
+
+    template <template <typename> class V>
+    constexpr std::array<std::array<kernel, 10>, 5> table{
+            row<V, op::add>, row<V, op::sub>, row<V, op::mul>, row<V, op::fma>, row<V, op::saturating_add>};
+
+    kernel find(isa which, op o, kind k) {
+        if (which == isa::avx512) return table<avx512>[static_cast<std::size_t>(o)][static_cast<std::size_t>(k)];
+        if (which == isa::avx2) return table<avx2>[static_cast<std::size_t>(o)][static_cast<std::size_t>(k)];
+        return nullptr;
+    }
+
+#else
+
+    kernel find(isa, op, kind) {
+        return nullptr;
+    }
+
+#endif
+
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <latch>
+#include <string>
+#include <thread>
+#include <vector>
+#include "channel.h"
+
+// Débit de coro_channel::channel<std::uint64_t> : 1 M messages (nombre en argument) par
+// configuration, pour plusieurs capacités et tailles de pool :
+//   - 1 producteur -> 1 consommateur, puis 4 -> 4 sur le même canal ;
+//   - chaîne producteur -> transformation -> consommateur sur deux canaux.
+// Les coroutines tournent sur le pool et y sont reprises ; la somme reçue est vérifiée.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+    using coro_channel::channel;
+    using coro_channel::detached;
+    using coro_channel::executor;
+
+    struct shared_state {
+        std::atomic<int> producers_left;
+        std::atomic<std::uint64_t> sum{0};
+        std::latch done;
+
+        shared_state(int producers, int tasks) : producers_left(producers), done(tasks) {}
+    };
+
+    detached produce(executor& pool, channel<std::uint64_t>& out, std::uint64_t first, std::uint64_t count, shared_state& state) {
+        co_await pool.schedule();
+        for (std::uint64_t i = first; i < first + count; ++i) co_await out.send(i);
+        if (--state.producers_left == 0) out.close();
+        state.done.count_down();
+    }
+
+    detached transform(executor& pool, channel<std::uint64_t>& in, channel<std::uint64_t>& out, shared_state& state) {
+        co_await pool.schedule();
+        while (auto value = co_await in.recv()) co_await out.send(*value * 3);
+        out.close();
+        state.done.count_down();
+    }
+
+    detached consume(executor& pool, channel<std::uint64_t>& in, shared_state& state) {
+        co_await pool.schedule();
+        std::uint64_t sum = 0;
+        while (auto value = co_await in.recv()) sum += *value;
+        state.sum += sum;
+        state.done.count_down();
+    }
+
+    void row(const char* shape, std::size_t capacity, unsigned threads, std::uint64_t messages, double seconds, bool valid) {
+        std::cout << std::left << std::setw(24) << shape << std::right << std::setw(10) << capacity << std::setw(10) << threads
+                  << std::fixed << std::setprecision(2) << std::setw(12) << static_cast<double>(messages) / seconds / 1e6
+                  << (valid ? "" : "   somme incorrecte") << '\n';
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::uint64_t messages = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const std::uint64_t expected = messages * (messages - 1) / 2;
+
+    std::cout << messages << " messages, " << cores << " coeurs\n"
+              << std::left << std::setw(24) << "forme" << std::right << std::setw(10) << "capacité"
+              << std::setw(10) << "threads" << std::setw(12) << "M msg/s" << '\n';
+
+    std::vector<unsigned> thread_counts{1, 2, 4};
+    if (cores > 4) thread_counts.push_back(cores);
+
+    for (std::size_t capacity : {2, 16, 256, 4096}) {
+        for (unsigned threads : thread_counts) {
+            for (int fan : {1, 4}) {
+                executor pool(threads);
+                channel<std::uint64_t> numbers(capacity, &pool);
+                shared_state state(fan, 2 * fan);
+                const auto start = clock_type::now();
+                for (int c = 0; c < fan; ++c) consume(pool, numbers, state);
+                const std::uint64_t share = messages / static_cast<std::uint64_t>(fan);
+                for (int p = 0; p < fan; ++p) {
+                    const std::uint64_t first = share * static_cast<std::uint64_t>(p);
+                    produce(pool, numbers, first, p + 1 == fan ? messages - first : share, state);
+                }
+                state.done.wait();
+                const double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+                row(fan == 1 ? "1 -> 1" : "4 -> 4", capacity, threads, messages, seconds, state.sum == expected);
+            }
+
+            executor pool(threads);
+            channel<std::uint64_t> first(capacity, &pool), second(capacity, &pool);
+            shared_state state(1, 3);
+            const auto start = clock_type::now();
+            consume(pool, second, state);
+            transform(pool, first, second, state);
+            produce(pool, first, 0, messages, state);
+            state.done.wait();
+            const double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+            row("1 -> transformation -> 1", capacity, threads, messages, seconds, state.sum == 3 * expected);
+        }
+    }
+    return 0;
+}
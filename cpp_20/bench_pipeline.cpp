@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+#include "parallel_pipeline.h"
+
+// filter(pair) | transform(carré) sur 20 M entiers (taille en argument) : std::views en série,
+// boucle écrite à la main, puis pipeline fusionné sur 1 thread et sur tous les coeurs,
+// pour chaque opération terminale (to_vector, reduce, count). Chaque ligne affiche le résultat
+// (taille, somme ou nombre) : il doit être le même pour toutes les variantes.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    // Meilleur temps sur quelques répétitions
+    template <typename Run>
+    void report(const char* name, std::size_t n, Run&& run) {
+        double best = 1e300;
+        long long result = 0;
+        for (int repeat = 0; repeat < 5; ++repeat) {
+            const auto start = clock_type::now();
+            result = static_cast<long long>(run());
+            best = std::min(best, std::chrono::duration<double>(clock_type::now() - start).count());
+        }
+        std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << best * 1e3 << std::setprecision(0) << std::setw(14)
+                  << static_cast<double>(n) / best / 1e6 << std::setw(18) << result << '\n';
+    }
+
+    void title(const char* name) {
+        std::cout << name << '\n'
+                  << std::left << std::setw(28) << "  variante" << std::right << std::setw(10) << "ms"
+                  << std::setw(14) << "M élém./s" << std::setw(18) << "résultat" << '\n';
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 20'000'000;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::mt19937 rng(48);
+    std::uniform_int_distribution<int> value(-40'000, 40'000);   // carrés sans débordement
+    std::vector<int> numbers(n);
+    for (int& x : numbers) x = value(rng);
+
+    const auto even = [](int x) { return x % 2 == 0; };
+    const auto square = [](int x) { return x * x; };
+    auto serial = numbers | std::views::filter(even) | std::views::transform(square);
+
+    pipeline::pool single(1);
+    pipeline::pool all(cores);
+    const auto fused = [&](pipeline::pool& threads) {
+        return pipeline::from(numbers, {.threads = &threads}) | pipeline::filter(even) | pipeline::transform(square);
+    };
+
+    std::cout << n << " entiers, " << cores << " coeurs\n";
+
+    title("to_vector");
+    report("  std::views", n, [&] {
+        std::vector<int> out;
+        for (int x : serial) out.push_back(x);
+        return out.size();
+    });
+    report("  boucle", n, [&] {
+        std::vector<int> out;
+        for (int x : numbers) {
+            if (even(x)) out.push_back(square(x));
+        }
+        return out.size();
+    });
+    report("  pipeline, 1 thread", n, [&] { return (fused(single) | pipeline::to_vector()).size(); });
+    report("  pipeline, tous les coeurs", n, [&] { return (fused(all) | pipeline::to_vector()).size(); });
+
+    title("reduce");
+    report("  std::views", n, [&] {
+        long long sum = 0;
+        for (int x : serial) sum += x;
+        return sum;
+    });
+    report("  boucle", n, [&] {
+        long long sum = 0;
+        for (int x : numbers) {
+            if (even(x)) sum += square(x);
+        }
+        return sum;
+    });
+    report("  pipeline, 1 thread", n, [&] { return fused(single) | pipeline::reduce(0LL); });
+    report("  pipeline, tous les coeurs", n, [&] { return fused(all) | pipeline::reduce(0LL); });
+
+    title("count");
+    report("  std::views", n, [&] { return std::ranges::distance(serial); });
+    report("  boucle", n, [&] {
+        std::size_t count = 0;
+        for (int x : numbers) count += even(x);
+        return count;
+    });
+    report("  pipeline, 1 thread", n, [&] { return fused(single) | pipeline::count(); });
+    report("  pipeline, tous les coeurs", n, [&] { return fused(all) | pipeline::count(); });
+    return 0;
+}
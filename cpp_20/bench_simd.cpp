@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+import Module1;
+
+// Noyaux simd:: de Module1 par type, opération et jeu d'instructions, sur des tableaux de
+// 4096 éléments (taille en argument ; petite pour rester dans le cache, grande pour mesurer la
+// mémoire). Taille volontairement non multiple du vecteur pour passer par la fin masquée.
+// Milliards d'éléments par seconde, meilleur temps sur quelques répétitions ; les jeux
+// absents du processeur sont marqués « - ».
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    constexpr simd::isa all_isas[] = {simd::isa::scalar, simd::isa::avx2, simd::isa::avx512};
+
+    template <typename Run>
+    double elements_per_second(std::size_t n, Run&& run) {
+        const std::size_t repeats = std::max<std::size_t>(1, (std::size_t{1} << 26) / std::max<std::size_t>(n, 1));
+        double best = 1e300;
+        for (int round = 0; round < 5; ++round) {
+            const auto start = clock_type::now();
+            for (std::size_t r = 0; r < repeats; ++r) run();
+            best = std::min(best, std::chrono::duration<double>(clock_type::now() - start).count());
+        }
+        return static_cast<double>(n * repeats) / best;
+    }
+
+    template <typename T>
+    void bench_type(const char* type, std::size_t n) {
+        std::mt19937_64 rng(49);
+        std::vector<T> a(n), b(n), c(n), out(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            a[i] = static_cast<T>(rng() % 100);
+            b[i] = static_cast<T>(rng() % 100);
+            c[i] = static_cast<T>(rng() % 100);
+        }
+        const std::span<const T> x(a), y(b), z(c);
+        const char* ops[] = {"add", "sub", "mul", "fma", "saturating_add"};
+        for (int op = 0; op < 5; ++op) {
+            std::cout << std::left << std::setw(10) << type << std::setw(16) << ops[op] << std::right;
+            for (simd::isa which : all_isas) {
+                if (!simd::supported(which)) {
+                    std::cout << std::setw(12) << "-";
+                    continue;
+                }
+                const double rate = elements_per_second(n, [&] {
+                    switch (op) {
+                        case 0: simd::add<T>(x, y, out, which); break;
+                        case 1: simd::sub<T>(x, y, out, which); break;
+                        case 2: simd::mul<T>(x, y, out, which); break;
+                        case 3: simd::fma<T>(x, y, z, out, which); break;
+                        default: simd::saturating_add<T>(x, y, out, which); break;
+                    }
+                });
+                std::cout << std::fixed << std::setprecision(2) << std::setw(12) << rate / 1e9;
+            }
+            std::cout << '\n';
+        }
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 4096 + 13;
+    std::cout << n << " éléments, jeu choisi : " << simd::name(simd::best()) << ", Gélém./s\n"
+              << std::left << std::setw(10) << "type" << std::setw(16) << "opération" << std::right;
+    for (simd::isa which : all_isas) std::cout << std::setw(12) << simd::name(which);
+    std::cout << '\n';
+
+    bench_type<std::int8_t>("int8", n);
+    bench_type<std::uint8_t>("uint8", n);
+    bench_type<std::int16_t>("int16", n);
+    bench_type<std::int32_t>("int32", n);
+    bench_type<std::uint32_t>("uint32", n);
+    bench_type<std::int64_t>("int64", n);
+    bench_type<float>("float", n);
+    bench_type<double>("double", n);
+    return 0;
+}
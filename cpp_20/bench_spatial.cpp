@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "spatial_index.h"
+
+// Index spatial contre recherche exhaustive sur 1 M points (taille en argument, jusqu'à 100 M
+// si la mémoire le permet : environ 40 octets par point pendant la construction).
+// Construction sur 1 thread puis sur tous les coeurs, puis débit de requêtes boîte (~20 points),
+// disque (~20 points) et 10 plus proches voisins ; la recherche exhaustive ne traite que
+// quelques requêtes, l'index en traite 100 000 une à une puis par lots.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    struct Point {
+        int x, y;
+    };
+
+    double seconds_since(clock_type::time_point start) {
+        return std::chrono::duration<double>(clock_type::now() - start).count();
+    }
+
+    // Requêtes par seconde et nombre moyen de réponses par requête
+    template <typename Run>
+    void report(const char* name, std::size_t queries, Run&& run) {
+        const auto start = clock_type::now();
+        const std::size_t found = run();
+        const double seconds = seconds_since(start);
+        std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << static_cast<double>(queries) / seconds << std::setw(12)
+                  << static_cast<double>(found) / static_cast<double>(queries) << '\n';
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    constexpr int extent = 1'000'000;
+    std::mt19937 rng(41);
+    std::uniform_int_distribution<int> coordinate(-extent, extent);
+
+    // Moitié uniforme, moitié en amas : la hiérarchie doit s'adapter à la densité
+    std::vector<Point> points(n);
+    std::normal_distribution<double> spread(0.0, extent / 100.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i % 2 == 0) {
+            points[i] = {coordinate(rng), coordinate(rng)};
+        } else {
+            const int cluster = static_cast<int>(i / 2 % 64) * (extent / 32) - extent;
+            points[i] = {std::clamp(cluster + static_cast<int>(spread(rng)), -extent, extent),
+                         std::clamp(cluster + static_cast<int>(spread(rng)), -extent, extent)};
+        }
+    }
+
+    std::cout << n << " points, " << cores << " coeurs\n";
+    auto start = clock_type::now();
+    spatial::index index = spatial::index::build(points, 1);
+    std::cout << "construction 1 thread : " << std::setprecision(2) << std::fixed << seconds_since(start) << " s\n";
+    if (cores > 1) {
+        start = clock_type::now();
+        index = spatial::index::build(points, cores);
+        std::cout << "construction " << cores << " threads : " << seconds_since(start) << " s\n";
+    }
+
+    // Côté de boîte et rayon choisis pour ~20 points en zone uniforme
+    const double density = static_cast<double>(n) / 2 / (4.0 * extent * extent);
+    const int half = static_cast<int>(std::sqrt(20.0 / density) / 2);
+    const double radius = std::sqrt(20.0 / density / 3.14159);
+    constexpr std::size_t queries = 100'000;
+    const std::size_t brute_queries = std::max<std::size_t>(1, 20'000'000 / std::max<std::size_t>(n, 1));
+    std::vector<spatial::box> boxes(queries);
+    std::vector<spatial::query_point> centers(queries);
+    for (std::size_t q = 0; q < queries; ++q) {
+        // Centres tirés parmi les points : les requêtes tombent aussi dans les amas
+        const Point& p = points[rng() % n];
+        centers[q] = {p.x, p.y};
+        boxes[q] = {p.x - half, p.y - half, p.x + half, p.y + half};
+    }
+
+    std::cout << std::left << std::setw(28) << "requête" << std::right << std::setw(14) << "requêtes/s"
+              << std::setw(12) << "réponses" << '\n';
+
+    report("boîte : exhaustive", brute_queries, [&] {
+        std::size_t found = 0;
+        for (std::size_t q = 0; q < brute_queries; ++q) {
+            for (const Point& p : points) found += boxes[q].contains(p.x, p.y);
+        }
+        return found;
+    });
+    report("boîte : index", queries, [&] {
+        std::size_t found = 0;
+        for (const auto& b : boxes) index.for_each_in_box(b, [&](std::uint32_t, int, int) { ++found; });
+        return found;
+    });
+    report("boîte : index par lots", queries, [&] { return index.query_boxes(boxes, cores).ids.size(); });
+
+    report("disque : exhaustive", brute_queries, [&] {
+        std::size_t found = 0;
+        for (std::size_t q = 0; q < brute_queries; ++q) {
+            for (const Point& p : points) {
+                const double dx = static_cast<double>(p.x) - centers[q].x, dy = static_cast<double>(p.y) - centers[q].y;
+                found += dx * dx + dy * dy <= radius * radius;
+            }
+        }
+        return found;
+    });
+    report("disque : index", queries, [&] {
+        std::size_t found = 0;
+        for (const auto& c : centers) index.for_each_in_radius(c.x, c.y, radius, [&](std::uint32_t, int, int) { ++found; });
+        return found;
+    });
+    report("disque : index par lots", queries, [&] { return index.query_radii(centers, radius, cores).ids.size(); });
+
+    constexpr std::size_t k = 10;
+    report("10-NN : exhaustive", brute_queries, [&] {
+        std::vector<std::pair<double, std::uint32_t>> best;
+        std::size_t found = 0;
+        for (std::size_t q = 0; q < brute_queries; ++q) {
+            best.clear();
+            for (std::size_t i = 0; i < n; ++i) {
+                const double dx = static_cast<double>(points[i].x) - centers[q].x;
+                const double dy = static_cast<double>(points[i].y) - centers[q].y;
+                const std::pair<double, std::uint32_t> candidate{dx * dx + dy * dy, static_cast<std::uint32_t>(i)};
+                if (best.size() < k) {
+                    best.push_back(candidate);
+                    std::push_heap(best.begin(), best.end());
+                } else if (candidate < best.front()) {
+                    std::pop_heap(best.begin(), best.end());
+                    best.back() = candidate;
+                    std::push_heap(best.begin(), best.end());
+                }
+            }
+            found += best.size();
+        }
+        return found;
+    });
+    report("10-NN : index", queries, [&] {
+        std::size_t found = 0;
+        for (const auto& c : centers) found += index.nearest(c.x, c.y, k).size();
+        return found;
+    });
+    report("10-NN : index par lots", queries, [&] {
+        const auto ids = index.nearest_batch(centers, k, cores);
+        return static_cast<std::size_t>(std::count_if(ids.begin(), ids.end(), [](std::uint32_t id) { return id != spatial::no_point; }));
+    });
+    return 0;
+}
@@ -0,0 +1,440 @@
+#ifndef CPP_20_CHANNEL_H
+#define CPP_20_CHANNEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Canal borné entre coroutines, éventuellement sur plusieurs threads :
+//
+//     coro_channel::executor pool(4);
+//     coro_channel::channel<int> numbers(64, &pool);
+//
+//     coro_channel::detached producer() {
+//         co_await pool.schedule();
+//         for (int i = 0; i < 100; ++i) co_await numbers.send(i);   // suspendue si le canal est plein
+//         numbers.close();
+//     }
+//     coro_channel::detached consumer() {
+//         co_await pool.schedule();
+//         while (auto value = co_await numbers.recv()) use(*value);  // nullopt : fermé et vide
+//     }
+//
+//   - tampon circulaire à numéros de séquence (capacité arrondie à la puissance de deux
+//     supérieure, au moins 2 : avec une seule case, « pleine pour n » et « libre pour n + 1 »
+//     auraient le même numéro) : send et recv ne prennent aucun verrou tant que le canal n'est ni plein ni
+//     vide et que personne n'attend ;
+//   - sinon la coroutine s'inscrit, sous le verrou, dans une file d'attente intrusive (le nœud
+//     vit dans son propre cadre, pas d'allocation) ; celui qui libère une place ou dépose une
+//     valeur fait l'échange pour elle et la reprend, dans l'ordre d'arrivée. Tant que des
+//     coroutines attendent, send et recv passent par le verrou et se placent derrière elles ;
+//     seuls try_send et try_recv peuvent les doubler ;
+//   - T doit se déplacer sans exception : un déplacement qui lève après la réservation d'une
+//     case la laisserait à jamais non publiée et bloquerait le tampon ;
+//   - plusieurs producteurs et consommateurs ; la reprise se fait sur le pool donné au
+//     constructeur, sinon directement dans le thread qui débloque ;
+//   - close() : les envois suivants et les envois en attente rendent false, les réceptions
+//     vident ce qui reste puis rendent nullopt. Fermer après le dernier envoi : un envoi
+//     concurrent de close peut réussir après que les consommateurs sont partis.
+namespace coro_channel {
+
+    // Pool de threads qui reprend des coroutines ; détruit après la fin de toutes ses coroutines
+    class executor {
+    public:
+        explicit executor(unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+            for (unsigned t = 0; t < std::max(1u, threads); ++t) {
+                workers_.emplace_back([this] { work(); });
+            }
+        }
+
+        ~executor() {
+            {
+                std::lock_guard lock(mutex_);
+                stopping_ = true;
+            }
+            ready_.notify_all();
+        }
+
+        executor(const executor&) = delete;
+        executor& operator=(const executor&) = delete;
+
+        void post(std::coroutine_handle<> handle) {
+            {
+                std::lock_guard lock(mutex_);
+                queue_.push_back(handle);
+            }
+            ready_.notify_one();
+        }
+
+        // co_await pool.schedule() : la suite de la coroutine s'exécute sur le pool
+        auto schedule() {
+            struct awaiter {
+                executor& pool;
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> handle) { pool.post(handle); }
+                void await_resume() const noexcept {}
+            };
+            return awaiter{*this};
+        }
+
+        unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    private:
+        void work() {
+            while (true) {
+                std::coroutine_handle<> handle;
+                {
+                    std::unique_lock lock(mutex_);
+                    ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                    if (queue_.empty()) return;
+                    handle = queue_.front();
+                    queue_.pop_front();
+                }
+                handle.resume();
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::deque<std::coroutine_handle<>> queue_;
+        bool stopping_ = false;
+        std::vector<std::jthread> workers_;     // dernier membre : arrêtés avant le reste
+    };
+
+    // Coroutine lancée sans attente de résultat ; se détruit à la fin
+    struct detached {
+        struct promise_type {
+            detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+
+    template <typename T>
+    class channel {
+        static_assert(std::is_nothrow_move_constructible_v<T>, "coro_channel::channel : T doit avoir un déplacement noexcept");
+
+        struct waiter {
+            std::coroutine_handle<> handle;
+            waiter* next = nullptr;
+            T* value = nullptr;                 // envoi : valeur à déposer
+            std::optional<T>* slot = nullptr;   // réception : destination
+            bool ok = false;                    // envoi : valeur déposée
+        };
+
+        struct queue {
+            waiter* head = nullptr;
+            waiter* tail = nullptr;
+
+            void push(waiter* w) {
+                w->next = nullptr;
+                (tail ? tail->next : head) = w;
+                tail = w;
+            }
+
+            waiter* pop() {
+                waiter* w = head;
+                if (w && !(head = w->next)) tail = nullptr;
+                return w;
+            }
+        };
+
+        struct cell {
+            std::atomic<std::size_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T* item() { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+
+    public:
+        class send_awaiter {
+        public:
+            send_awaiter(channel& owner, T value) : owner_(owner), value_(std::move(value)) {}
+
+            bool await_ready() {
+                if (owner_.closed()) return true;
+                if (owner_.has_waiters() || !owner_.push(value_)) return false;
+                node_.ok = true;
+                owner_.balance_if_waiting();
+                return true;
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle) {
+                node_.handle = handle;
+                node_.value = &value_;
+                return owner_.suspend_sender(node_);
+            }
+
+            // false si le canal était fermé (la valeur n'a pas été déposée)
+            bool await_resume() const noexcept { return node_.ok; }
+
+        private:
+            channel& owner_;
+            T value_;
+            waiter node_;
+        };
+
+        class recv_awaiter {
+        public:
+            explicit recv_awaiter(channel& owner) : owner_(owner) {}
+
+            bool await_ready() {
+                if (!owner_.has_waiters() && owner_.pop(result_)) {
+                    owner_.balance_if_waiting();
+                    return true;
+                }
+                if (!owner_.closed()) return false;
+                owner_.pop(result_);        // fermé : ce qui reste, sinon nullopt
+                return true;
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle) {
+                node_.handle = handle;
+                node_.slot = &result_;
+                return owner_.suspend_receiver(node_);
+            }
+
+            std::optional<T> await_resume() { return std::move(result_); }
+
+        private:
+            channel& owner_;
+            std::optional<T> result_;
+            waiter node_;
+        };
+
+        explicit channel(std::size_t capacity, executor* resume_on = nullptr)
+                : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+                  cells_(std::make_unique<cell[]>(mask_ + 1)),
+                  resume_on_(resume_on) {
+            for (std::size_t i = 0; i <= mask_; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        ~channel() {
+            std::optional<T> rest;
+            while (pop(rest)) rest.reset();
+        }
+
+        channel(const channel&) = delete;
+        channel& operator=(const channel&) = delete;
+
+        std::size_t capacity() const { return mask_ + 1; }
+
+        bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+        // co_await channel.send(v) -> bool
+        send_awaiter send(T value) { return send_awaiter(*this, std::move(value)); }
+
+        // co_await channel.recv() -> std::optional<T>
+        recv_awaiter recv() { return recv_awaiter(*this); }
+
+        // Sans suspension : false si plein ou fermé (value est alors intacte). Sans verrou, peut
+        // passer devant des envois en attente
+        bool try_send(T& value) {
+            if (closed() || !push(value)) return false;
+            balance_if_waiting();
+            return true;
+        }
+
+        // Sans suspension ni verrou : nullopt si vide ; peut passer devant des réceptions en attente
+        std::optional<T> try_recv() {
+            std::optional<T> result;
+            if (pop(result)) balance_if_waiting();
+            return result;
+        }
+
+        void close() {
+            queue ready;
+            executor* const target = resume_on_;
+            {
+                std::lock_guard lock(mutex_);
+                if (closed_.exchange(true, std::memory_order_acq_rel)) return;
+                balance(ready);
+                // Plus de place pour les envois en attente ; les réceptions en attente trouvent un canal vide
+                while (waiter* w = senders_.pop()) wake_later(w, ready);
+                while (waiter* w = receivers_.pop()) wake_later(w, ready);
+                waiting_.store(0, std::memory_order_relaxed);
+            }
+            resume_all(target, ready);
+        }
+
+    private:
+        // Tampon de Vyukov : une case est libre pour l'envoi n quand sa séquence vaut n,
+        // pleine pour la réception n quand elle vaut n + 1
+        bool push(T& value) {
+            std::size_t position = enqueue_.load(std::memory_order_relaxed);
+            while (true) {
+                cell& c = cells_[position & mask_];
+                const std::size_t sequence = c.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(sequence - position);
+                if (diff == 0) {
+                    if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        ::new (static_cast<void*>(c.storage)) T(std::move(value));
+                        c.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    position = enqueue_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool pop(std::optional<T>& out) {
+            std::size_t position = dequeue_.load(std::memory_order_relaxed);
+            while (true) {
+                cell& c = cells_[position & mask_];
+                const std::size_t sequence = c.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+                if (diff == 0) {
+                    if (dequeue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        T* item = c.item();
+                        out.emplace(std::move(*item));
+                        item->~T();
+                        c.sequence.store(position + mask_ + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    position = dequeue_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Des coroutines attendent : send et recv ne doivent pas les doubler par le chemin sans verrou
+        bool has_waiters() const { return waiting_.load(std::memory_order_acquire) != 0; }
+
+        // Après un dépôt ou un retrait sans verrou : la barrière ordonne la case modifiée avant
+        // la lecture de waiting_, comme l'inscription d'un attendant avant sa dernière tentative
+        void balance_if_waiting() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting_.load(std::memory_order_relaxed) == 0) return;
+            queue ready;
+            executor* const target = resume_on_;
+            {
+                std::lock_guard lock(mutex_);
+                balance(ready);
+            }
+            resume_all(target, ready);
+        }
+
+        // Sous le verrou : échanges pour le compte des attendants tant qu'il y a de la place ou des valeurs
+        void balance(queue& ready) {
+            bool progress = true;
+            while (progress) {
+                progress = false;
+                while (receivers_.head && pop(*receivers_.head->slot)) {
+                    wake_later(receivers_.pop(), ready);
+                    waiting_.fetch_sub(1, std::memory_order_relaxed);
+                    progress = true;
+                }
+                while (senders_.head && push(*senders_.head->value)) {
+                    waiter* w = senders_.pop();
+                    w->ok = true;
+                    wake_later(w, ready);
+                    waiting_.fetch_sub(1, std::memory_order_relaxed);
+                    progress = true;
+                }
+            }
+        }
+
+        // false : pas de suspension (valeur déposée ou canal fermé). Les envois déjà inscrits
+        // passent d'abord : on ne dépose que derrière une file vide. Une fois le nœud inscrit et le
+        // verrou relâché, la coroutine peut être reprise ailleurs et détruire le canal : seules
+        // des variables locales servent ensuite.
+        bool suspend_sender(waiter& node) {
+            queue ready;
+            executor* const target = resume_on_;
+            bool suspended = false;
+            {
+                std::lock_guard lock(mutex_);
+                waiting_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (closed_.load(std::memory_order_relaxed)) {
+                    waiting_.fetch_sub(1, std::memory_order_relaxed);
+                    return false;
+                }
+                balance(ready);
+                if (!senders_.head && push(*node.value)) {
+                    waiting_.fetch_sub(1, std::memory_order_relaxed);
+                    node.ok = true;
+                    balance(ready);
+                } else {
+                    senders_.push(&node);
+                    suspended = true;
+                }
+            }
+            resume_all(target, ready);
+            return suspended;
+        }
+
+        bool suspend_receiver(waiter& node) {
+            queue ready;
+            executor* const target = resume_on_;
+            bool suspended = false;
+            {
+                std::lock_guard lock(mutex_);
+                waiting_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                balance(ready);
+                if (!receivers_.head && pop(*node.slot)) {
+                    waiting_.fetch_sub(1, std::memory_order_relaxed);
+                    balance(ready);
+                } else if (closed_.load(std::memory_order_relaxed)) {
+                    waiting_.fetch_sub(1, std::memory_order_relaxed);
+                } else {
+                    receivers_.push(&node);
+                    suspended = true;
+                }
+            }
+            resume_all(target, ready);
+            return suspended;
+        }
+
+        // Coroutines à reprendre une fois le verrou relâché, dans l'ordre des échanges
+        static void wake_later(waiter* w, queue& ready) { ready.push(w); }
+
+        // Une coroutine reprise peut finir et détruire le canal : l'exécuteur est lu par
+        // l'appelant avant, aucun membre n'est lu ici
+        static void resume_all(executor* target, queue& ready) {
+            while (waiter* w = ready.pop()) {
+                const std::coroutine_handle<> handle = w->handle;
+                if (target) {
+                    target->post(handle);
+                } else {
+                    handle.resume();
+                }
+            }
+        }
+
+        const std::size_t mask_;
+        std::unique_ptr<cell[]> cells_;
+        executor* resume_on_;
+        alignas(64) std::atomic<std::size_t> enqueue_{0};
+        alignas(64) std::atomic<std::size_t> dequeue_{0};
+        alignas(64) std::atomic<std::size_t> waiting_{0};    // attendants inscrits (envois + réceptions)
+        std::atomic<bool> closed_{false};
+        std::mutex mutex_;
+        queue senders_;
+        queue receivers_;
+    };
+
+}  // namespace coro_channel
+
+#endif //CPP_20_CHANNEL_H
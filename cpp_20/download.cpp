@@ -1,3 +1,4 @@
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -6,6 +7,12 @@
 #include <thread>
 #include <memory>
 #include <curl/curl.h>
+#include "async_log.h"
+#include "runtime_metrics.h"
+#include "coro_trace.h"
+
+// Téléchargements lancés / terminés, durée des suspensions et durée de vie des coroutines
+runtime_metrics::coroutine_metrics download_metrics("download_file_async");
 
 // Awaitable pour gérer le téléchargement asynchrone
 class DownloadAwaitable {
@@ -15,11 +22,13 @@ public:
 
     bool await_ready() const noexcept { return false; } // Toujours suspendre la coroutine
     void await_suspend(std::coroutine_handle<> handle) {
+        suspended_at_ = runtime_metrics::now_ns();
+        trace_.suspend(handle);
         // Lancer le téléchargement dans un thread séparé
         std::thread([this, handle]() {
             bool success = download_file();
             if (!success) {
-                std::cerr << "Échec du téléchargement pour l'URL : " << url_ << std::endl;
+                async_log::error("Échec du téléchargement pour l'URL : {}", url_);
             }
             handle.resume(); // Reprendre la coroutine après le téléchargement
         }).detach();
@@ -32,6 +41,8 @@ public:
     }
     void await_resume() const noexcept {
         // Peut gérer les erreurs ici si nécessaire
+        trace_.resume();
+        download_metrics.on_resume(runtime_metrics::now_ns() - suspended_at_);
     }
 
 private:
@@ -41,7 +52,7 @@ private:
         std::ofstream output_file(output_path_, std::ios::binary);
 
         if (!output_file.is_open()) {
-            std::cerr << "Erreur : Impossible d'ouvrir le fichier en écriture : " << output_path_ << std::endl;
+            async_log::error("Erreur : Impossible d'ouvrir le fichier en écriture : {}", output_path_);
             return false;
         }
 
@@ -55,7 +66,7 @@ private:
             curl_easy_cleanup(curl);
 
             if (res != CURLE_OK) {
-                std::cerr << "Erreur lors du téléchargement : " << curl_easy_strerror(res) << std::endl;
+                async_log::error("Erreur lors du téléchargement : {}", curl_easy_strerror(res));
                 return false;
             }
 
@@ -72,6 +83,8 @@ private:
 
     std::string url_;
     std::string output_path_;
+    std::uint64_t suspended_at_ = 0;
+    [[no_unique_address]] coro_trace::frame_slot trace_;
 };
 
 // Classe de gestion de coroutine avec un `promise_type` et `std::shared_ptr`
@@ -80,24 +93,55 @@ struct AsyncTask {
     using handle_type = std::coroutine_handle<promise_type>;
 
     std::shared_ptr<handle_type> coro;
+    std::shared_ptr<std::atomic<bool>> finished;  // Levé quand la coroutine est suspendue à la fin
 
-    AsyncTask(handle_type h) : coro(std::make_shared<handle_type>(h)) {}
+    AsyncTask(handle_type h) : coro(std::make_shared<handle_type>(h)), finished(h.promise().finished) {}
     ~AsyncTask() {
-        if (coro && coro->done()) coro->destroy();
+        if (coro && coro.use_count() == 1 && finished->load(std::memory_order_acquire)) coro->destroy();
     }
 
+    // Attend la fin du téléchargement (la coroutine reprend sur le thread de curl)
+    void wait() const { finished->wait(false, std::memory_order_acquire); }
+
     void start() {
         if (coro && !coro->done()) {
+            coro_trace::resumed(coro->address());
             coro->resume();
         }
     }
 
     struct promise_type {
+        std::uint64_t created_at = runtime_metrics::now_ns();
+        std::shared_ptr<std::atomic<bool>> finished = std::make_shared<std::atomic<bool>>(false);
+
+        // Lève `finished` une fois la coroutine suspendue : la frame peut alors être détruite
+        struct final_awaiter {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(handle_type h) const noexcept {
+                const auto flag = h.promise().finished;  // Copie : la frame peut disparaître dès le store
+                flag->store(true, std::memory_order_release);
+                flag->notify_all();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        promise_type() {
+            download_metrics.on_start();
+            coro_trace::created(coro_trace::frame_of(*this), "download_file_async");
+        }
+
         auto get_return_object() {
             return AsyncTask{handle_type::from_promise(*this)};
         }
-        std::suspend_always initial_suspend() noexcept { return {}; }
-        std::suspend_never final_suspend() noexcept { return {}; }
+        std::suspend_always initial_suspend() noexcept {
+            coro_trace::suspended(coro_trace::frame_of(*this));
+            return {};
+        }
+        final_awaiter final_suspend() noexcept {
+            download_metrics.on_complete(runtime_metrics::now_ns() - created_at);
+            coro_trace::completed(coro_trace::frame_of(*this));
+            return {};
+        }
 
         void return_void() {}
         void unhandled_exception() { std::exit(1); }
@@ -107,10 +151,12 @@ struct AsyncTask {
 // Coroutine pour télécharger un fichier de manière asynchrone
 AsyncTask download_file_async(const std::string& url, const std::string& output_path) {
     co_await DownloadAwaitable(url, output_path);
-    std::cout << "Téléchargement terminé : " << output_path << std::endl;
+    async_log::info("Téléchargement terminé : {}", output_path);
 }
 
 int main() {
+    async_log::session logging;  // Journal asynchrone, vidé à la sortie de main
+
     // Initialiser libcurl
     curl_global_init(CURL_GLOBAL_DEFAULT);
 
@@ -135,9 +181,15 @@ int main() {
 
 
 
-    // Attendre que tous les téléchargements soient terminés
-    // Pour cet exemple, on utilise sleep, mais idéalement, vous utiliseriez une synchronisation appropriée
-    std::this_thread::sleep_for(std::chrono::seconds(5));
+    // Attendre que tous les téléchargements soient terminés avant d'exporter les métriques
+    for (const auto& task : tasks) {
+        task.wait();
+    }
+
+    // Instantané au format texte de Prometheus
+    runtime_metrics::write_file("download.prom", runtime_metrics::to_prometheus(download_metrics.snapshot()));
+    // Chronologie des coroutines (compilé avec -DCORO_TRACE=1)
+    coro_trace::write_chrome_json("download.trace.json");
 
     // Nettoyer libcurl
     curl_global_cleanup();
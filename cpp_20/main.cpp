@@ -4,6 +4,8 @@
 #include <iostream>
 #include <vector>
 #include <ranges>
+#include "spatial_index.h"
+#include "parallel_pipeline.h"
 import Module1;
 //1. concepts
 template <typename T>
@@ -18,13 +20,8 @@ T add(T a, T b) {
 //2. spaceship operator
 struct Point {
     int x, y;
-    auto operator<=>(const Point& point) const  {
-        if(point.x < x) {
-            return std::partial_ordering::greater;
-        }else {
-            return std::partial_ordering::less;
-        }
-    };
+    // Total order: x first, then y (equal points compare equivalent)
+    auto operator<=>(const Point& point) const = default;
 };
 
 
@@ -38,12 +35,22 @@ int main() {
     auto result = add(10, 30);
     std::cout << result << '\n';
     Module1:add(10,30);
+    // Element-wise add over arrays, vectorized for the best instruction set found at run time
+    std::vector<int> lhs{1, 2, 3}, rhs{10, 20, 30}, sums(lhs.size());
+    simd::add<int>(lhs, rhs, sums);
+    std::cout << sums[2] << " (" << simd::name(simd::best()) << ")\n";
     //2. spaceship operator
     Point p1{x:20, y:10};
     Point p2{x:20, y:30};
 
     std::cout << (p1 > p2) << '\n';
 
+    // Spatial lookups go through an index instead of scanning and comparing Points
+    std::vector<Point> cloud{p1, p2, {0, 0}, {25, 12}, {-5, 40}};
+    const auto index = spatial::index::build(cloud);
+    for (auto id : index.query_box({15, 5, 30, 15})) std::cout << "in box: " << id << '\n';
+    for (auto id : index.nearest(21, 11, 2)) std::cout << "nearest: " << id << '\n';
+
     constexpr int value = square(30);
     std::cout << value << '\n';
 
@@ -53,6 +60,14 @@ int main() {
                        | std::views::filter([](int x) {return x % 2 == 0;})
                        | std::views::transform([](int x)  {return  x*x;});
 
+    // Same chain, fused into one loop per chunk and run on the thread pool
+    auto even_square_par = pipeline::from(numbers)
+                           | pipeline::filter([](int x) {return x % 2 == 0;})
+                           | pipeline::transform([](int x) {return x*x;});
+    for (int x : even_square_par | pipeline::to_vector()) std::cout << x << ' ';
+    std::cout << "sum: " << (even_square_par | pipeline::reduce(0LL)) << ", count: "
+              << (even_square_par | pipeline::count()) << '\n';
+
     return 0;
 }
 
@@ -0,0 +1,395 @@
+#ifndef CPP_20_PARALLEL_PIPELINE_H
+#define CPP_20_PARALLEL_PIPELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Pipelines façon std::views, exécutés en parallèle sur une source contiguë :
+//
+//     auto even_square = pipeline::from(numbers)
+//                        | pipeline::filter([](int x) { return x % 2 == 0; })
+//                        | pipeline::transform([](int x) { return x * x; });
+//     std::vector<int> squares = even_square | pipeline::to_vector();
+//     long long total = even_square | pipeline::reduce(0LL, std::plus<>{});
+//     std::size_t n = even_square | pipeline::count();
+//
+//   - les étapes sont fusionnées à la compilation : une seule boucle par tranche, sans
+//     itérateur intermédiaire ni valeur stockée entre deux étapes ;
+//   - la source est découpée en tranches (16 Ki éléments par défaut) prises dynamiquement par
+//     les threads d'un pool (le thread appelant participe) ;
+//   - to_vector avec des filtres : une première passe compte les survivants de chaque tranche
+//     (sans les étapes qui suivent le dernier filtre), une somme préfixe donne la position de
+//     chaque tranche, la seconde passe écrit directement à sa place, dans l'ordre de la source.
+//     Sans filtre, chaque élément va à son indice ;
+//   - reduce, comme std::reduce, suppose l'opération associative et homogène : op(R, R),
+//     op(R, élément) et la conversion élément -> R doivent avoir le même sens, car chaque tranche
+//     part de son premier élément et les sommes partielles sont combinées par op. Une opération
+//     comme « acc + x * x » est fausse ici : mettre x * x dans un transform, puis reduce(0LL) ;
+//     les tranches sont combinées dans l'ordre ;
+//   - la source doit survivre au pipeline : from() refuse un std::vector temporaire.
+namespace pipeline {
+
+    // Pool de threads pour les boucles parallèles : une boucle à la fois (les appels
+    // concurrents attendent leur tour), un appel depuis une tâche du pool s'exécute en série
+    class pool {
+    public:
+        explicit pool(unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+            for (unsigned t = 1; t < std::max(1u, threads); ++t) {
+                workers_.emplace_back([this] { work(); });
+            }
+        }
+
+        ~pool() {
+            {
+                std::lock_guard lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+        }
+
+        pool(const pool&) = delete;
+        pool& operator=(const pool&) = delete;
+
+        static pool& shared() {
+            static pool instance;
+            return instance;
+        }
+
+        unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+        // f(i) pour i dans [0, tasks), réparti dynamiquement ; la première exception est relancée ici
+        template <typename F>
+        void parallel_for(std::size_t tasks, F&& f) {
+            if (tasks == 0) return;
+            if (inside_task() || workers_.empty() || tasks == 1) {
+                for (std::size_t i = 0; i < tasks; ++i) f(i);
+                return;
+            }
+            std::lock_guard serial(submit_);
+            {
+                std::lock_guard lock(mutex_);
+                context_ = &f;
+                invoke_ = [](void* context, std::size_t i) { (*static_cast<std::remove_reference_t<F>*>(context))(i); };
+                tasks_ = tasks;
+                next_.store(0, std::memory_order_relaxed);
+                active_ = workers_.size();
+                error_ = nullptr;
+                ++generation_;
+            }
+            wake_.notify_all();
+            participate();
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [this] { return active_ == 0; });
+            if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+
+    private:
+        static bool& inside_task() {
+            thread_local bool inside = false;
+            return inside;
+        }
+
+        void participate() {
+            inside_task() = true;
+            try {
+                for (std::size_t i; (i = next_.fetch_add(1, std::memory_order_relaxed)) < tasks_;) invoke_(context_, i);
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+                next_.store(tasks_, std::memory_order_relaxed);  // les tâches restantes sont abandonnées
+            }
+            inside_task() = false;
+        }
+
+        void work() {
+            std::uint64_t seen = 0;
+            while (true) {
+                {
+                    std::unique_lock lock(mutex_);
+                    wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                    if (stopping_) return;
+                    seen = generation_;
+                }
+                participate();
+                std::lock_guard lock(mutex_);
+                if (--active_ == 0) done_.notify_one();
+            }
+        }
+
+        std::mutex submit_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        std::uint64_t generation_ = 0;
+        bool stopping_ = false;
+        void* context_ = nullptr;
+        void (*invoke_)(void*, std::size_t) = nullptr;
+        std::size_t tasks_ = 0;
+        std::atomic<std::size_t> next_{0};
+        std::size_t active_ = 0;
+        std::exception_ptr error_;
+        std::vector<std::jthread> workers_;     // dernier membre : arrêtés avant le reste
+    };
+
+    struct settings {
+        std::size_t chunk = 16 * 1024;          // éléments par tranche
+        pool* threads = nullptr;                // nullptr : pool::shared()
+    };
+
+    namespace detail {
+
+        template <typename F>
+        struct filter_stage {
+            F predicate;
+        };
+
+        template <typename F>
+        struct transform_stage {
+            F function;
+        };
+
+        template <typename T>
+        struct is_filter : std::false_type {};
+        template <typename F>
+        struct is_filter<filter_stage<F>> : std::true_type {};
+
+        // Type produit par une étape pour une entrée V
+        template <typename Stage, typename V>
+        struct stage_output;
+        template <typename F, typename V>
+        struct stage_output<filter_stage<F>, V> {
+            using type = V;
+        };
+        template <typename F, typename V>
+        struct stage_output<transform_stage<F>, V> {
+            using type = std::invoke_result_t<const F&, V>;
+        };
+
+        // Type produit après les étapes [I, fin) pour une entrée V
+        template <std::size_t I, typename Stages, typename V>
+        struct output {
+            using type = V;
+        };
+        template <std::size_t I, typename Stages, typename V>
+            requires (I < std::tuple_size_v<Stages>)
+        struct output<I, Stages, V> {
+            using type = typename output<I + 1, Stages,
+                    typename stage_output<std::tuple_element_t<I, Stages>, V>::type>::type;
+        };
+
+        template <typename Stages, std::size_t I = std::tuple_size_v<Stages>>
+        constexpr std::size_t filters_end() {
+            if constexpr (I == 0) {
+                return 0;
+            } else if constexpr (is_filter<std::tuple_element_t<I - 1, Stages>>::value) {
+                return I;
+            } else {
+                return filters_end<Stages, I - 1>();
+            }
+        }
+
+        // Étapes [I, End) appliquées à une valeur, puis sink : tout est développé en ligne
+        template <std::size_t I, std::size_t End, typename Stages, typename V, typename Sink>
+        inline void apply(const Stages& stages, V&& value, Sink& sink) {
+            if constexpr (I == End) {
+                sink(std::forward<V>(value));
+            } else {
+                const auto& stage = std::get<I>(stages);
+                if constexpr (is_filter<std::remove_cvref_t<decltype(stage)>>::value) {
+                    if (std::invoke(stage.predicate, std::as_const(value))) {
+                        apply<I + 1, End>(stages, std::forward<V>(value), sink);
+                    }
+                } else {
+                    apply<I + 1, End>(stages, std::invoke(stage.function, std::forward<V>(value)), sink);
+                }
+            }
+        }
+
+    }  // namespace detail
+
+    template <typename T, typename... Stages>
+    class chain {
+    public:
+        using stages_type = std::tuple<Stages...>;
+        using value_type = std::remove_cvref_t<typename detail::output<0, stages_type, const T&>::type>;
+        static constexpr bool filtered = (detail::is_filter<Stages>::value || ...);
+
+        chain(std::span<const T> source, stages_type stages, settings config)
+                : source_(source), stages_(std::move(stages)), config_(config) {}
+
+        template <typename Stage>
+        chain<T, Stages..., Stage> then(Stage stage) const {
+            return {source_, std::tuple_cat(stages_, std::tuple<Stage>(std::move(stage))), config_};
+        }
+
+        // sink(valeur) pour chaque élément produit par la tranche `index`, dans l'ordre
+        template <std::size_t End = sizeof...(Stages), typename Sink>
+        void run_chunk(std::size_t index, Sink& sink) const {
+            const std::size_t begin = index * chunk_size(), end = std::min(source_.size(), begin + chunk_size());
+            for (std::size_t i = begin; i < end; ++i) detail::apply<0, End>(stages_, source_[i], sink);
+        }
+
+        std::size_t chunk_size() const { return std::max<std::size_t>(config_.chunk, 1); }
+        std::size_t chunks() const { return (source_.size() + chunk_size() - 1) / chunk_size(); }
+        std::size_t source_size() const { return source_.size(); }
+        pool& threads() const { return config_.threads ? *config_.threads : pool::shared(); }
+
+        static constexpr std::size_t filters_end = detail::filters_end<stages_type>();
+
+    private:
+        std::span<const T> source_;
+        stages_type stages_;
+        settings config_;
+    };
+
+    template <typename T>
+    chain<T> from(std::span<const T> source, settings config = {}) {
+        return {source, {}, config};
+    }
+
+    template <typename T>
+    chain<T> from(const std::vector<T>& source, settings config = {}) {
+        return {std::span<const T>(source), {}, config};
+    }
+
+    // La chaîne ne garde qu'un std::span : un temporaire serait détruit avant le calcul
+    template <typename T>
+    chain<T> from(std::vector<T>&& source, settings config = {}) = delete;
+
+    template <typename F>
+    detail::filter_stage<F> filter(F predicate) {
+        return {std::move(predicate)};
+    }
+
+    template <typename F>
+    detail::transform_stage<F> transform(F function) {
+        return {std::move(function)};
+    }
+
+    template <typename T, typename... Stages, typename F>
+    auto operator|(const chain<T, Stages...>& c, detail::filter_stage<F> stage) {
+        return c.then(std::move(stage));
+    }
+
+    template <typename T, typename... Stages, typename F>
+    auto operator|(const chain<T, Stages...>& c, detail::transform_stage<F> stage) {
+        return c.then(std::move(stage));
+    }
+
+    // Opérations terminales
+
+    struct to_vector_op {};
+    struct count_op {};
+    template <typename R, typename Op>
+    struct reduce_op {
+        R init;
+        Op op;
+    };
+
+    inline to_vector_op to_vector() { return {}; }
+    inline count_op count() { return {}; }
+    template <typename R, typename Op = std::plus<>>
+    reduce_op<R, Op> reduce(R init, Op op = {}) {
+        return {std::move(init), std::move(op)};
+    }
+
+    template <typename T, typename... Stages>
+    std::size_t operator|(const chain<T, Stages...>& c, count_op) {
+        using chain_type = chain<T, Stages...>;
+        if constexpr (!chain_type::filtered) {
+            return c.source_size();
+        } else {
+            std::vector<std::size_t> counts(c.chunks());
+            c.threads().parallel_for(c.chunks(), [&](std::size_t index) {
+                std::size_t n = 0;
+                auto sink = [&n](auto&&) { ++n; };
+                c.template run_chunk<chain_type::filters_end>(index, sink);
+                counts[index] = n;
+            });
+            std::size_t total = 0;
+            for (std::size_t n : counts) total += n;
+            return total;
+        }
+    }
+
+    template <typename T, typename... Stages, typename R, typename Op>
+    R operator|(const chain<T, Stages...>& c, const reduce_op<R, Op>& r) {
+        using value_type = typename chain<T, Stages...>::value_type;
+        static_assert(std::is_invocable_r_v<R, const Op&, R, R> && std::is_invocable_r_v<R, const Op&, R, value_type> &&
+                          std::is_convertible_v<value_type, R>,
+                      "pipeline::reduce : l'opération doit être homogène, comme pour std::reduce");
+        // Une somme partielle par tranche (absente si la tranche est vide), combinées dans l'ordre
+        std::vector<R> partial(c.chunks());
+        std::vector<char> present(c.chunks(), 0);
+        c.threads().parallel_for(c.chunks(), [&](std::size_t index) {
+            bool any = false;
+            R accumulator{};
+            auto sink = [&](auto&& value) {
+                if (any) {
+                    accumulator = std::invoke(r.op, std::move(accumulator), std::forward<decltype(value)>(value));
+                } else {
+                    accumulator = static_cast<R>(std::forward<decltype(value)>(value));
+                    any = true;
+                }
+            };
+            c.run_chunk(index, sink);
+            if (any) {
+                partial[index] = std::move(accumulator);
+                present[index] = 1;
+            }
+        });
+        R result = r.init;
+        for (std::size_t i = 0; i < partial.size(); ++i) {
+            if (present[i]) result = std::invoke(r.op, std::move(result), std::move(partial[i]));
+        }
+        return result;
+    }
+
+    template <typename T, typename... Stages>
+    auto operator|(const chain<T, Stages...>& c, to_vector_op) {
+        using chain_type = chain<T, Stages...>;
+        using value_type = typename chain_type::value_type;
+        std::vector<value_type> out;
+        if constexpr (!chain_type::filtered) {
+            // Pas de filtre : un élément par élément source, à son indice
+            out.resize(c.source_size());
+            c.threads().parallel_for(c.chunks(), [&](std::size_t index) {
+                value_type* target = out.data() + index * c.chunk_size();
+                auto sink = [&target](auto&& value) { *target++ = std::forward<decltype(value)>(value); };
+                c.run_chunk(index, sink);
+            });
+        } else {
+            // 1. Survivants par tranche, 2. somme préfixe, 3. écriture à la position de la tranche
+            std::vector<std::size_t> offsets(c.chunks() + 1, 0);
+            c.threads().parallel_for(c.chunks(), [&](std::size_t index) {
+                std::size_t n = 0;
+                auto sink = [&n](auto&&) { ++n; };
+                c.template run_chunk<chain_type::filters_end>(index, sink);
+                offsets[index + 1] = n;
+            });
+            for (std::size_t i = 1; i < offsets.size(); ++i) offsets[i] += offsets[i - 1];
+            out.resize(offsets.back());
+            c.threads().parallel_for(c.chunks(), [&](std::size_t index) {
+                value_type* target = out.data() + offsets[index];
+                auto sink = [&target](auto&& value) { *target++ = std::forward<decltype(value)>(value); };
+                c.run_chunk(index, sink);
+            });
+        }
+        return out;
+    }
+
+}  // namespace pipeline
+
+#endif //CPP_20_PARALLEL_PIPELINE_H
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <coroutine>
 #include <memory>
+#include "coro_trace.h"
 
 // Classe Generator pour produire une séquence de valeurs
 template<typename T>
@@ -9,16 +10,25 @@ public:
     struct promise_type {
         T current_value;
 
+        promise_type() { coro_trace::created(coro_trace::frame_of(*this), "Generator"); }
+
         Generator get_return_object() {
             return Generator{std::coroutine_handle<promise_type>::from_promise(*this)};
         }
 
-        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always initial_suspend() noexcept {
+            coro_trace::suspended(coro_trace::frame_of(*this));
+            return {};
+        }
 
-        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept {
+            coro_trace::completed(coro_trace::frame_of(*this));
+            return {};
+        }
 
         std::suspend_always yield_value(T value) noexcept {
             current_value = value;
+            coro_trace::suspended(coro_trace::frame_of(*this));
             return {};
         }
 
@@ -56,6 +66,7 @@ public:
     // Méthode pour obtenir la prochaine valeur générée
     bool next() {
         if (handle_) {
+            coro_trace::resumed(handle_.address());
             handle_.resume();
             return !handle_.done();
         }
@@ -89,5 +100,8 @@ int main() {
 
     std::cout << "Générateur épuisé\n";
 
+    // Chronologie pour chrome://tracing ou ui.perfetto.dev (compilé avec -DCORO_TRACE=1)
+    coro_trace::write_chrome_json("generator.trace.json");
+
     return 0;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <thread>
 #include <chrono>
 #include <memory>
+#include "async_log.h"
 
 // Awaitable pour simuler un délai asynchrone
 struct Awaitable {
@@ -41,13 +42,15 @@ struct AsyncTask {
 };
 
 // Coroutine `fetch_data` pour simuler une requête réseau avec délai
-AsyncTask fetch_data(const std::string& source) {
-    std::cout << "Démarrage de la récupération de données depuis : " << source << std::endl;
+// (source par valeur : elle sert encore après la reprise sur un autre thread)
+AsyncTask fetch_data(std::string source) {
+    async_log::info("Démarrage de la récupération de données depuis : {}", source);
     co_await Awaitable{2, source};  // Attente simulée de 2 secondes
-    std::cout << "Données reçues de " << source << std::endl;
+    async_log::info("Données reçues de {}", source);
 }
 
 int main() {
+    async_log::session logging;  // Journal asynchrone, vidé à la sortie de main
     fetch_data("Source1");
     std::this_thread::sleep_for(std::chrono::seconds(3));  // Maintenir le programme actif pour observer l'exécution
     return 0;
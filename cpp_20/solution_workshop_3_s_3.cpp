@@ -1,55 +1,45 @@
+#include <atomic>
 #include <iostream>
 #include <coroutine>
 #include <string>
 #include <vector>
 #include <thread>
 #include <chrono>
+#include <latch>
 #include <memory>
+#include "async_log.h"
+#include "runtime_metrics.h"
+#include "coro_trace.h"
+#include "fetch_task.h"
+#include "channel.h"
 
-// Awaitable personnalisé pour simuler une attente asynchrone
-struct Awaitable {
-    bool await_ready() const noexcept { return false; }  // La coroutine n'est pas prête immédiatement
-    void await_suspend(std::coroutine_handle<> handle) const {
-        std::thread([handle]() {
-            std::this_thread::sleep_for(std::chrono::seconds(2));  // Délai simulé de 2 secondes
-            handle.resume();  // Reprend la coroutine après l'attente
-        }).detach();
-    }
-    void await_resume() const noexcept {}  // Ne fait rien lors de la reprise
-};
-
-// Classe de gestion de coroutine avec un `promise_type`
-struct AsyncTask {
-    struct promise_type;
-    using handle_type = std::coroutine_handle<promise_type>;
-
-    std::shared_ptr<handle_type> coro;  // Utilisation de shared_ptr pour une gestion de mémoire sécurisée
-
-    AsyncTask(handle_type h) : coro(std::make_shared<handle_type>(h)) {}
-    ~AsyncTask() { if (coro && coro->done()) coro->destroy(); }
-
-    std::string get() { return coro->promise().result; }
-
-    struct promise_type {
-        std::string result;
+// AsyncTask et la coroutine fetch_data (délai simulé de 2 secondes) : common/fetch_task.h
+using fetch_task::AsyncTask;
+using fetch_task::fetch_data;
 
-        auto get_return_object() { return AsyncTask{handle_type::from_promise(*this)}; }
-        auto initial_suspend() { return std::suspend_never{}; }  // Ne suspend pas immédiatement
-        auto final_suspend() noexcept { return std::suspend_always{}; }  // Suspend après le retour
+// Chaîne requêtes -> étiquetage -> journal, chaque étape sur le pool, reliées par des canaux bornés
+coro_channel::detached send_requests(coro_channel::executor& pool, coro_channel::channel<std::string>& out,
+                                     const std::vector<std::string>& requests) {
+    co_await pool.schedule();
+    for (const auto& request : requests) co_await out.send(request);  // suspendue si le canal est plein
+    out.close();
+}
 
-        void return_value(std::string value) { result = std::move(value); }
-        void unhandled_exception() { std::exit(1); }
-    };
-};
+coro_channel::detached label(coro_channel::executor& pool, coro_channel::channel<std::string>& in,
+                             coro_channel::channel<std::string>& out) {
+    co_await pool.schedule();
+    while (auto request = co_await in.recv()) co_await out.send("Traité : " + *request);
+    out.close();
+}
 
-// Coroutine pour simuler la récupération de données de manière asynchrone
-AsyncTask fetch_data(const std::string& request) {
-    std::cout << "Traitement de la requête : " << request << std::endl;
-    co_await Awaitable{};  // Simule une attente non bloquante
-    co_return "Données reçues pour : " + request;  // Retourne le résultat
+coro_channel::detached log_all(coro_channel::executor& pool, coro_channel::channel<std::string>& in, std::latch& done) {
+    co_await pool.schedule();
+    while (auto line = co_await in.recv()) async_log::info("{}", *line);
+    done.count_down();
 }
 
 int main() {
+    async_log::session logging;  // Journal asynchrone, vidé à la sortie de main
     std::vector<std::string> requests = {"Request1", "Request2", "Request3"};
     std::vector<AsyncTask> tasks;
 
@@ -58,10 +48,26 @@ int main() {
         tasks.push_back(fetch_data(request));
     }
 
-    // Attente des résultats pour chaque tâche
+    // Attente des résultats pour chaque tâche (get() bloque jusqu'à la fin de la coroutine)
     for (auto& task : tasks) {
-        std::cout << task.get() << std::endl;  // Récupère et affiche le résultat de chaque tâche
+        async_log::info("{}", task.get());  // Récupère et affiche le résultat de chaque tâche
     }
 
+    // Les mêmes requêtes à travers une chaîne de coroutines sur deux threads
+    {
+        coro_channel::executor pool(2);
+        coro_channel::channel<std::string> raw(2, &pool), labelled(2, &pool);
+        std::latch done(1);
+        log_all(pool, labelled, done);
+        label(pool, raw, labelled);
+        send_requests(pool, raw, requests);
+        done.wait();
+    }
+
+    // Instantané au format texte de Prometheus
+    runtime_metrics::write_file("fetch_data.prom", runtime_metrics::to_prometheus(fetch_task::metrics.snapshot()));
+    // Chronologie des coroutines (compilé avec -DCORO_TRACE=1)
+    coro_trace::write_chrome_json("fetch_data.trace.json");
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,441 @@
+#ifndef CPP_20_SPATIAL_INDEX_H
+#define CPP_20_SPATIAL_INDEX_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Index spatial statique pour de grands ensembles de points entiers (x, y) :
+//
+//   - les points sont triés selon leur code de Morton (bits de x et y entrelacés, tri par base
+//     en parallèle) puis rangés en colonnes x / y / identifiant : des points proches dans le
+//     plan sont proches en mémoire ;
+//   - au-dessus, une hiérarchie de boîtes englobantes (R-tree compact) : chaque nœud couvre
+//     16 nœuds du niveau inférieur, ou 16 points consécutifs pour les feuilles ; les boîtes
+//     de chaque niveau sont elles aussi en colonnes (min_x, min_y, max_x, max_y).
+//
+// Requêtes : points dans une boîte, dans un disque, k plus proches voisins (parcours du
+// meilleur d'abord), et versions par lots réparties sur plusieurs threads.
+// Les identifiants rendus sont les positions des points dans le tableau d'origine.
+namespace spatial {
+
+    // Bornes incluses
+    struct box {
+        int min_x, min_y, max_x, max_y;
+
+        bool contains(int x, int y) const { return x >= min_x && x <= max_x && y >= min_y && y <= max_y; }
+        bool contains(const box& b) const {
+            return b.min_x >= min_x && b.max_x <= max_x && b.min_y >= min_y && b.max_y <= max_y;
+        }
+        bool intersects(const box& b) const {
+            return b.min_x <= max_x && b.max_x >= min_x && b.min_y <= max_y && b.max_y >= min_y;
+        }
+    };
+
+    struct query_point {
+        int x, y;
+    };
+
+    // Résultats d'un lot de requêtes : ids des réponses de la requête i dans [offsets[i], offsets[i + 1])
+    struct batch_result {
+        std::vector<std::uint64_t> offsets;
+        std::vector<std::uint32_t> ids;
+
+        std::span<const std::uint32_t> operator[](std::size_t i) const {
+            return std::span<const std::uint32_t>(ids).subspan(offsets[i], offsets[i + 1] - offsets[i]);
+        }
+    };
+
+    inline constexpr std::uint32_t no_point = std::numeric_limits<std::uint32_t>::max();
+
+    namespace detail {
+
+        inline constexpr std::size_t node_size = 16;
+
+        inline std::uint64_t spread_bits(std::uint32_t v) {
+            std::uint64_t x = v;
+            x = (x | x << 16) & 0x0000FFFF0000FFFFULL;
+            x = (x | x << 8) & 0x00FF00FF00FF00FFULL;
+            x = (x | x << 4) & 0x0F0F0F0F0F0F0F0FULL;
+            x = (x | x << 2) & 0x3333333333333333ULL;
+            x = (x | x << 1) & 0x5555555555555555ULL;
+            return x;
+        }
+
+        inline std::uint64_t morton(std::uint32_t x, std::uint32_t y) {
+            return spread_bits(x) | spread_bits(y) << 1;
+        }
+
+        // Nombre de threads demandé, 0 : un par coeur
+        inline unsigned thread_count(unsigned requested) {
+            return requested > 0 ? requested : std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // f(begin, end, chunk) sur `chunks` tranches, la première sur le thread appelant
+        template <typename F>
+        void for_chunks(std::size_t n, unsigned chunks, F&& f) {
+            chunks = std::max(1u, chunks);
+            std::vector<std::jthread> threads;
+            for (unsigned c = 1; c < chunks; ++c) {
+                threads.emplace_back([&, c] { f(n * c / chunks, n * (c + 1) / chunks, c); });
+            }
+            f(0, n / chunks, 0u);
+        }
+
+        // Tri par base, octet par octet (LSD), des clés et de leurs ids ; histogrammes et
+        // dispersion par tranche en parallèle, les octets identiques partout sont sautés
+        inline void radix_sort(std::vector<std::uint64_t>& keys, std::vector<std::uint32_t>& ids, unsigned threads) {
+            const std::size_t n = keys.size();
+            threads = static_cast<unsigned>(std::clamp<std::size_t>(n / 65536, 1, thread_count(threads)));
+            std::vector<std::uint64_t> key_buffer(n);
+            std::vector<std::uint32_t> id_buffer(n);
+            std::vector<std::array<std::size_t, 256>> histograms(threads);
+
+            for (unsigned shift = 0; shift < 64; shift += 8) {
+                for_chunks(n, threads, [&](std::size_t begin, std::size_t end, unsigned t) {
+                    auto& h = histograms[t];
+                    h.fill(0);
+                    for (std::size_t i = begin; i < end; ++i) ++h[keys[i] >> shift & 0xFF];
+                });
+                // Position de départ de chaque tranche pour chaque octet
+                std::size_t offset = 0;
+                bool trivial = false;
+                for (std::size_t digit = 0; digit < 256; ++digit) {
+                    std::size_t total = 0;
+                    for (unsigned t = 0; t < threads; ++t) {
+                        const std::size_t count = histograms[t][digit];
+                        histograms[t][digit] = offset + total;
+                        total += count;
+                    }
+                    trivial |= total == n;
+                    offset += total;
+                }
+                if (trivial) continue;
+
+                for_chunks(n, threads, [&](std::size_t begin, std::size_t end, unsigned t) {
+                    auto& position = histograms[t];
+                    for (std::size_t i = begin; i < end; ++i) {
+                        const std::size_t to = position[keys[i] >> shift & 0xFF]++;
+                        key_buffer[to] = keys[i];
+                        id_buffer[to] = ids[i];
+                    }
+                });
+                keys.swap(key_buffer);
+                ids.swap(id_buffer);
+            }
+        }
+
+        // Carré de la distance d'un point à une boîte (0 dedans)
+        inline double distance2(int x, int y, int min_x, int min_y, int max_x, int max_y) {
+            const double dx = x < min_x ? static_cast<double>(min_x) - x : x > max_x ? static_cast<double>(x) - max_x : 0.0;
+            const double dy = y < min_y ? static_cast<double>(min_y) - y : y > max_y ? static_cast<double>(y) - max_y : 0.0;
+            return dx * dx + dy * dy;
+        }
+
+    }  // namespace detail
+
+    class index {
+    public:
+        index() = default;
+
+        // P : tout type à membres entiers x et y (Point de main.cpp) ; threads = 0 : un par coeur
+        template <typename P>
+        static index build(std::span<const P> points, unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+            if (points.size() >= no_point) {
+                throw std::length_error("spatial::index : trop de points");
+            }
+            index result;
+            const std::size_t n = points.size();
+            if (n == 0) return result;
+            const unsigned chunks = static_cast<unsigned>(std::clamp<std::size_t>(n / 65536, 1, detail::thread_count(threads)));
+
+            // Bornes globales, pour ramener les coordonnées à des entiers non signés
+            std::vector<box> partial(chunks, box{std::numeric_limits<int>::max(), std::numeric_limits<int>::max(),
+                                                 std::numeric_limits<int>::min(), std::numeric_limits<int>::min()});
+            detail::for_chunks(n, chunks, [&](std::size_t begin, std::size_t end, unsigned c) {
+                box& b = partial[c];
+                for (std::size_t i = begin; i < end; ++i) {
+                    b.min_x = std::min(b.min_x, static_cast<int>(points[i].x));
+                    b.min_y = std::min(b.min_y, static_cast<int>(points[i].y));
+                    b.max_x = std::max(b.max_x, static_cast<int>(points[i].x));
+                    b.max_y = std::max(b.max_y, static_cast<int>(points[i].y));
+                }
+            });
+            box bounds = partial[0];
+            for (const box& b : partial) {
+                bounds = {std::min(bounds.min_x, b.min_x), std::min(bounds.min_y, b.min_y),
+                          std::max(bounds.max_x, b.max_x), std::max(bounds.max_y, b.max_y)};
+            }
+
+            // Codes de Morton, tri, puis points rangés dans cet ordre
+            std::vector<std::uint64_t> keys(n);
+            result.ids_.resize(n);
+            detail::for_chunks(n, chunks, [&](std::size_t begin, std::size_t end, unsigned) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    const auto x = static_cast<std::uint32_t>(static_cast<std::int64_t>(points[i].x) - bounds.min_x);
+                    const auto y = static_cast<std::uint32_t>(static_cast<std::int64_t>(points[i].y) - bounds.min_y);
+                    keys[i] = detail::morton(x, y);
+                    result.ids_[i] = static_cast<std::uint32_t>(i);
+                }
+            });
+            detail::radix_sort(keys, result.ids_, chunks);
+            keys = {};
+
+            result.xs_.resize(n);
+            result.ys_.resize(n);
+            detail::for_chunks(n, chunks, [&](std::size_t begin, std::size_t end, unsigned) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    result.xs_[i] = points[result.ids_[i]].x;
+                    result.ys_[i] = points[result.ids_[i]].y;
+                }
+            });
+            result.build_levels(chunks);
+            return result;
+        }
+
+        template <typename P>
+        static index build(const std::vector<P>& points, unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+            return build(std::span<const P>(points), threads);
+        }
+
+        std::size_t size() const { return xs_.size(); }
+
+        // visit(id, x, y) pour chaque point de la boîte
+        template <typename Visit>
+        void for_each_in_box(const box& query, Visit&& visit) const {
+            if (xs_.empty()) return;
+            // Profondeur au plus 8 niveaux (16^8 = 2^32 points), 16 enfants par nœud
+            std::array<std::pair<std::uint32_t, std::uint32_t>, 8 * detail::node_size + 1> stack;
+            std::size_t top = 0;
+            stack[top++] = {static_cast<std::uint32_t>(levels() - 1), 0};
+            while (top > 0) {
+                const auto [level, node] = stack[--top];
+                if (level == 0) {
+                    const std::size_t end = std::min((node + 1) * detail::node_size, size());
+                    for (std::size_t i = node * detail::node_size; i < end; ++i) {
+                        if (query.contains(xs_[i], ys_[i])) visit(ids_[i], xs_[i], ys_[i]);
+                    }
+                    continue;
+                }
+                const std::size_t child_level = level - 1;
+                const std::size_t first = level_begin_[child_level];
+                const std::size_t end = std::min((node + 1) * detail::node_size, level_count(child_level));
+                for (std::size_t child = node * detail::node_size; child < end; ++child) {
+                    const box b = node_box(first + child);
+                    if (!query.intersects(b)) continue;
+                    if (query.contains(b)) {
+                        // Sous-arbre entièrement dedans : ses points sont contigus
+                        const std::size_t span = points_per_node(child_level);
+                        const std::size_t last = std::min((child + 1) * span, size());
+                        for (std::size_t i = child * span; i < last; ++i) visit(ids_[i], xs_[i], ys_[i]);
+                    } else {
+                        stack[top++] = {static_cast<std::uint32_t>(child_level), static_cast<std::uint32_t>(child)};
+                    }
+                }
+            }
+        }
+
+        std::vector<std::uint32_t> query_box(const box& query) const {
+            std::vector<std::uint32_t> found;
+            for_each_in_box(query, [&](std::uint32_t id, int, int) { found.push_back(id); });
+            return found;
+        }
+
+        std::vector<std::uint32_t> query_radius(int x, int y, double radius) const {
+            std::vector<std::uint32_t> found;
+            for_each_in_radius(x, y, radius, [&](std::uint32_t id, int, int) { found.push_back(id); });
+            return found;
+        }
+
+        template <typename Visit>
+        void for_each_in_radius(int x, int y, double radius, Visit&& visit) const {
+            const double r2 = radius * radius;
+            const auto clamp = [](double v) {
+                return static_cast<int>(std::clamp(v, static_cast<double>(std::numeric_limits<int>::min()),
+                                                   static_cast<double>(std::numeric_limits<int>::max())));
+            };
+            const box bounds{clamp(x - radius), clamp(y - radius), clamp(x + radius), clamp(y + radius)};
+            for_each_in_box(bounds, [&](std::uint32_t id, int px, int py) {
+                const double dx = static_cast<double>(px) - x, dy = static_cast<double>(py) - y;
+                if (dx * dx + dy * dy <= r2) visit(id, px, py);
+            });
+        }
+
+        // Les k plus proches, du plus proche au plus lointain
+        std::vector<std::uint32_t> nearest(int x, int y, std::size_t k) const {
+            std::vector<std::uint32_t> found;
+            nearest(x, y, k, found);
+            return found;
+        }
+
+        // Lots de requêtes, répartis sur `threads` threads (0 : un par coeur)
+        batch_result query_boxes(std::span<const box> queries, unsigned threads) const {
+            return run_batch(queries.size(), threads, [&](std::size_t q, std::vector<std::uint32_t>& out) {
+                for_each_in_box(queries[q], [&](std::uint32_t id, int, int) { out.push_back(id); });
+            });
+        }
+
+        batch_result query_radii(std::span<const query_point> centers, double radius, unsigned threads) const {
+            return run_batch(centers.size(), threads, [&](std::size_t q, std::vector<std::uint32_t>& out) {
+                for_each_in_radius(centers[q].x, centers[q].y, radius, [&](std::uint32_t id, int, int) { out.push_back(id); });
+            });
+        }
+
+        // k ids par requête, complétés par no_point s'il y a moins de k points
+        std::vector<std::uint32_t> nearest_batch(std::span<const query_point> queries, std::size_t k, unsigned threads) const {
+            std::vector<std::uint32_t> result(queries.size() * k, no_point);
+            detail::for_chunks(queries.size(), detail::thread_count(threads), [&](std::size_t begin, std::size_t end, unsigned) {
+                std::vector<std::uint32_t> found;
+                for (std::size_t q = begin; q < end; ++q) {
+                    nearest(queries[q].x, queries[q].y, k, found);
+                    std::copy(found.begin(), found.end(), result.begin() + static_cast<std::ptrdiff_t>(q * k));
+                }
+            });
+            return result;
+        }
+
+    private:
+        // Entrée du tas du parcours k-NN : nœud (niveau >= 0) ou point (niveau = -1)
+        struct candidate {
+            double distance2;
+            std::int32_t level;
+            std::uint32_t index;
+
+            bool operator>(const candidate& other) const { return distance2 > other.distance2; }
+        };
+
+        void nearest(int x, int y, std::size_t k, std::vector<std::uint32_t>& found) const {
+            found.clear();
+            if (xs_.empty() || k == 0) return;
+            // Tas réutilisé d'une requête à l'autre sur un même thread
+            thread_local std::vector<candidate> heap;
+            heap.clear();
+            const auto push = [&](candidate c) {
+                heap.push_back(c);
+                std::push_heap(heap.begin(), heap.end(), std::greater<>());
+            };
+            push({0.0, static_cast<std::int32_t>(levels() - 1), 0});
+            while (!heap.empty() && found.size() < k) {
+                std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+                const candidate c = heap.back();
+                heap.pop_back();
+                if (c.level < 0) {
+                    found.push_back(ids_[c.index]);
+                } else if (c.level == 0) {
+                    const std::size_t end = std::min((c.index + 1) * detail::node_size, size());
+                    for (std::size_t i = c.index * detail::node_size; i < end; ++i) {
+                        const double dx = static_cast<double>(xs_[i]) - x, dy = static_cast<double>(ys_[i]) - y;
+                        push({dx * dx + dy * dy, -1, static_cast<std::uint32_t>(i)});
+                    }
+                } else {
+                    const std::size_t child_level = static_cast<std::size_t>(c.level) - 1;
+                    const std::size_t first = level_begin_[child_level];
+                    const std::size_t end = std::min((c.index + 1) * detail::node_size, level_count(child_level));
+                    for (std::size_t child = c.index * detail::node_size; child < end; ++child) {
+                        const std::size_t n = first + child;
+                        push({detail::distance2(x, y, min_x_[n], min_y_[n], max_x_[n], max_y_[n]),
+                              static_cast<std::int32_t>(child_level), static_cast<std::uint32_t>(child)});
+                    }
+                }
+            }
+        }
+
+        template <typename Query>
+        batch_result run_batch(std::size_t count, unsigned threads, Query&& query) const {
+            threads = static_cast<unsigned>(std::clamp<std::size_t>(count / 64, 1, detail::thread_count(threads)));
+            std::vector<batch_result> parts(threads);
+            detail::for_chunks(count, threads, [&](std::size_t begin, std::size_t end, unsigned t) {
+                batch_result& part = parts[t];
+                part.offsets.push_back(0);
+                for (std::size_t q = begin; q < end; ++q) {
+                    query(q, part.ids);
+                    part.offsets.push_back(part.ids.size());
+                }
+            });
+            batch_result result;
+            result.offsets.reserve(count + 1);
+            result.offsets.push_back(0);
+            for (const batch_result& part : parts) {
+                const std::uint64_t base = result.ids.size();
+                for (std::size_t i = 1; i < part.offsets.size(); ++i) result.offsets.push_back(base + part.offsets[i]);
+                result.ids.insert(result.ids.end(), part.ids.begin(), part.ids.end());
+            }
+            return result;
+        }
+
+        // Boîtes des feuilles (16 points consécutifs), puis de chaque niveau jusqu'à la racine
+        void build_levels(unsigned chunks) {
+            std::size_t count = (size() + detail::node_size - 1) / detail::node_size;
+            std::size_t total = 0;
+            for (std::size_t c = count;; c = (c + detail::node_size - 1) / detail::node_size) {
+                level_begin_.push_back(total);
+                total += c;
+                if (c == 1) break;
+            }
+            level_begin_.push_back(total);
+            min_x_.resize(total);
+            min_y_.resize(total);
+            max_x_.resize(total);
+            max_y_.resize(total);
+
+            for (std::size_t level = 0; level < levels(); ++level) {
+                const std::size_t first = level_begin_[level];
+                const std::size_t nodes = level_count(level);
+                const std::size_t children = level == 0 ? size() : level_count(level - 1);
+                const std::size_t child_first = level == 0 ? 0 : level_begin_[level - 1];
+                const auto& cx0 = level == 0 ? xs_ : min_x_;
+                const auto& cy0 = level == 0 ? ys_ : min_y_;
+                const auto& cx1 = level == 0 ? xs_ : max_x_;
+                const auto& cy1 = level == 0 ? ys_ : max_y_;
+                detail::for_chunks(nodes, nodes >= 4096 ? chunks : 1, [&](std::size_t begin, std::size_t end, unsigned) {
+                    for (std::size_t node = begin; node < end; ++node) {
+                        int x0 = std::numeric_limits<int>::max(), y0 = x0;
+                        int x1 = std::numeric_limits<int>::min(), y1 = x1;
+                        const std::size_t last = std::min((node + 1) * detail::node_size, children);
+                        for (std::size_t c = child_first + node * detail::node_size; c < child_first + last; ++c) {
+                            x0 = std::min(x0, cx0[c]);
+                            y0 = std::min(y0, cy0[c]);
+                            x1 = std::max(x1, cx1[c]);
+                            y1 = std::max(y1, cy1[c]);
+                        }
+                        min_x_[first + node] = x0;
+                        min_y_[first + node] = y0;
+                        max_x_[first + node] = x1;
+                        max_y_[first + node] = y1;
+                    }
+                });
+            }
+        }
+
+        std::size_t levels() const { return level_begin_.size() - 1; }
+        std::size_t level_count(std::size_t level) const { return level_begin_[level + 1] - level_begin_[level]; }
+
+        // Points couverts par un nœud d'un niveau : 16^(niveau + 1)
+        static std::size_t points_per_node(std::size_t level) {
+            std::size_t span = detail::node_size;
+            for (std::size_t l = 0; l < level; ++l) span *= detail::node_size;
+            return span;
+        }
+
+        box node_box(std::size_t n) const { return {min_x_[n], min_y_[n], max_x_[n], max_y_[n]}; }
+
+        // Points dans l'ordre de Morton, en colonnes
+        std::vector<int> xs_;
+        std::vector<int> ys_;
+        std::vector<std::uint32_t> ids_;
+
+        // Boîtes de tous les niveaux bout à bout, feuilles d'abord ; niveau l dans
+        // [level_begin_[l], level_begin_[l + 1])
+        std::vector<int> min_x_, min_y_, max_x_, max_y_;
+        std::vector<std::size_t> level_begin_;
+    };
+
+}  // namespace spatial
+
+#endif //CPP_20_SPATIAL_INDEX_H
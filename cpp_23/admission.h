@@ -0,0 +1,142 @@
+#ifndef CPP_23_ADMISSION_H
+#define CPP_23_ADMISSION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+// Contrôle d'admission du serveur : limites dures (connexions, requêtes en vol, octets
+// tamponnés par connexion) et délestage selon le temps passé en file par les requêtes.
+namespace admission {
+
+    using clock = std::chrono::steady_clock;
+
+    struct limits {
+        std::size_t max_connections = 10000;
+        std::size_t max_inflight_requests = 65536;       // lues et pas encore répondues, pour tout le serveur (ou le shard)
+        std::size_t max_outbound_bytes = 4 << 20;        // par connexion : au-delà on arrête de lire
+        std::size_t max_buffered_input = 4 << 20;        // par connexion, mémoire de réception allouée : au-delà on arrête de lire
+
+        // Délestage façon CoDel : si le temps de séjour minimal sur un intervalle dépasse
+        // `queue_target`, le serveur est en surcharge et rejette toute requête qui a attendu
+        // plus de 2 * queue_target. Hors surcharge, seules celles au-delà de `queue_deadline` le sont.
+        bool shedding = true;
+        std::chrono::microseconds queue_target{5000};
+        std::chrono::microseconds queue_interval{100000};
+        std::chrono::microseconds queue_deadline{100000};
+    };
+
+    class controller {
+    public:
+        explicit controller(limits config = {}) : limits_(config) {}
+
+        const limits& config() const { return limits_; }
+
+        bool try_open_connection() {
+            if (connections_.fetch_add(1, std::memory_order_relaxed) >= limits_.max_connections) {
+                connections_.fetch_sub(1, std::memory_order_relaxed);
+                rejected_connections_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+
+        void close_connection() {
+            connections_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        bool try_begin_request() {
+            if (inflight_.fetch_add(1, std::memory_order_relaxed) >= limits_.max_inflight_requests) {
+                inflight_.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+
+        void end_requests(std::size_t n) {
+            inflight_.fetch_sub(n, std::memory_order_relaxed);
+        }
+
+        // Retard de la boucle d'événements : les octets restés dans le noyau pendant que le
+        // thread traitait d'autres connexions ont attendu au moins ce temps-là avant d'être lus
+        void note_loop_lag(clock::duration lag) {
+            loop_lag_.store(lag.count(), std::memory_order_relaxed);
+        }
+
+        // Décide si une requête qui a attendu `sojourn` depuis sa lecture doit être rejetée sans être traitée
+        bool should_shed(clock::duration sojourn, clock::time_point now) {
+            if (!limits_.shedding) {
+                return false;
+            }
+            sojourn += clock::duration(loop_lag_.load(std::memory_order_relaxed));
+            observe(sojourn, now);
+            const bool shed = sojourn > limits_.queue_deadline ||
+                              (overloaded_.load(std::memory_order_relaxed) && sojourn > 2 * limits_.queue_target);
+            if (shed) {
+                shed_requests_.fetch_add(1, std::memory_order_relaxed);
+            }
+            return shed;
+        }
+
+        void note_paused_read() {
+            paused_reads_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::size_t connections() const { return connections_.load(std::memory_order_relaxed); }
+        std::size_t inflight() const { return inflight_.load(std::memory_order_relaxed); }
+        bool overloaded() const { return overloaded_.load(std::memory_order_relaxed); }
+        clock::duration loop_lag() const { return clock::duration(loop_lag_.load(std::memory_order_relaxed)); }
+
+        void write_counters(std::ostream& out) const {
+            out << "admission_connections " << connections() << '\n'
+                << "admission_inflight_requests " << inflight() << '\n'
+                << "admission_overloaded " << (overloaded() ? 1 : 0) << '\n'
+                << "admission_loop_lag_seconds " << std::chrono::duration<double>(loop_lag()).count() << '\n'
+                << "admission_rejected_connections_total " << rejected_connections_.load(std::memory_order_relaxed) << '\n'
+                << "admission_shed_requests_total " << shed_requests_.load(std::memory_order_relaxed) << '\n'
+                << "admission_paused_reads_total " << paused_reads_.load(std::memory_order_relaxed) << '\n';
+        }
+
+    private:
+        // Minimum du temps de séjour par intervalle. Plusieurs threads peuvent observer en même
+        // temps : le basculement d'intervalle est approximatif, ce qui suffit à un régulateur.
+        void observe(clock::duration sojourn, clock::time_point now) {
+            const auto value = sojourn.count();
+            auto current = interval_min_.load(std::memory_order_relaxed);
+            while (value < current && !interval_min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            }
+
+            auto end = interval_end_.load(std::memory_order_relaxed);
+            const auto now_ticks = now.time_since_epoch().count();
+            if (now_ticks < end) {
+                return;
+            }
+            const auto next = now_ticks + std::chrono::duration_cast<clock::duration>(limits_.queue_interval).count();
+            if (interval_end_.compare_exchange_strong(end, next, std::memory_order_relaxed)) {
+                const auto minimum = interval_min_.exchange(std::numeric_limits<clock::rep>::max(), std::memory_order_relaxed);
+                // Le tout premier intervalle démarre seulement : on n'en tire pas de conclusion
+                if (end != 0) {
+                    overloaded_.store(minimum > std::chrono::duration_cast<clock::duration>(limits_.queue_target).count(),
+                                      std::memory_order_relaxed);
+                }
+            }
+        }
+
+        limits limits_;
+        std::atomic<std::size_t> connections_{0};
+        std::atomic<std::size_t> inflight_{0};
+        std::atomic<clock::rep> interval_min_{std::numeric_limits<clock::rep>::max()};
+        std::atomic<clock::rep> interval_end_{0};
+        std::atomic<clock::rep> loop_lag_{0};
+        std::atomic<bool> overloaded_{false};
+        std::atomic<std::uint64_t> rejected_connections_{0};
+        std::atomic<std::uint64_t> shed_requests_{0};
+        std::atomic<std::uint64_t> paused_reads_{0};
+    };
+
+}  // namespace admission
+
+#endif //CPP_23_ADMISSION_H
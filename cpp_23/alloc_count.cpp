@@ -0,0 +1,101 @@
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include "alloc_count.h"
+
+// Remplacement des operator new / delete globaux : chaque variante compte l'allocation
+// (alloc_count::detail::on_allocate) puis délègue à malloc / aligned_alloc.
+namespace {
+
+    const bool installed = [] {
+        alloc_count::detail::installed.store(true, std::memory_order_relaxed);
+        return true;
+    }();
+
+    void* raw_allocate(std::size_t size, std::size_t alignment) noexcept {
+        if (size == 0) size = 1;
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) return std::malloc(size);
+        // aligned_alloc exige une taille multiple de l'alignement ; arrondir ne doit pas déborder
+        if (size > std::numeric_limits<std::size_t>::max() - (alignment - 1)) return nullptr;
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+
+    void* allocate_or_throw(std::size_t size, std::size_t alignment) {
+        while (true) {
+            if (void* p = raw_allocate(size, alignment)) return p;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    void* allocate_or_null(std::size_t size, std::size_t alignment) noexcept {
+        try {
+            return allocate_or_throw(size, alignment);
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    void release(void* p) noexcept {
+        if (!p) return;
+        alloc_count::detail::on_deallocate();
+        std::free(p);
+    }
+
+    constexpr std::size_t default_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+}
+
+void* operator new(std::size_t size) {
+    alloc_count::detail::on_allocate(size);
+    return allocate_or_throw(size, default_alignment);
+}
+
+void* operator new[](std::size_t size) {
+    alloc_count::detail::on_allocate(size);
+    return allocate_or_throw(size, default_alignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    alloc_count::detail::on_allocate(size);
+    return allocate_or_null(size, default_alignment);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    alloc_count::detail::on_allocate(size);
+    return allocate_or_null(size, default_alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    alloc_count::detail::on_allocate(size);
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    alloc_count::detail::on_allocate(size);
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    alloc_count::detail::on_allocate(size);
+    return allocate_or_null(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    alloc_count::detail::on_allocate(size);
+    return allocate_or_null(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { release(p); }
@@ -0,0 +1,350 @@
+#ifndef CPP_23_ALLOC_COUNT_H
+#define CPP_23_ALLOC_COUNT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <unistd.h>
+
+// Comptage des allocations pour les benchmarks et les vérifications :
+//
+//   - alloc_count.cpp remplace les operator new / delete globaux (toutes les variantes) et
+//     appelle on_allocate / on_deallocate ; l'ajouter aux sources de l'exécutable à mesurer.
+//     malloc lui-même n'est pas intercepté : seules les allocations C++ sont comptées ;
+//   - compteurs par thread (sans atomique) et pour tout le processus (atomiques relâchés) ;
+//   - scope : allocations d'une portée, pour le thread courant ou pour tout le processus
+//     (les tâches d'un pool tournent sur d'autres threads) ; measure() les rapporte à l'itération ;
+//   - forbid : toute allocation dans la portée, sur ce thread, affiche la pile et arrête le
+//     programme — « ce chemin n'alloue pas » ;
+//   - set_sampling(n) : une allocation sur n enregistre sa pile ; top_sites() donne les
+//     sites les plus fréquents, à partir du premier cadre hors bibliothèque standard (les
+//     allocations d'un même appelant passées par std::vector ou std::string sont regroupées).
+//     Lier avec -rdynamic (ENABLE_EXPORTS) pour avoir les noms des fonctions ; le rapport passe
+//     par malloc et ne fausse donc pas les compteurs.
+namespace alloc_count {
+
+    struct counters {
+        std::uint64_t allocations = 0;
+        std::uint64_t deallocations = 0;
+        std::uint64_t bytes = 0;            // octets demandés
+
+        counters operator-(const counters& start) const {
+            return {allocations - start.allocations, deallocations - start.deallocations, bytes - start.bytes};
+        }
+    };
+
+    // Allocateur sur malloc / free : ni compté, ni échantillonné, ni interdit par forbid
+    template <typename T>
+    struct untracked_allocator {
+        using value_type = T;
+
+        untracked_allocator() = default;
+        template <typename U>
+        untracked_allocator(const untracked_allocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            if (void* p = std::malloc(n * sizeof(T))) return static_cast<T*>(p);
+            throw std::bad_alloc();
+        }
+        void deallocate(T* p, std::size_t) noexcept { std::free(p); }
+
+        template <typename U>
+        bool operator==(const untracked_allocator<U>&) const noexcept { return true; }
+    };
+
+    using untracked_string = std::basic_string<char, std::char_traits<char>, untracked_allocator<char>>;
+
+    // Site d'allocation échantillonné : pile d'appel symbolisée, du premier cadre hors
+    // bibliothèque standard vers le haut
+    struct site {
+        std::uint64_t samples = 0;
+        std::uint64_t bytes = 0;            // octets des allocations échantillonnées
+        std::vector<untracked_string, untracked_allocator<untracked_string>> frames;
+    };
+
+    using site_list = std::vector<site, untracked_allocator<site>>;
+
+    namespace detail {
+
+        // Assez profond pour dépasser les couches de std::allocator, std::vector, std::string...
+        inline constexpr int max_frames = 24;
+        inline constexpr std::size_t site_slots = 1024;
+
+        // Cadres à sauter à la capture : on_allocate et l'operator new qui l'appelle. Les cadres
+        // de la bibliothèque standard ne sont reconnus qu'au rapport, une fois symbolisés.
+        inline constexpr int skipped_frames = 2;
+
+        // Types triviaux seulement : operator new peut être appelé avant l'initialisation
+        // dynamique et pendant la destruction des threads
+        struct thread_state {
+            counters local;
+            std::uint32_t forbid_depth;
+            std::uint32_t countdown;
+            bool in_hook;                   // pas de comptage ni d'échantillonnage récursif
+        };
+
+        inline constinit thread_local thread_state state{};
+
+        inline std::atomic<std::uint64_t> process_allocations{0};
+        inline std::atomic<std::uint64_t> process_deallocations{0};
+        inline std::atomic<std::uint64_t> process_bytes{0};
+        inline std::atomic<std::uint32_t> sample_every{0};
+        inline std::atomic<bool> installed{false};
+
+        struct site_slot {
+            std::uint64_t hash;
+            int depth;
+            void* frames[max_frames];
+            std::uint64_t samples;
+            std::uint64_t bytes;
+        };
+
+        // Table à adressage ouvert, sous un verrou tournant : seules les allocations
+        // échantillonnées y passent
+        inline std::atomic_flag sites_lock;
+        inline site_slot sites[site_slots];
+
+        inline void record_site(void* const* frames, int depth, std::size_t size) {
+            std::uint64_t hash = 1469598103934665603ull;
+            for (int i = 0; i < depth; ++i) {
+                hash = (hash ^ reinterpret_cast<std::uintptr_t>(frames[i])) * 1099511628211ull;
+            }
+            hash |= 1;  // 0 : emplacement libre
+            while (sites_lock.test_and_set(std::memory_order_acquire)) {
+            }
+            for (std::size_t probe = 0; probe < site_slots; ++probe) {
+                site_slot& slot = sites[(hash + probe) & (site_slots - 1)];
+                if (slot.hash == 0) {
+                    slot.hash = hash;
+                    slot.depth = depth;
+                    std::copy_n(frames, depth, slot.frames);
+                }
+                if (slot.hash == hash) {
+                    ++slot.samples;
+                    slot.bytes += size;
+                    break;
+                }
+            }
+            sites_lock.clear(std::memory_order_release);
+        }
+
+        // Écrit sans allouer : la pile est symbolisée par backtrace_symbols_fd
+        [[noreturn]] inline void report_forbidden(std::size_t size) {
+            char message[128];
+            const int length = std::snprintf(message, sizeof message,
+                                             "alloc_count : allocation de %zu octets dans une portée forbid\n", size);
+            if (length > 0) (void) !::write(STDERR_FILENO, message, static_cast<std::size_t>(length));
+            void* frames[32];
+            ::backtrace_symbols_fd(frames, ::backtrace(frames, 32), STDERR_FILENO);
+            std::abort();
+        }
+
+        // Hors ligne : la pile commence toujours par on_allocate puis operator new
+        [[gnu::noinline]] inline void on_allocate(std::size_t size) {
+            thread_state& s = state;
+            if (s.in_hook) return;
+            ++s.local.allocations;
+            s.local.bytes += size;
+            process_allocations.fetch_add(1, std::memory_order_relaxed);
+            process_bytes.fetch_add(size, std::memory_order_relaxed);
+            if (s.forbid_depth != 0) {
+                s.in_hook = true;
+                report_forbidden(size);
+            }
+            const std::uint32_t every = sample_every.load(std::memory_order_relaxed);
+            if (every == 0) return;
+            if (s.countdown != 0 && --s.countdown != 0) return;
+            s.countdown = every;
+            s.in_hook = true;  // backtrace peut allouer au premier appel
+            void* frames[max_frames + skipped_frames];
+            const int depth = ::backtrace(frames, max_frames + skipped_frames);
+            if (depth > skipped_frames) record_site(frames + skipped_frames, depth - skipped_frames, size);
+            s.in_hook = false;
+        }
+
+        inline void on_deallocate() {
+            thread_state& s = state;
+            if (s.in_hook) return;
+            ++s.local.deallocations;
+            process_deallocations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline untracked_string symbolize(char* raw) {
+            // Format glibc : binaire(symbole+0x12) [0x...]
+            untracked_string text = raw;
+            const auto open = text.find('('), plus = text.find('+', open);
+            if (open == untracked_string::npos || plus == untracked_string::npos || plus == open + 1) return text;
+            const untracked_string mangled = text.substr(open + 1, plus - open - 1);
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+            if (status != 0 || demangled == nullptr) return text;
+            untracked_string name = demangled;
+            std::free(demangled);
+            return name + text.substr(plus);
+        }
+
+        // Nom qualifié d'un cadre démanglé, sans type de retour (fonctions templates) ni
+        // paramètres : après le dernier espace et avant la première '(' hors chevrons
+        inline std::string_view function_name(std::string_view frame) {
+            int depth = 0;
+            std::size_t start = 0;
+            for (std::size_t i = 0; i < frame.size(); ++i) {
+                const char c = frame[i];
+                if (c == '<') ++depth;
+                else if (c == '>') depth = std::max(depth - 1, 0);
+                else if (depth == 0 && c == ' ') start = i + 1;
+                else if (depth == 0 && c == '(') return frame.substr(start, i - start);
+            }
+            return frame.substr(start);
+        }
+
+        // Cadre de la bibliothèque standard ou de l'allocation elle-même (operator new,
+        // on_allocate) : à sauter pour atteindre le site qui alloue
+        inline bool library_frame(std::string_view frame) {
+            if (frame.starts_with("operator new") || frame.starts_with("operator delete")) return true;
+            if (frame.find("libstdc++.so") != std::string_view::npos) return true;
+            const std::string_view name = function_name(frame);
+            return name.starts_with("std::") || name.starts_with("__gnu_cxx::") || name.starts_with("__cxxabiv1::") ||
+                   name.starts_with("alloc_count::");
+        }
+
+    }  // namespace detail
+
+    // Faux si alloc_count.cpp n'est pas lié : tous les compteurs resteraient à zéro
+    inline bool installed() { return detail::installed.load(std::memory_order_relaxed); }
+
+    inline counters thread_counters() { return detail::state.local; }
+
+    inline counters process_counters() {
+        return {detail::process_allocations.load(std::memory_order_relaxed),
+                detail::process_deallocations.load(std::memory_order_relaxed),
+                detail::process_bytes.load(std::memory_order_relaxed)};
+    }
+
+    // Allocations depuis la construction ; thread() n'a de sens que sur le thread constructeur
+    class scope {
+    public:
+        scope() : thread_start_(thread_counters()), process_start_(process_counters()) {}
+
+        counters thread() const { return thread_counters() - thread_start_; }
+        counters process() const { return process_counters() - process_start_; }
+
+    private:
+        counters thread_start_;
+        counters process_start_;
+    };
+
+    // Aucune allocation permise sur ce thread tant que la portée vit (imbricable)
+    class forbid {
+    public:
+        forbid() { ++detail::state.forbid_depth; }
+        ~forbid() { --detail::state.forbid_depth; }
+        forbid(const forbid&) = delete;
+        forbid& operator=(const forbid&) = delete;
+    };
+
+    // Lève un forbid englobant (erreur rapportée, journal de diagnostic...)
+    class allow {
+    public:
+        allow() : saved_(std::exchange(detail::state.forbid_depth, 0)) {}
+        ~allow() { detail::state.forbid_depth = saved_; }
+        allow(const allow&) = delete;
+        allow& operator=(const allow&) = delete;
+
+    private:
+        std::uint32_t saved_;
+    };
+
+    struct per_iteration {
+        double allocations = 0;
+        double bytes = 0;
+    };
+
+    inline per_iteration divide(const counters& total, std::size_t iterations) {
+        const double n = static_cast<double>(std::max<std::size_t>(iterations, 1));
+        return {static_cast<double>(total.allocations) / n, static_cast<double>(total.bytes) / n};
+    }
+
+    // Allocations et octets par itération de f, pour tout le processus
+    template <typename F>
+    per_iteration measure(std::size_t iterations, F&& f) {
+        const scope region;
+        for (std::size_t i = 0; i < iterations; ++i) f();
+        return divide(region.process(), iterations);
+    }
+
+    // 0 : pas d'échantillonnage ; n : pile enregistrée pour une allocation sur n, par thread
+    inline void set_sampling(std::uint32_t every) { detail::sample_every.store(every, std::memory_order_relaxed); }
+
+    inline void reset_sites() {
+        while (detail::sites_lock.test_and_set(std::memory_order_acquire)) {
+        }
+        std::fill(std::begin(detail::sites), std::end(detail::sites), detail::site_slot{});
+        detail::sites_lock.clear(std::memory_order_release);
+    }
+
+    // Les `count` sites les plus échantillonnés, du plus fréquent au moins fréquent. Tout le
+    // rapport (copie de la table, symboles, résultat) passe par malloc : ni compté ni interdit.
+    inline site_list top_sites(std::size_t count) {
+        std::vector<detail::site_slot, untracked_allocator<detail::site_slot>> slots;
+        slots.reserve(detail::site_slots);
+        while (detail::sites_lock.test_and_set(std::memory_order_acquire)) {
+        }
+        for (const auto& slot : detail::sites) {
+            if (slot.hash != 0) slots.push_back(slot);
+        }
+        detail::sites_lock.clear(std::memory_order_release);
+
+        // Piles différentes dans la bibliothèque standard, même appelant : un seul site
+        site_list result;
+        for (const auto& slot : slots) {
+            site s{slot.samples, slot.bytes, {}};
+            char** symbols = ::backtrace_symbols(slot.frames, slot.depth);
+            for (int f = 0; f < slot.depth; ++f) {
+                s.frames.push_back(symbols ? detail::symbolize(symbols[f]) : untracked_string("?"));
+            }
+            std::free(symbols);
+            const auto first_user = std::find_if_not(s.frames.begin(), s.frames.end(),
+                                                     [](const auto& frame) { return detail::library_frame(frame); });
+            if (first_user != s.frames.end()) s.frames.erase(s.frames.begin(), first_user);
+
+            const auto same = std::find_if(result.begin(), result.end(),
+                                           [&](const site& other) { return other.frames == s.frames; });
+            if (same == result.end()) {
+                result.push_back(std::move(s));
+            } else {
+                same->samples += s.samples;
+                same->bytes += s.bytes;
+            }
+        }
+        const std::size_t kept = std::min(count, result.size());
+        std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(kept), result.end(),
+                          [](const site& a, const site& b) { return a.samples > b.samples; });
+        result.erase(result.begin() + static_cast<std::ptrdiff_t>(kept), result.end());
+        return result;
+    }
+
+    inline void print_top_sites(std::ostream& out, std::size_t count, std::size_t frames_per_site = 4) {
+        const std::uint32_t every = std::max<std::uint32_t>(detail::sample_every.load(std::memory_order_relaxed), 1);
+        for (const site& s : top_sites(count)) {
+            out << "~" << s.samples * every << " allocations, ~" << s.bytes * every << " octets\n";
+            for (std::size_t f = 0; f < std::min(frames_per_site, s.frames.size()); ++f) {
+                out << "    " << s.frames[f] << '\n';
+            }
+        }
+    }
+
+}  // namespace alloc_count
+
+#endif //CPP_23_ALLOC_COUNT_H
@@ -0,0 +1,414 @@
+#ifndef CPP_23_BATCH_LOADER_H
+#define CPP_23_BATCH_LOADER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <coroutine>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <linux/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "mapped_file.h"
+
+// Chargement d'un lot de petits fichiers avec io_uring : pour chaque fichier, un statx et une
+// chaîne liée openat -> read -> close sont soumis ensemble, sur des descripteurs directs (table
+// de fichiers enregistrée) et dans des tampons enregistrés. Un seul io_uring_enter soumet et
+// récolte des dizaines de fichiers. Les fichiers plus grands qu'un tampon sont repris par
+// load_file (mmap). Sans io_uring (noyau ancien, seccomp), le lot est réparti sur des threads.
+namespace file_loader {
+
+    using load_result = std::expected<mapped_file, error>;
+
+    struct batch_options {
+        unsigned queue_depth = 64;                      // fichiers en vol
+        std::size_t buffer_size = std::size_t{64} << 10;  // tampon enregistré par fichier en vol
+        unsigned fallback_threads = std::max(1u, std::thread::hardware_concurrency());
+        bool use_io_uring = true;
+    };
+
+    struct batch_stats {
+        bool used_io_uring = false;
+        std::uint64_t enter_calls = 0;      // io_uring_enter
+        std::uint64_t setup_calls = 0;      // setup, register, mmap/munmap, close de l'anneau
+        std::uint64_t large_files = 0;      // repris par load_file
+    };
+
+    namespace uring {
+
+        // Anneau io_uring minimal sur les appels système bruts (sans liburing)
+        class ring {
+        public:
+            static std::unique_ptr<ring> create(unsigned entries, std::uint64_t& syscalls) {
+                io_uring_params params{};
+                const int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+                ++syscalls;
+                if (fd < 0) {
+                    return nullptr;
+                }
+                auto r = std::unique_ptr<ring>(new ring(fd, params));
+                if (!r->map(syscalls)) {
+                    return nullptr;
+                }
+                return r;
+            }
+
+            ~ring() {
+                if (sqes_ != MAP_FAILED) ::munmap(sqes_, sqes_size_);
+                if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) ::munmap(cq_ptr_, cq_size_);
+                if (sq_ptr_ != MAP_FAILED) ::munmap(sq_ptr_, sq_size_);
+                ::close(fd_);
+            }
+
+            ring(const ring&) = delete;
+            ring& operator=(const ring&) = delete;
+
+            int register_buffers(const iovec* buffers, unsigned count) {
+                return static_cast<int>(::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, buffers, count));
+            }
+
+            // Table de descripteurs directs vide (-1) : openat y installe ses fichiers
+            int register_sparse_files(unsigned count) {
+                std::vector<int> fds(count, -1);
+                return static_cast<int>(::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_FILES, fds.data(), count));
+            }
+
+            // Entrée de soumission libre, remise à zéro ; nullptr si la file est pleine
+            io_uring_sqe* next_sqe() {
+                const unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+                if (sqe_tail_ - head >= params_.sq_entries) {
+                    return nullptr;
+                }
+                const unsigned index = sqe_tail_ & *sq_mask_;
+                sq_array_[index] = index;
+                io_uring_sqe* sqe = &sqes_[index];
+                std::memset(sqe, 0, sizeof(*sqe));
+                ++sqe_tail_;
+                return sqe;
+            }
+
+            // Soumet les entrées préparées (y compris celles qu'un appel précédent n'a pas fait
+            // prendre au noyau) et attend au moins `wait` complétions
+            int submit_and_wait(unsigned wait) {
+                std::atomic_ref<unsigned>(*sq_tail_).store(sqe_tail_, std::memory_order_release);
+                const unsigned to_submit = sqe_tail_ - std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+                for (;;) {
+                    ++enter_calls_;
+                    const long n = ::syscall(__NR_io_uring_enter, fd_, to_submit, wait, wait ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+                    if (n >= 0 || errno != EINTR) {
+                        return static_cast<int>(n);
+                    }
+                }
+            }
+
+            // Retire les entrées que le noyau n'a pas prises (après un échec de submit_and_wait) ;
+            // renvoie leur nombre. Sans SQPOLL le noyau ne lit la file que dans io_uring_enter.
+            unsigned retract() {
+                const unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+                const unsigned n = sqe_tail_ - head;
+                sqe_tail_ = head;
+                std::atomic_ref<unsigned>(*sq_tail_).store(head, std::memory_order_release);
+                return n;
+            }
+
+            // Appelle f(cqe) pour chaque complétion disponible
+            template <typename F>
+            unsigned drain(F&& f) {
+                unsigned head = *cq_head_;
+                const unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+                unsigned n = 0;
+                for (; head != tail; ++head, ++n) {
+                    f(cqes_[head & *cq_mask_]);
+                }
+                std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+                return n;
+            }
+
+            unsigned sq_entries() const { return params_.sq_entries; }
+            std::uint64_t enter_calls() const { return enter_calls_; }
+
+        private:
+            ring(int fd, const io_uring_params& params) : fd_(fd), params_(params) {}
+
+            bool map(std::uint64_t& syscalls) {
+                sq_size_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+                cq_size_ = params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+                const bool single = (params_.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (single) {
+                    sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+                }
+                sq_ptr_ = ::mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+                ++syscalls;
+                if (sq_ptr_ == MAP_FAILED) return false;
+                if (single) {
+                    cq_ptr_ = sq_ptr_;
+                } else {
+                    cq_ptr_ = ::mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+                    ++syscalls;
+                    if (cq_ptr_ == MAP_FAILED) return false;
+                }
+                sqes_size_ = params_.sq_entries * sizeof(io_uring_sqe);
+                void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+                ++syscalls;
+                if (sqes == MAP_FAILED) return false;
+                sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+                auto* sq = static_cast<char*>(sq_ptr_);
+                sq_head_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.head);
+                sq_tail_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.tail);
+                sq_mask_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.ring_mask);
+                sq_array_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.array);
+                auto* cq = static_cast<char*>(cq_ptr_);
+                cq_head_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.head);
+                cq_tail_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.tail);
+                cq_mask_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.ring_mask);
+                cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params_.cq_off.cqes);
+                sqe_tail_ = *sq_tail_;
+                return true;
+            }
+
+            int fd_;
+            io_uring_params params_;
+            void* sq_ptr_ = MAP_FAILED;
+            void* cq_ptr_ = MAP_FAILED;
+            io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+            std::size_t sq_size_ = 0;
+            std::size_t cq_size_ = 0;
+            std::size_t sqes_size_ = 0;
+            unsigned* sq_head_ = nullptr;
+            unsigned* sq_tail_ = nullptr;
+            unsigned* sq_mask_ = nullptr;
+            unsigned* sq_array_ = nullptr;
+            unsigned* cq_head_ = nullptr;
+            unsigned* cq_tail_ = nullptr;
+            unsigned* cq_mask_ = nullptr;
+            io_uring_cqe* cqes_ = nullptr;
+            unsigned sqe_tail_ = 0;
+            std::uint64_t enter_calls_ = 0;
+        };
+
+        // Un fichier en vol : 4 opérations, le fichier est terminé quand les 4 sont revenues
+        struct slot {
+            enum op : unsigned { statx_op = 0, open_op = 1, read_op = 2, close_op = 3, op_count = 4 };
+
+            std::size_t file = 0;
+            unsigned completed = 0;
+            int results[op_count] = {};
+            struct statx stat{};
+        };
+
+        inline std::uint64_t user_data(unsigned slot, unsigned op) { return (std::uint64_t{slot} << 2) | op; }
+
+        // Lot complet avec io_uring ; nullopt si l'anneau ou les enregistrements sont refusés, si
+        // io_uring_enter échoue en cours de lot ou si openat / close sur descripteur direct rendent
+        // EINVAL (noyau antérieur à 5.15) : l'appelant reprend alors tout le lot sur des threads
+        inline std::optional<std::vector<load_result>> load_files(std::span<const std::string> paths,
+                                                                  const batch_options& options, batch_stats& stats) {
+            const unsigned depth = std::max(1u, options.queue_depth);
+            auto r = ring::create(depth * slot::op_count, stats.setup_calls);
+            if (!r) {
+                return std::nullopt;
+            }
+
+            // Tampons enregistrés : une zone contiguë découpée par slot
+            const std::size_t buffer_size = std::max<std::size_t>(options.buffer_size, 4096);
+            void* arena = ::mmap(nullptr, depth * buffer_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            ++stats.setup_calls;
+            if (arena == MAP_FAILED) {
+                return std::nullopt;
+            }
+            struct arena_guard {
+                void* p;
+                std::size_t n;
+                ~arena_guard() { ::munmap(p, n); }
+            } guard{arena, depth * buffer_size};
+            std::vector<iovec> buffers(depth);
+            for (unsigned i = 0; i < depth; ++i) {
+                buffers[i] = {static_cast<char*>(arena) + i * buffer_size, buffer_size};
+            }
+            stats.setup_calls += 2;
+            if (r->register_buffers(buffers.data(), depth) < 0 || r->register_sparse_files(depth) < 0) {
+                return std::nullopt;
+            }
+            stats.used_io_uring = true;
+
+            std::vector<load_result> results(paths.size());
+            std::vector<slot> slots(depth);
+            std::vector<unsigned> free_slots(depth);
+            for (unsigned i = 0; i < depth; ++i) free_slots[i] = depth - 1 - i;
+
+            std::size_t next = 0;
+            std::size_t done = 0;
+            std::size_t inflight = 0;   // opérations remises au noyau et pas encore revenues
+            bool abandoned = false;
+            while (done < paths.size() && !abandoned) {
+                // Tous les slots libres reçoivent un fichier : statx + openat -> read -> close
+                while (next < paths.size() && !free_slots.empty()) {
+                    const unsigned s = free_slots.back();
+                    free_slots.pop_back();
+                    slot& sl = slots[s];
+                    sl = {};
+                    sl.file = next;
+                    const char* path = paths[next].c_str();
+                    ++next;
+
+                    io_uring_sqe* sqe = r->next_sqe();
+                    sqe->opcode = IORING_OP_STATX;
+                    sqe->fd = AT_FDCWD;
+                    sqe->addr = reinterpret_cast<std::uint64_t>(path);
+                    sqe->len = STATX_SIZE | STATX_TYPE;
+                    sqe->off = reinterpret_cast<std::uint64_t>(&sl.stat);
+                    sqe->user_data = user_data(s, slot::statx_op);
+
+                    // Échec de openat : la lecture est annulée ; le close suit la lecture quoi qu'il arrive
+                    sqe = r->next_sqe();
+                    sqe->opcode = IORING_OP_OPENAT;
+                    sqe->fd = AT_FDCWD;
+                    sqe->addr = reinterpret_cast<std::uint64_t>(path);
+                    sqe->open_flags = O_RDONLY;
+                    sqe->file_index = s + 1;
+                    sqe->flags = IOSQE_IO_LINK;
+                    sqe->user_data = user_data(s, slot::open_op);
+
+                    sqe = r->next_sqe();
+                    sqe->opcode = IORING_OP_READ_FIXED;
+                    sqe->fd = static_cast<int>(s);
+                    sqe->addr = reinterpret_cast<std::uint64_t>(buffers[s].iov_base);
+                    sqe->len = static_cast<unsigned>(buffer_size);
+                    sqe->off = 0;
+                    sqe->buf_index = static_cast<std::uint16_t>(s);
+                    sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+                    sqe->user_data = user_data(s, slot::read_op);
+
+                    sqe = r->next_sqe();
+                    sqe->opcode = IORING_OP_CLOSE;
+                    sqe->file_index = s + 1;
+                    sqe->user_data = user_data(s, slot::close_op);
+                    inflight += slot::op_count;
+                }
+
+                if (r->submit_and_wait(1) < 0) {
+                    inflight -= r->retract();
+                    abandoned = true;
+                }
+
+                inflight -= r->drain([&](const io_uring_cqe& cqe) {
+                    const auto s = static_cast<unsigned>(cqe.user_data >> 2);
+                    const auto op = static_cast<unsigned>(cqe.user_data & 3);
+                    slot& sl = slots[s];
+                    sl.results[op] = cqe.res;
+                    if (cqe.res == -EINVAL && (op == slot::open_op || op == slot::close_op)) {
+                        abandoned = true;   // descripteurs directs non pris en charge
+                    }
+                    if (abandoned || ++sl.completed < slot::op_count) {
+                        return;
+                    }
+
+                    const std::string& path = paths[sl.file];
+                    const int opened = sl.results[slot::open_op];
+                    const int read = sl.results[slot::read_op];
+                    if (opened < 0) {
+                        results[sl.file] = std::unexpected(error{-opened, "openat", path});
+                    } else if (read < 0) {
+                        results[sl.file] = std::unexpected(error{-read, "read", path});
+                    } else if (static_cast<std::size_t>(read) == buffer_size ||
+                               (sl.results[slot::statx_op] == 0 && sl.stat.stx_size > static_cast<std::uint64_t>(read))) {
+                        // Plus grand qu'un tampon : projection mémoire
+                        ++stats.large_files;
+                        results[sl.file] = file_loader::load_file(path);
+                    } else {
+                        auto copy = std::make_unique_for_overwrite<std::byte[]>(static_cast<std::size_t>(read));
+                        std::memcpy(copy.get(), buffers[s].iov_base, static_cast<std::size_t>(read));
+                        results[sl.file] = mapped_file::from_buffer(std::move(copy), static_cast<std::size_t>(read));
+                    }
+                    ++done;
+                    free_slots.push_back(s);
+                });
+            }
+            // Lot abandonné : le noyau écrit encore dans slots (statx) et lit les chemins des
+            // opérations en vol ; l'anneau et ces tableaux ne sont libérés qu'après leur retour
+            while (inflight > 0) {
+                r->submit_and_wait(1);
+                inflight -= r->drain([](const io_uring_cqe&) {});
+            }
+            stats.enter_calls = r->enter_calls();
+            stats.setup_calls += 1;   // close de l'anneau
+            if (abandoned) {
+                return std::nullopt;
+            }
+            return results;
+        }
+
+    }  // namespace uring
+
+    // Repli : load_file sur un groupe de threads qui se partagent les fichiers
+    inline std::vector<load_result> load_files_threaded(std::span<const std::string> paths, unsigned threads) {
+        std::vector<load_result> results(paths.size());
+        std::atomic<std::size_t> next{0};
+        {
+            std::vector<std::jthread> workers;
+            for (unsigned t = 0; t < std::max(1u, threads); ++t) {
+                workers.emplace_back([&] {
+                    for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < paths.size();) {
+                        results[i] = load_file(paths[i]);
+                    }
+                });
+            }
+        }
+        return results;
+    }
+
+    // Un résultat par chemin, dans l'ordre des chemins
+    inline std::vector<load_result> load_files(std::span<const std::string> paths, const batch_options& options = {},
+                                               batch_stats* stats = nullptr) {
+        batch_stats local;
+        batch_stats& s = stats ? *stats : local;
+        s = {};
+        if (options.use_io_uring) {
+            if (auto results = uring::load_files(paths, options, s)) {
+                return std::move(*results);
+            }
+            s.used_io_uring = false;
+        }
+        return load_files_threaded(paths, options.fallback_threads);
+    }
+
+    // co_await load_files_async(paths) : le lot est chargé sur un thread dédié, la coroutine
+    // reprend sur ce thread avec les résultats
+    class load_files_async {
+    public:
+        explicit load_files_async(std::vector<std::string> paths, batch_options options = {})
+                : paths_(std::move(paths)), options_(options) {}
+
+        bool await_ready() const noexcept { return paths_.empty(); }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            std::thread([this, handle] {
+                results_ = load_files(paths_, options_);
+                handle.resume();
+            }).detach();
+        }
+
+        std::vector<load_result> await_resume() { return std::move(results_); }
+
+    private:
+        std::vector<std::string> paths_;
+        batch_options options_;
+        std::vector<load_result> results_;
+    };
+
+}  // namespace file_loader
+
+#endif //CPP_23_BATCH_LOADER_H
@@ -0,0 +1,116 @@
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "alloc_count.h"
+#include "async_log.h"
+#include "fetch_task.h"
+#include "hdr_histogram.h"
+#include "static_thread_pool.h"
+
+// Allocations cachées des chemins chauds du dépôt, par opération (100 000 itérations, nombre
+// en argument) : file du pool de threads, coroutine fetch_data de l'atelier 3 et son AsyncTask
+// (common/fetch_task.h, sans délai), concaténation de son résultat, tampon par connexion. Les chemins censés ne pas allouer (journal asynchrone,
+// histogramme) sont vérifiés sous alloc_count::forbid. Puis les sites d'allocation les plus
+// fréquents, en échantillonnant chaque allocation.
+
+namespace {
+
+    void row(const char* name, alloc_count::per_iteration cost) {
+        std::cout << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << cost.allocations << std::setw(14) << cost.bytes << '\n';
+    }
+
+    // Une tâche par itération, mesurée pour tout le processus : le worker libère ce que
+    // le thread appelant a alloué
+    template <typename Task>
+    alloc_count::per_iteration pool_cost(std::size_t tasks, Task task) {
+        std::execution::static_thread_pool pool(1, "bench", false);
+        const alloc_count::scope region;
+        for (std::size_t i = 0; i < tasks; ++i) pool.execute(task);
+        pool.wait();
+        return alloc_count::divide(region.process(), tasks);
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t iterations = argc > 1 ? std::stoul(argv[1]) : 100'000;
+    if (!alloc_count::installed()) {
+        std::cerr << "alloc_count.cpp n'est pas lié : compteurs inactifs\n";
+        return 1;
+    }
+
+    std::cout << iterations << " itérations\n"
+              << std::left << std::setw(44) << "opération" << std::right
+              << std::setw(14) << "allocs/op" << std::setw(14) << "octets/op" << '\n';
+
+    std::uint64_t sink = 0;
+    row("pool.execute, capture de 8 octets", pool_cost(iterations, [&sink] { ++sink; }));
+    std::array<std::uint64_t, 8> payload{};
+    row("pool.execute, capture de 64 octets", pool_cost(iterations, [payload, &sink] { sink += payload[0]; }));
+
+    // fetch_data puis get() : frame, poignée et drapeau partagés de l'AsyncTask, thread de reprise,
+    // chaîne du résultat et sa copie. Journal vers /dev/null : l'appel à log n'alloue pas.
+    const std::string request = "Request1";
+    {
+        async_log::session logging({.path = "/dev/null"});
+        row("fetch_data + get() (AsyncTask)", alloc_count::measure(iterations / 10, [&] {
+            fetch_task::AsyncTask task = fetch_task::fetch_data(request, {});
+            sink += task.get().size();
+        }));
+    }
+
+    // La concaténation de fetch_data seule : "Données reçues pour : " + request
+    row("\"Données reçues pour : \" + request", alloc_count::measure(iterations, [&] {
+        const std::string result = "Données reçues pour : " + request;
+        sink += result.size();
+    }));
+    std::string reused;
+    row("même chaîne, tampon réutilisé", alloc_count::measure(iterations, [&] {
+        reused.assign("Données reçues pour : ").append(request);
+        sink += reused.size();
+    }));
+
+    // Tampon de lecture par connexion
+    row("std::vector<char>(1024) par connexion", alloc_count::measure(iterations, [&] {
+        std::vector<char> buffer(1024);
+        sink += static_cast<std::uint64_t>(buffer[0]);
+    }));
+    std::vector<char> pooled;
+    row("même tampon, vidé et réutilisé", alloc_count::measure(iterations, [&] {
+        pooled.clear();
+        pooled.resize(1024);
+        sink += static_cast<std::uint64_t>(pooled[0]);
+    }));
+
+    // Chemins sans allocation, vérifiés : une allocation arrêterait le programme avec sa pile
+    {
+        async_log::session logging({.path = "/dev/null"});
+        async_log::info("échauffement {}", request);  // anneau du thread créé ici
+        hdr_histogram histogram(8, 40);
+        const alloc_count::scope region;
+        {
+            const alloc_count::forbid none;
+            for (std::size_t i = 0; i < iterations; ++i) {
+                async_log::info("Traitement de la requête : {} ({})", request, i);
+                histogram.record(i + 1);
+            }
+        }
+        row("async_log::info + hdr_histogram::record", alloc_count::divide(region.thread(), iterations));
+    }
+
+    alloc_count::set_sampling(1);
+    pool_cost(iterations / 10, [payload, &sink] { sink += payload[0]; });
+    for (std::size_t i = 0; i < iterations / 10; ++i) {
+        const std::string result = "Données reçues pour : " + request;
+        sink += result.size();
+    }
+    alloc_count::set_sampling(0);
+    std::cout << "\nsites les plus fréquents :\n";
+    alloc_count::print_top_sites(std::cout, 4);
+
+    return sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "checked_arith.h"
+
+// Opérations contrôlées sur des colonnes de 10 M d'entiers (taille en argument), 1 % de
+// dénominateurs nuls, des additions qui débordent rarement, des produits plus souvent :
+// boucle sur l'ancien safe_divide (std::expected<int, std::string>), boucle sur les versions
+// unitaires (std::expected<int, errc>), puis les versions par colonnes, scalaire et AVX2.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    // L'ancien safe_divide : une std::string construite à chaque erreur
+    std::expected<int, std::string> old_safe_divide(int numerator, int denominator) {
+        if (denominator == 0) {
+            return std::unexpected("Error: Division by zero");
+        }
+        return numerator / denominator;
+    }
+
+    template <typename Run>
+    void report(const char* name, std::size_t n, Run&& run) {
+        constexpr int rounds = 5;
+        std::size_t errors = 0;
+        const auto start = clock_type::now();
+        for (int r = 0; r < rounds; ++r) errors = run();
+        const double seconds = std::chrono::duration<double>(clock_type::now() - start).count() / rounds;
+        std::cout << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(12) << static_cast<double>(n) / seconds / 1e6 << std::setw(12) << errors << '\n';
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 10'000'000;
+    std::mt19937 rng(17);
+    std::vector<int> a(n), b(n), small(n), out(n);
+    std::vector<std::uint64_t> errors((n + 63) / 64);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = static_cast<int>(rng());
+        // Diviseurs de 1 à 2^16 en valeur absolue, 1 % de zéros
+        const int d = static_cast<int>(rng() % (1u << rng() % 17)) + 1;
+        b[i] = rng() % 100 == 0 ? 0 : (rng() & 1 ? d : -d);
+        // Multiplicandes jusqu'à 2^19 : le produit déborde une fois sur quelques-unes
+        small[i] = a[i] >> 12;
+    }
+
+    std::cout << n << " éléments, AVX2 : " << std::boolalpha << checked::detail::has_avx2() << '\n'
+              << std::left << std::setw(34) << "opération" << std::right << std::setw(12) << "M élém./s"
+              << std::setw(12) << "erreurs" << '\n';
+
+    report("divide : boucle safe_divide", n, [&] {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto r = old_safe_divide(a[i], b[i]);
+            out[i] = r.value_or(0);
+            count += !r;
+        }
+        return count;
+    });
+    report("divide : boucle expected<int, errc>", n, [&] {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto r = checked::divide(a[i], b[i]);
+            out[i] = r.value_or(0);
+            count += !r;
+        }
+        return count;
+    });
+    report("divide : colonnes scalaire", n, [&] { return checked::divide(a, b, out, errors, false); });
+    report("divide : colonnes AVX2", n, [&] { return checked::divide(a, b, out, errors); });
+
+    report("add : boucle expected<int, errc>", n, [&] {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto r = checked::add(a[i], b[i]);
+            out[i] = r.value_or(0);
+            count += !r;
+        }
+        return count;
+    });
+    report("add : colonnes scalaire", n, [&] { return checked::add(a, b, out, errors, false); });
+    report("add : colonnes AVX2", n, [&] { return checked::add(a, b, out, errors); });
+
+    report("multiply : boucle expected<int, errc>", n, [&] {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto r = checked::multiply(small[i], b[i]);
+            out[i] = r.value_or(0);
+            count += !r;
+        }
+        return count;
+    });
+    report("multiply : colonnes scalaire", n, [&] { return checked::multiply(small, b, out, errors, false); });
+    report("multiply : colonnes AVX2", n, [&] { return checked::multiply(small, b, out, errors); });
+    return 0;
+}
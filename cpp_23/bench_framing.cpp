@@ -0,0 +1,69 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "load_generator.h"
+#include "tcp_server.h"
+
+// Débit en messages/s du protocole à trames, serveur et client sur la même machine (loopback).
+// Pour chaque taille de payload : une requête à la fois par connexion, puis en pipeline.
+// Une réponse en erreur (connexion coupée, trame invalide) fait sortir avec le code 2,
+// comme load_generator.
+
+namespace {
+
+    load_generator::result measure(unsigned short port, std::size_t payload, std::size_t depth) {
+        load_generator::options opts;
+        opts.port = std::to_string(port);
+        opts.connections = 4;
+        opts.rate = 0;  // boucle fermée : on mesure le débit maximal
+        opts.duration = std::chrono::duration<double>(2);
+        opts.warmup = std::chrono::duration<double>(0.5);
+        opts.pipeline_depth = depth;
+        opts.sizes = {load_generator::size_distribution::kind::fixed, payload, payload};
+        return load_generator::run(opts);
+    }
+
+    double messages_per_second(const load_generator::result& result) {
+        return result.elapsed_s > 0 ? static_cast<double>(result.completed) / result.elapsed_s : 0.0;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t threads = argc > 1 ? std::stoul(argv[1]) : 2;
+
+    asio::io_context io_context(static_cast<int>(threads));
+    tcp_server::server server(io_context, 0);
+    server.start();
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([&io_context] { io_context.run(); });
+    }
+
+    std::cout << std::left << std::setw(10) << "payload"
+              << std::setw(18) << "depth 1 (msg/s)"
+              << std::setw(18) << "depth 32 (msg/s)"
+              << std::setw(10) << "erreurs" << '\n';
+    std::uint64_t errors = 0;
+    for (std::size_t payload : {std::size_t{64}, std::size_t{1024}, std::size_t{64 * 1024}}) {
+        const load_generator::result serial = measure(server.port(), payload, 1);
+        const load_generator::result pipelined = measure(server.port(), payload, 32);
+        const std::uint64_t row_errors = serial.errors + pipelined.errors;
+        errors += row_errors;
+        std::cout << std::setw(10) << payload
+                  << std::setw(18) << std::fixed << std::setprecision(0) << messages_per_second(serial)
+                  << std::setw(18) << messages_per_second(pipelined)
+                  << std::setw(10) << row_errors << '\n';
+    }
+    buffer_pool::write_counters(std::cout);
+
+    io_context.stop();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return errors == 0 ? 0 : 2;
+}
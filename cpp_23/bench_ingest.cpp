@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+#include <fcntl.h>
+#include "ingest.h"
+#include "json_index.h"
+#include "mapped_file.h"
+#include "xml_stream.h"
+
+// Lecture d'une liste de fichiers JSON et XML aux tailles très inégales (loi de Pareto :
+// beaucoup de fichiers de quelques Kio, quelques-uns de plusieurs dizaines de Mio).
+// Arguments : nombre de fichiers (20000 par défaut), nombre de workers (4 par défaut).
+// Boucle série, découpage statique de la liste en tranches contiguës, et ingest::run
+// (LPT, regroupement par type, vol). Les fichiers sont dans le cache de pages.
+// Un fichier illisible ou invalide dans la boucle série fait sortir avec le code 1.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+    namespace fs = std::filesystem;
+
+    struct XmlFile { std::string name; };
+    struct JsonFile { std::string name; };
+    using file = std::variant<XmlFile, JsonFile>;
+
+    // Même travail que le visiteur de l'exercice, sans affichage : XML lu en flux depuis le
+    // descripteur (tokenizer et tampon gardés d'un fichier à l'autre), JSON projeté puis indexé.
+    // Fichier illisible ou invalide : compté dans errors.
+    struct counting_visitor {
+        void operator()(const XmlFile& f) {
+            const file_loader::detail::fd_guard fd{::open(f.name.c_str(), O_RDONLY | O_CLOEXEC)};
+            if (fd.fd < 0) {
+                ++errors;
+                return;
+            }
+            if (xml) xml->reset(xml_stream::tokenizer::fd_reader(fd.fd));
+            else xml.emplace(xml_stream::tokenizer::from_fd(fd.fd));
+            for (;;) {
+                const auto token = xml->next();
+                if (!token) {
+                    ++errors;
+                    return;
+                }
+                if (token->type == xml_stream::kind::end_document) return;
+                ++values;
+            }
+        }
+
+        void operator()(const JsonFile& f) {
+            const auto content = file_loader::load_file(f.name);
+            if (!content) {
+                ++errors;
+                return;
+            }
+            if (const auto document = json.parse(content->view())) values += document->size();
+            else ++errors;
+        }
+
+        std::optional<xml_stream::tokenizer> xml;
+        json_index::parser json;
+        std::size_t values = 0;
+        std::size_t errors = 0;
+    };
+
+    void write_file(const std::string& path, bool json, std::size_t size) {
+        std::string content = json ? "[\n" : "<readings>\n";
+        for (std::size_t i = 0; content.size() < size; ++i) {
+            if (json) {
+                content += std::string(i == 0 ? "" : ",\n") + "{\"id\": " + std::to_string(i) +
+                           ", \"sensor\": \"s-12\", \"value\": 21.5, \"ok\": true}";
+            } else {
+                content += "<reading id=\"" + std::to_string(i) + "\" sensor=\"s-12\"><value>21.5</value><ok/></reading>\n";
+            }
+        }
+        content += json ? "\n]\n" : "</readings>\n";
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    void report(const char* name, double seconds, double serial, double imbalance, std::size_t steals) {
+        std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(10) << seconds * 1000 << std::setprecision(2) << std::setw(12) << serial / seconds
+                  << std::setw(16) << imbalance << std::setw(8) << steals << '\n';
+    }
+
+    // Temps du plus lent sur la moyenne : 1 = parfaitement équilibré
+    double imbalance(const std::vector<double>& busy) {
+        double sum = 0, slowest = 0;
+        for (const double b : busy) {
+            sum += b;
+            slowest = std::max(slowest, b);
+        }
+        return sum > 0 ? slowest / (sum / static_cast<double>(busy.size())) : 1.0;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t count = argc > 1 ? std::stoul(argv[1]) : 20000;
+    const unsigned workers = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 4;
+    const fs::path dir = fs::temp_directory_path() / "bench_ingest";
+    fs::create_directories(dir);
+
+    // Pareto (alpha 1.1) à partir de 2 Kio, plafonné à 64 Mio ; les gros fichiers tombent
+    // n'importe où dans la liste
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<file> files;
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto size = static_cast<std::size_t>(std::min(2048.0 / std::pow(1.0 - uniform(rng), 1.0 / 1.1), 64.0 * (1 << 20)));
+        const bool json = i % 2 == 0;
+        const std::string path = (dir / ("f" + std::to_string(i) + (json ? ".json" : ".xml"))).string();
+        write_file(path, json, size);
+        total += size;
+        files.push_back(json ? file{JsonFile{path}} : file{XmlFile{path}});
+    }
+
+    std::cout << count << " fichiers, " << total / (1 << 20) << " Mio, " << workers << " workers ("
+              << std::thread::hardware_concurrency() << " coeurs)\n"
+              << std::left << std::setw(24) << "répartition" << std::right << std::setw(10) << "ms"
+              << std::setw(12) << "accél." << std::setw(16) << "déséquilibre" << std::setw(8) << "vols" << '\n';
+
+    auto start = clock_type::now();
+    counting_visitor serial_visitor;
+    for (const auto& f : files) std::visit(serial_visitor, f);
+    const double serial = std::chrono::duration<double>(clock_type::now() - start).count();
+    report("boucle série", serial, serial, 1.0, 0);
+    if (serial_visitor.errors != 0) {
+        std::cerr << serial_visitor.errors << " fichiers illisibles ou invalides\n";
+        fs::remove_all(dir);
+        return 1;
+    }
+
+    // Tranches contiguës de la liste, une par thread
+    start = clock_type::now();
+    std::vector<double> busy(workers);
+    {
+        std::vector<std::jthread> threads;
+        for (unsigned w = 0; w < workers; ++w) {
+            threads.emplace_back([&, w] {
+                const auto begin = clock_type::now();
+                counting_visitor visitor;
+                for (std::size_t i = w * files.size() / workers; i < (w + 1) * files.size() / workers; ++i) {
+                    std::visit(visitor, files[i]);
+                }
+                busy[w] = std::chrono::duration<double>(clock_type::now() - begin).count();
+            });
+        }
+    }
+    report("découpage statique", std::chrono::duration<double>(clock_type::now() - start).count(), serial, imbalance(busy), 0);
+
+    start = clock_type::now();
+    const auto result = ingest::run(files, [] { return counting_visitor(); }, {.workers = workers});
+    const double balanced = std::chrono::duration<double>(clock_type::now() - start).count();
+    std::size_t steals = 0;
+    for (std::size_t w = 0; w < result.workers.size(); ++w) {
+        busy[w] = result.workers[w].busy_seconds;
+        steals += result.workers[w].steals;
+    }
+    report("LPT + vol (ingest)", balanced, serial, imbalance(busy), steals);
+    std::cout << "  dont stat : " << std::setprecision(1) << result.stat_seconds * 1000 << " ms\n";
+
+    fs::remove_all(dir);
+    return 0;
+}
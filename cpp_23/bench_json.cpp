@@ -0,0 +1,223 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+#include "json_index.h"
+
+// Lecture d'un document JSON de relevés (taille en Mio en argument, 64 par défaut) :
+// descente récursive classique construisant un arbre (std::map, std::vector, std::string)
+// contre l'indexation seule et la lecture complète en deux passes vers la bande.
+// Chaque lecteur compte ses valeurs, qui doivent coïncider.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    // Arbre JSON « classique » : une allocation par chaîne, tableau et objet
+    struct value;
+    using object = std::map<std::string, value, std::less<>>;
+    using array = std::vector<value>;
+    struct value {
+        std::variant<std::nullptr_t, bool, std::int64_t, double, std::string,
+                     std::unique_ptr<array>, std::unique_ptr<object>> data;
+    };
+
+    class recursive_parser {
+    public:
+        explicit recursive_parser(std::string_view input) : input_(input) {}
+
+        value parse() {
+            value v = parse_value();
+            skip_whitespace();
+            if (pos_ != input_.size()) fail();
+            return v;
+        }
+
+        std::size_t values() const { return values_; }
+
+    private:
+        [[noreturn]] void fail() const { throw std::runtime_error("JSON invalide à " + std::to_string(pos_)); }
+
+        void skip_whitespace() {
+            while (pos_ < input_.size() && json_index::detail::is_whitespace(input_[pos_])) ++pos_;
+        }
+
+        char peek() {
+            skip_whitespace();
+            if (pos_ == input_.size()) fail();
+            return input_[pos_];
+        }
+
+        void expect(char c) {
+            if (peek() != c) fail();
+            ++pos_;
+        }
+
+        std::string parse_string() {
+            expect('"');
+            std::string out;
+            while (pos_ < input_.size() && input_[pos_] != '"') {
+                char c = input_[pos_++];
+                if (c == '\\') {
+                    if (pos_ == input_.size()) fail();
+                    c = input_[pos_++];
+                    switch (c) {
+                        case 'n': c = '\n'; break;
+                        case 't': c = '\t'; break;
+                        case 'r': c = '\r'; break;
+                        case 'b': c = '\b'; break;
+                        case 'f': c = '\f'; break;
+                        default: break;    // \" \\ \/ ; \u non décodé
+                    }
+                }
+                out.push_back(c);
+            }
+            expect('"');
+            return out;
+        }
+
+        value parse_value() {
+            ++values_;
+            const char c = peek();
+            if (c == '{') {
+                ++pos_;
+                auto obj = std::make_unique<object>();
+                if (peek() != '}') {
+                    do {
+                        std::string key = parse_string();
+                        expect(':');
+                        obj->insert_or_assign(std::move(key), parse_value());
+                    } while (peek() == ',' && (++pos_, true));
+                }
+                expect('}');
+                return {std::move(obj)};
+            }
+            if (c == '[') {
+                ++pos_;
+                auto arr = std::make_unique<array>();
+                if (peek() != ']') {
+                    do {
+                        arr->push_back(parse_value());
+                    } while (peek() == ',' && (++pos_, true));
+                }
+                expect(']');
+                return {std::move(arr)};
+            }
+            if (c == '"') return {parse_string()};
+            if (input_.substr(pos_, 4) == "true") { pos_ += 4; return {true}; }
+            if (input_.substr(pos_, 5) == "false") { pos_ += 5; return {false}; }
+            if (input_.substr(pos_, 4) == "null") { pos_ += 4; return {nullptr}; }
+
+            const std::size_t start = pos_;
+            while (pos_ < input_.size() && std::string_view("+-0123456789.eE").find(input_[pos_]) != std::string_view::npos) ++pos_;
+            const std::string_view token = input_.substr(start, pos_ - start);
+            const char* first = token.data();
+            const char* last = first + token.size();
+            if (token.find_first_of(".eE") == std::string_view::npos) {
+                std::int64_t i;
+                if (std::from_chars(first, last, i).ptr == last) return {i};
+            }
+            double d;
+            if (token.empty() || std::from_chars(first, last, d).ptr != last) fail();
+            return {d};
+        }
+
+        std::string_view input_;
+        std::size_t pos_ = 0;
+        std::size_t values_ = 0;
+    };
+
+    std::string make_document(std::size_t size) {
+        std::mt19937 rng(5);
+        std::string out = "[\n";
+        for (std::size_t i = 0; out.size() < size; ++i) {
+            if (i != 0) out += ",\n";
+            out += "  {\"id\": " + std::to_string(i) +
+                   ", \"name\": \"sensor-" + std::to_string(rng() % 1000) + "\"" +
+                   ", \"value\": " + std::to_string(static_cast<double>(rng() % 100000) / 100.0) +
+                   ", \"ok\": " + (rng() % 8 != 0 ? "true" : "false") +
+                   ", \"unit\": null" +
+                   ", \"tags\": [\"hall\", \"floor-" + std::to_string(rng() % 10) + "\", \"a \\\"quoted\\\\\\\" tag\"]" +
+                   ", \"position\": {\"x\": " + std::to_string(rng() % 500) + ", \"y\": -" + std::to_string(rng() % 500) + "}}";
+        }
+        out += "\n]\n";
+        return out;
+    }
+
+    template <typename Read>
+    double gb_per_second(std::size_t size, int rounds, Read&& read) {
+        const auto start = clock_type::now();
+        for (int i = 0; i < rounds; ++i) read();
+        const double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+        return static_cast<double>(size) * rounds / seconds / 1e9;
+    }
+
+    void report(const char* name, double rate, std::size_t values) {
+        std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << rate << std::setw(14) << values << '\n';
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t mib = argc > 1 ? std::stoul(argv[1]) : 64;
+    const std::string document = make_document(mib << 20);
+    constexpr int rounds = 3;
+
+    std::cout << document.size() / (1 << 20) << " Mio, AVX2 : " << std::boolalpha
+              << json_index::detail::has_avx2() << '\n'
+              << std::left << std::setw(28) << "lecteur" << std::right << std::setw(10) << "Go/s"
+              << std::setw(14) << "valeurs" << '\n';
+
+    std::size_t recursive_values = 0;
+    const double recursive = gb_per_second(document.size(), rounds, [&] {
+        recursive_parser parser(document);
+        const value root = parser.parse();
+        recursive_values = parser.values();
+    });
+    report("descente récursive (arbre)", recursive, recursive_values);
+
+    json_index::structural_index structurals;
+    const double indexed = gb_per_second(document.size(), rounds, [&] { structurals.build(document); });
+    report("passe 1 : indexation", indexed, structurals.size());
+
+    const double scalar = gb_per_second(document.size(), rounds, [&] { structurals.build(document, false); });
+    report("passe 1 sans SIMD", scalar, structurals.size());
+
+    // Le parser garde ses tampons : à partir du second tour, aucune allocation
+    json_index::parser parser;
+    std::size_t tape_values = 0;
+    const double two_stage = gb_per_second(document.size(), rounds, [&] {
+        const auto doc = parser.parse(document);
+        if (!doc) throw std::runtime_error(doc.error().message);
+        tape_values = 0;
+        for (const auto& e : *doc) {
+            tape_values += e.type != json_index::kind::key && e.type != json_index::kind::object_end &&
+                           e.type != json_index::kind::array_end;
+        }
+    });
+    report("deux passes (bande)", two_stage, tape_values);
+
+    if (tape_values != recursive_values) {
+        std::cerr << "nombre de valeurs différent\n";
+        return 1;
+    }
+
+    // Erreurs : position et message, sans exception ; un document accepté fait échouer le test.
+    // Chaînes : caractère de contrôle brut (tabulation, retour à la ligne) et échappements invalides.
+    bool rejected = true;
+    for (const std::string_view bad : {"{\"a\": [1, 2}", "[\"non fermée]", "{\"a\" 1}", "[1, 2] 3", "[\"a\tb\"]",
+                                       "{\"a\nb\": 1}", "[\"\\x\"]", "[\"\\u12G4\"]", "[\"\\u12\"]"}) {
+        const auto doc = parser.parse(bad);
+        rejected &= !doc;
+        std::cout << std::left << std::setw(16) << bad << " -> "
+                  << (doc ? "accepté ?" : std::to_string(doc.error().offset) + " : " + doc.error().message) << '\n';
+    }
+    return rejected ? 0 : 1;
+}
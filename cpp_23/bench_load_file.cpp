@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+
+// Chargement d'un fichier entier, de 1 Mio à la taille max donnée en argument (Mio, 1024 par défaut,
+// 4096 pour aller jusqu'à 4 Gio) : l'ancien load_file (istreambuf_iterator dans un std::string)
+// contre mmap, mmap + MAP_POPULATE et la lecture en blocs. Chaque variante parcourt ensuite tout
+// le contenu (somme des octets) : une projection n'est pas gratuite tant qu'on ne touche pas les pages.
+// Les fichiers viennent d'être écrits, ils sont donc dans le cache de pages.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    std::uint64_t checksum(std::string_view data) {
+        std::uint64_t sum = 0;
+        for (const char c : data) sum += static_cast<unsigned char>(c);
+        return sum;
+    }
+
+    std::string load_with_stream(const std::string& path) {
+        std::ifstream file(path);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    void write_file(const std::string& path, std::size_t size) {
+        std::vector<char> block(1 << 20);
+        for (std::size_t i = 0; i < block.size(); ++i) block[i] = static_cast<char>('a' + i % 26);
+        std::ofstream out(path, std::ios::binary);
+        for (std::size_t written = 0; written < size; written += block.size()) {
+            out.write(block.data(), static_cast<std::streamsize>(std::min(block.size(), size - written)));
+        }
+    }
+
+    template <typename Load>
+    double gib_per_second(std::size_t size, Load&& load) {
+        const auto start = clock_type::now();
+        const std::uint64_t sum = load();
+        const double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+        if (sum == 0) std::cout << "";
+        return static_cast<double>(size) / seconds / (1 << 30);
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t max_mib = argc > 1 ? std::stoul(argv[1]) : 1024;
+    const std::string dir = argc > 2 ? argv[2] : "/tmp";
+    const std::string path = dir + "/bench_load_file.dat";
+
+    std::cout << std::left << std::setw(10) << "taille" << std::right
+              << std::setw(14) << "istreambuf" << std::setw(14) << "mmap" << std::setw(14) << "populate"
+              << std::setw(14) << "read" << "   (Gio/s)\n";
+
+    for (std::size_t mib = 1; mib <= max_mib; mib *= 4) {
+        const std::size_t size = mib << 20;
+        write_file(path, size);
+
+        // L'ancien chargeur double la mémoire et devient très lent : limité à 1 Gio
+        const double stream = mib <= 1024 ? gib_per_second(size, [&] { return checksum(load_with_stream(path)); }) : 0.0;
+        const double mapped = gib_per_second(size, [&] { return checksum(file_loader::load_file(path)->view()); });
+        const double populated = gib_per_second(size, [&] {
+            return checksum(file_loader::load_file(path, {.populate = true})->view());
+        });
+        const double read = gib_per_second(size, [&] {
+            return checksum(file_loader::load_file(path, {.allow_mmap = false})->view());
+        });
+
+        std::cout << std::left << std::setw(10) << (std::to_string(mib) + " Mio") << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(14) << stream << std::setw(14) << mapped
+                  << std::setw(14) << populated << std::setw(14) << read << '\n';
+    }
+    std::remove(path.c_str());
+
+    // Taille annoncée nulle : lecture en blocs
+    if (auto status = file_loader::load_file("/proc/self/status")) {
+        std::cout << "/proc/self/status : " << status->size() << " octets, projeté : " << std::boolalpha << status->is_mapped() << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "async_log.h"
+
+// Coût d'un appel de journalisation dans le thread appelant, de 1 à 32 threads producteurs,
+// 100 000 messages chacun (nombre en argument) du genre de processSensorData :
+// std::cout << ... << std::endl (sortie standard redirigée vers /dev/null), puis async_log
+// en texte et en binaire, avec les politiques drop et block (anneaux de 1 Mio).
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    // Nanosecondes par appel, moyenne des threads
+    template <typename Log>
+    double ns_per_call(unsigned threads, std::size_t calls, Log&& log) {
+        std::vector<double> ns(threads);
+        {
+            std::vector<std::jthread> producers;
+            for (unsigned t = 0; t < threads; ++t) {
+                producers.emplace_back([&, t] {
+                    const auto start = clock_type::now();
+                    for (std::size_t i = 0; i < calls; ++i) log(static_cast<int>(t), i);
+                    ns[t] = std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / static_cast<double>(calls);
+                });
+            }
+        }
+        double sum = 0;
+        for (double v : ns) sum += v;
+        return sum / threads;
+    }
+
+    double with_async_log(unsigned threads, std::size_t calls, async_log::config settings) {
+        async_log::session logging(std::move(settings));
+        return ns_per_call(threads, calls, [](int sensor, std::size_t i) {
+            async_log::info("Sensor {}: temperature {} °C, state {}", sensor, 20.0f + static_cast<float>(i % 100) / 10, "nominal");
+        });
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t calls = argc > 1 ? std::stoul(argv[1]) : 100'000;
+    const std::string binary_path = "/tmp/bench_log.alog";
+
+    std::cout << calls << " messages par thread, " << std::thread::hardware_concurrency() << " coeurs (ns par appel)\n"
+              << std::setw(8) << "threads" << std::setw(14) << "cout+endl" << std::setw(14) << "texte drop"
+              << std::setw(14) << "binaire drop" << std::setw(14) << "binaire block" << std::setw(12) << "perdus" << '\n';
+
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u}) {
+        // std::cout réel (verrou du flux, flush par ligne) vers /dev/null
+        std::cout.flush();
+        const int saved = ::dup(STDOUT_FILENO);
+        const int null = ::open("/dev/null", O_WRONLY);
+        ::dup2(null, STDOUT_FILENO);
+        const double stream = ns_per_call(threads, calls, [](int sensor, std::size_t i) {
+            std::cout << "Sensor " << sensor << ": temperature " << 20.0f + static_cast<float>(i % 100) / 10
+                      << " °C, state " << "nominal" << std::endl;
+        });
+        ::dup2(saved, STDOUT_FILENO);
+        ::close(saved);
+        ::close(null);
+
+        const std::uint64_t lost_before = async_log::dropped();
+        const double text = with_async_log(threads, calls, {.path = "/dev/null"});
+        const double binary = with_async_log(threads, calls, {.path = binary_path, .format = async_log::output::binary});
+        const std::uint64_t lost = async_log::dropped() - lost_before;
+        const double blocking = with_async_log(threads, calls, {.path = binary_path, .format = async_log::output::binary,
+                                                                .policy = async_log::overflow::block});
+
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(0) << std::setw(14) << stream
+                  << std::setw(14) << text << std::setw(14) << binary << std::setw(14) << blocking
+                  << std::setw(12) << lost << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "load_generator.h"
+#include "tcp_server.h"
+
+// Comportement en surcharge : un serveur à un thread avec un coût de traitement simulé.
+// On mesure d'abord son débit maximal (boucle fermée), puis on l'attaque en boucle ouverte
+// au double de ce débit, sans puis avec délestage. Sans délestage la file grossit pendant
+// tout le test et la latence avec elle ; avec délestage les requêtes servies gardent une
+// latence bornée et le surplus reçoit tout de suite une réponse `overloaded`.
+// Enfin un client lent, serveur au repos : sa requête, envoyée par petits morceaux pendant
+// bien plus que queue_deadline, ne doit pas être délestée (code de sortie 1 sinon).
+
+namespace {
+
+    // Un serveur et son thread, arrêté à la destruction
+    class test_server {
+    public:
+        explicit test_server(const tcp_server::options& opts) : io_(1), server_(io_, 0, opts) {
+            server_.start();
+            thread_ = std::thread([this] { io_.run(); });
+        }
+
+        ~test_server() {
+            io_.stop();
+            thread_.join();
+        }
+
+        unsigned short port() const { return server_.port(); }
+        const admission::controller& admission() const { return server_.admission(); }
+
+    private:
+        asio::io_context io_;
+        tcp_server::server server_;
+        std::thread thread_;
+    };
+
+    load_generator::options load(unsigned short port, double rate) {
+        load_generator::options opts;
+        opts.port = std::to_string(port);
+        opts.connections = 16;
+        opts.rate = rate;
+        opts.duration = std::chrono::duration<double>(3);
+        opts.warmup = std::chrono::duration<double>(0.5);
+        opts.pipeline_depth = rate > 0 ? 256 : 8;
+        opts.sizes = {load_generator::size_distribution::kind::fixed, 64, 64};
+        return opts;
+    }
+
+    void print(const std::string& label, const load_generator::result& r) {
+        auto ms = [&r](double percentile) { return static_cast<double>(r.latency.value_at_percentile(percentile)) / 1e6; };
+        const double elapsed = r.elapsed_s > 0 ? r.elapsed_s : 1;
+        std::cout << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(12) << static_cast<double>(r.completed) / elapsed
+                  << std::setw(12) << static_cast<double>(r.rejected) / elapsed
+                  << std::setprecision(2)
+                  << std::setw(12) << ms(50)
+                  << std::setw(12) << ms(99)
+                  << std::setw(12) << static_cast<double>(r.latency.max()) / 1e6 << '\n';
+    }
+
+    // Une trame de 8000 octets en 200 morceaux espacés de 2 ms : plus de lectures que l'anneau
+    // des arrivées n'a de places, et 0,4 s au total. Renvoie le type de la réponse.
+    framing::message_type slow_upload(unsigned short port) {
+        using asio::ip::tcp;
+        asio::io_context io;
+        tcp::socket socket(io);
+        socket.connect({asio::ip::make_address("127.0.0.1"), port});
+        socket.set_option(tcp::no_delay(true));
+
+        constexpr std::size_t payload = 8000, pieces = 200;
+        std::vector<std::uint8_t> frame(framing::max_header_size);
+        frame.resize(framing::encode_header(framing::message_type::echo_request, payload, frame.data()));
+        frame.resize(frame.size() + payload, 'x');
+        const std::size_t step = (frame.size() + pieces - 1) / pieces;
+        for (std::size_t sent = 0; sent < frame.size(); sent += step) {
+            asio::write(socket, asio::buffer(frame.data() + sent, std::min(step, frame.size() - sent)));
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+
+        // En-tête de la réponse : varint puis type
+        std::uint8_t byte = 0x80;
+        while (byte & 0x80) {
+            asio::read(socket, asio::buffer(&byte, 1));
+        }
+        asio::read(socket, asio::buffer(&byte, 1));
+        return static_cast<framing::message_type>(byte);
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const auto work = std::chrono::microseconds(argc > 1 ? std::stoul(argv[1]) : 20);
+
+    tcp_server::options server_opts;
+    server_opts.simulated_work = work;
+
+    double saturation = 0;
+    {
+        server_opts.limits.shedding = false;
+        test_server server(server_opts);
+        const load_generator::result r = load_generator::run(load(server.port(), 0));
+        saturation = static_cast<double>(r.completed) / r.elapsed_s;
+    }
+    std::cout << "travail simulé " << work.count() << " us, saturation ~" << std::fixed << std::setprecision(0)
+              << saturation << " req/s, charge offerte " << 2 * saturation << " req/s\n\n";
+
+    std::cout << std::left << std::setw(22) << "mode" << std::right
+              << std::setw(12) << "servies/s" << std::setw(12) << "rejets/s"
+              << std::setw(12) << "p50 (ms)" << std::setw(12) << "p99 (ms)" << std::setw(12) << "max (ms)" << '\n';
+
+    for (const bool shedding : {false, true}) {
+        server_opts.limits.shedding = shedding;
+        test_server server(server_opts);
+        const load_generator::result r = load_generator::run(load(server.port(), 2 * saturation));
+        print(shedding ? "délestage" : "sans délestage", r);
+        if (shedding) {
+            server.admission().write_counters(std::cout);
+        }
+    }
+
+    server_opts.limits.shedding = true;
+    test_server idle(server_opts);
+    const framing::message_type reply = slow_upload(idle.port());
+    const bool served = reply == framing::message_type::echo_response;
+    std::cout << "\nclient lent (0,4 s) : " << (served ? "servi" : "délesté ou erreur, code ")
+              << (served ? "" : std::to_string(static_cast<int>(reply))) << '\n';
+    return served ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "point_batch.h"
+
+// Transformations d'un nuage de points (4 M par défaut, taille en argument) : tableau de Point
+// (AoS, une boucle par opération comme on l'écrirait avec Point) contre PointBatch (SoA)
+// en scalaire, en AVX2, puis en AVX2 sur tous les coeurs.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    struct Point {
+        int x, y;
+    };
+
+    template <typename Run>
+    double points_per_second(std::size_t n, Run&& run) {
+        constexpr int rounds = 10;
+        const auto start = clock_type::now();
+        for (int r = 0; r < rounds; ++r) run();
+        return static_cast<double>(n) * rounds / std::chrono::duration<double>(clock_type::now() - start).count() / 1e6;
+    }
+
+    void report(const char* name, double aos, double scalar, double simd, double parallel) {
+        std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(12) << aos << std::setw(14) << scalar << std::setw(12) << simd
+                  << std::setw(14) << parallel << '\n';
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 4'000'000;
+    std::mt19937 rng(5);
+    std::vector<Point> points(n);
+    for (auto& p : points) p = {static_cast<int>(rng() % 200000) - 100000, static_cast<int>(rng() % 200000) - 100000};
+    auto batch = geometry::PointBatch::fromPoints(points);
+
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const geometry::Parallel scalar{.simd = false};
+    const geometry::Parallel simd{};
+    const geometry::Parallel parallel{.threads = cores};
+    const auto rotation = geometry::Affine::rotation(0.01);
+
+    std::cout << n << " points, " << cores << " coeurs (M points/s)\n"
+              << std::left << std::setw(12) << "opération" << std::right << std::setw(12) << "AoS"
+              << std::setw(14) << "SoA scalaire" << std::setw(12) << "SoA AVX2" << std::setw(14) << "AVX2 threads" << '\n';
+
+    report("translate",
+           points_per_second(n, [&] { for (auto& p : points) { p.x += 3; p.y -= 2; } }),
+           points_per_second(n, [&] { batch.translate(3, -2, scalar); }),
+           points_per_second(n, [&] { batch.translate(3, -2, simd); }),
+           points_per_second(n, [&] { batch.translate(3, -2, parallel); }));
+
+    report("reflect",
+           points_per_second(n, [&] { for (auto& p : points) p = {-p.x, -p.y}; }),
+           points_per_second(n, [&] { batch.reflect(scalar); }),
+           points_per_second(n, [&] { batch.reflect(simd); }),
+           points_per_second(n, [&] { batch.reflect(parallel); }));
+
+    report("rotate",
+           points_per_second(n, [&] {
+               for (auto& p : points) {
+                   const double x = p.x, y = p.y;
+                   p = {static_cast<int>(std::nearbyint(rotation.a * x + rotation.b * y)),
+                        static_cast<int>(std::nearbyint(rotation.c * x + rotation.d * y))};
+               }
+           }),
+           points_per_second(n, [&] { batch.affine(rotation, scalar); }),
+           points_per_second(n, [&] { batch.affine(rotation, simd); }),
+           points_per_second(n, [&] { batch.affine(rotation, parallel); }));
+
+    // Aller-retour vers std::vector<Point>
+    const auto start = clock_type::now();
+    const auto back = geometry::PointBatch::fromPoints(batch.toPoints<Point>());
+    std::cout << "conversion aller-retour : " << std::setprecision(1)
+              << std::chrono::duration<double, std::milli>(clock_type::now() - start).count() << " ms\n";
+    return back.size() == n ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "static_thread_pool.h"
+
+// Coût des métriques de static_thread_pool : 200 000 tâches (nombre en argument) vides, de ~1 µs
+// et de ~10 µs, sur 1 worker et sur un par coeur, pool instrumenté ou non. Meilleur de 5 tours
+// en alternant les deux versions, pour que le bruit de la machine touche les deux pareil.
+// Puis le coût d'un instantané et de sa mise au format Prometheus pendant que le pool tourne.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    std::uint64_t spin(std::uint64_t iterations) {
+        std::uint64_t x = 88172645463325252ULL;
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+        return x;
+    }
+
+    // Secondes pour exécuter `tasks` tâches de `work` itérations
+    double run(std::size_t threads, std::size_t tasks, std::uint64_t work, bool instrumented) {
+        std::vector<std::uint64_t> sink(threads * 8);
+        const auto start = clock_type::now();
+        {
+            std::execution::static_thread_pool pool(threads, "bench", instrumented);
+            for (std::size_t i = 0; i < tasks; ++i) {
+                pool.execute([&sink, i, work, threads] { sink[i % threads * 8] += spin(work); });
+            }
+            pool.wait();
+        }
+        return std::chrono::duration<double>(clock_type::now() - start).count();
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t tasks = argc > 1 ? std::stoul(argv[1]) : 200'000;
+    const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << tasks << " tâches, " << cores << " coeurs\n"
+              << std::left << std::setw(10) << "workers" << std::setw(10) << "tâche" << std::right
+              << std::setw(16) << "sans (k/s)" << std::setw(16) << "avec (k/s)" << std::setw(12) << "surcoût" << '\n';
+
+    for (std::size_t threads : {std::size_t{1}, cores}) {
+        for (const auto& [name, work] : {std::pair{"vide", 0ull}, {"~1 µs", 300ull}, {"~10 µs", 3000ull}}) {
+            double plain = 1e30, instrumented = 1e30;
+            for (int round = 0; round < 5; ++round) {
+                plain = std::min(plain, run(threads, tasks, work, false));
+                instrumented = std::min(instrumented, run(threads, tasks, work, true));
+            }
+            std::cout << std::left << std::setw(10) << threads << std::setw(10) << name << std::right << std::fixed
+                      << std::setprecision(0) << std::setw(16) << static_cast<double>(tasks) / plain / 1e3
+                      << std::setw(16) << static_cast<double>(tasks) / instrumented / 1e3 << std::setprecision(1)
+                      << std::setw(11) << (instrumented / plain - 1) * 100 << "%\n";
+        }
+        if (threads == cores && cores == 1) break;
+    }
+
+    // Instantanés pendant que les workers exécutent des tâches
+    std::execution::static_thread_pool pool(cores, "bench");
+    for (std::size_t i = 0; i < tasks; ++i) pool.execute([] { spin(300); });
+    constexpr int snapshots = 100;
+    std::string text;
+    const auto start = clock_type::now();
+    for (int i = 0; i < snapshots; ++i) text = runtime_metrics::to_prometheus(pool.metrics());
+    const double us = std::chrono::duration<double, std::micro>(clock_type::now() - start).count() / snapshots;
+    pool.wait();
+    std::cout << "instantané + Prometheus : " << std::setprecision(0) << us << " µs (" << text.size() << " octets)\n\n"
+              << runtime_metrics::to_prometheus(pool.metrics());
+    return 0;
+}
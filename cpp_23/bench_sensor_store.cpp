@@ -0,0 +1,150 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "sensor_store.h"
+
+// Store colonnaire compressé contre un simple vecteur de relevés par capteur :
+// octets par relevé, débit d'insertion et débit de parcours d'une plage de temps.
+// Le flux simulé ressemble à celui de workshop_6libcoro.cpp : un relevé par seconde et par
+// capteur (avec un peu de gigue), températures, pressions et états selon l'identifiant.
+
+namespace {
+
+    using SensorData = sensor_store::value;
+    using clock_type = std::chrono::steady_clock;
+
+    struct reading {
+        int sensor;
+        sensor_store::timestamp time;
+        SensorData data;
+    };
+
+    std::vector<reading> simulate(int sensors, int ticks) {
+        std::mt19937 rng(7);
+        std::vector<float> temperature(sensors, 25.3f);
+        std::vector<int> pressure(sensors, 1013);
+        std::vector<reading> readings;
+        readings.reserve(static_cast<std::size_t>(sensors) * ticks);
+        for (int tick = 0; tick < ticks; ++tick) {
+            for (int id = 0; id < sensors; ++id) {
+                sensor_store::timestamp t = 1'700'000'000'000'000 + std::int64_t{tick} * 1'000'000;
+                if (rng() % 10 == 0) t += static_cast<std::int64_t>(rng() % 2000);
+                if (id % 3 == 0) {
+                    if (rng() % 4 == 0) temperature[id] += static_cast<float>(static_cast<int>(rng() % 5) - 2) / 10.0f;
+                    readings.push_back({id, t, temperature[id]});
+                } else if (id % 3 == 1) {
+                    if (rng() % 4 == 0) pressure[id] += static_cast<int>(rng() % 5) - 2;
+                    readings.push_back({id, t, pressure[id]});
+                } else {
+                    readings.push_back({id, t, std::string(rng() % 100 == 0 ? "WARN" : "OK")});
+                }
+            }
+        }
+        return readings;
+    }
+
+    // Référence : un vecteur de (temps, SensorData) par capteur
+    struct vector_store {
+        struct sample {
+            sensor_store::timestamp time;
+            SensorData data;
+        };
+
+        void append(int sensor, sensor_store::timestamp t, const SensorData& v) { series[sensor].push_back({t, v}); }
+
+        template <typename F>
+        void scan(int sensor, sensor_store::timestamp from, sensor_store::timestamp to, F&& f) const {
+            const auto it = series.find(sensor);
+            if (it == series.end()) return;
+            const auto& v = it->second;
+            auto first = std::lower_bound(v.begin(), v.end(), from, [](const sample& s, sensor_store::timestamp t) { return s.time < t; });
+            for (; first != v.end() && first->time <= to; ++first) f(*first);
+        }
+
+        std::size_t memory_bytes() const {
+            std::size_t bytes = 0;
+            for (const auto& [id, v] : series) {
+                bytes += v.capacity() * sizeof(sample);
+                for (const auto& s : v) {
+                    if (const auto* str = std::get_if<std::string>(&s.data); str && str->capacity() > 15) bytes += str->capacity();
+                }
+            }
+            return bytes;
+        }
+
+        std::unordered_map<int, std::vector<sample>> series;
+    };
+
+    double seconds_since(clock_type::time_point start) {
+        return std::chrono::duration<double>(clock_type::now() - start).count();
+    }
+
+    void report(const char* name, std::size_t samples, std::size_t bytes, double ingest_s, double scan_s, std::size_t scanned) {
+        std::cout << std::left << std::setw(22) << name << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(14) << static_cast<double>(bytes) / static_cast<double>(samples)
+                  << std::setprecision(1) << std::setw(16) << static_cast<double>(samples) / ingest_s / 1e6
+                  << std::setw(16) << static_cast<double>(scanned) / scan_s / 1e6 << '\n';
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const int sensors = argc > 1 ? std::stoi(argv[1]) : 1000;
+    const int ticks = argc > 2 ? std::stoi(argv[2]) : 3600;
+
+    const std::vector<reading> readings = simulate(sensors, ticks);
+    // Plage parcourue : la dernière moitié de la période
+    const sensor_store::timestamp from = readings[readings.size() / 2].time;
+    const sensor_store::timestamp to = readings.back().time + 10'000;
+
+    std::cout << readings.size() << " relevés, " << sensors << " capteurs\n";
+    std::cout << std::left << std::setw(22) << "stockage" << std::right
+              << std::setw(14) << "octets/relevé" << std::setw(16) << "insertion M/s" << std::setw(16) << "parcours M/s" << '\n';
+
+    {
+        sensor_store::store store(1024);
+        auto start = clock_type::now();
+        for (const auto& r : readings) store.append(r.sensor, r.time, r.data);
+        const double ingest = seconds_since(start);
+
+        std::size_t scanned = 0;
+        double sum = 0;
+        start = clock_type::now();
+        for (int id = 0; id < sensors; ++id) {
+            store.scan(id, from, to, [&](const sensor_store::sample_view& s) {
+                ++scanned;
+                if (const float* f = std::get_if<float>(&s.data)) sum += *f;
+            });
+        }
+        const double scan = seconds_since(start);
+        report("colonnes compressées", readings.size(), store.encoded_bytes(), ingest, scan, scanned);
+        std::cout << "  (mémoire allouée : " << std::setprecision(2)
+                  << static_cast<double>(store.memory_bytes()) / static_cast<double>(readings.size())
+                  << " octets/relevé, somme " << sum << ")\n";
+    }
+
+    {
+        vector_store store;
+        auto start = clock_type::now();
+        for (const auto& r : readings) store.append(r.sensor, r.time, r.data);
+        const double ingest = seconds_since(start);
+
+        std::size_t scanned = 0;
+        double sum = 0;
+        start = clock_type::now();
+        for (int id = 0; id < sensors; ++id) {
+            store.scan(id, from, to, [&](const vector_store::sample& s) {
+                ++scanned;
+                if (const float* f = std::get_if<float>(&s.data)) sum += *f;
+            });
+        }
+        const double scan = seconds_since(start);
+        report("vector<SensorData>", readings.size(), store.memory_bytes(), ingest, scan, scanned);
+        std::cout << "  (somme " << sum << ")\n";
+    }
+    return 0;
+}
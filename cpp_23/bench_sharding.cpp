@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "load_generator.h"
+#include "tcp_server.h"
+
+// Passage à l'échelle de 1 à N cœurs : un io_context partagé par tous les threads
+// contre un shard par cœur (SO_REUSEPORT, threads épinglés, état local).
+// Client et serveur tournent sur la même machine : le client prend lui aussi du CPU.
+
+namespace {
+
+    double messages_per_second(unsigned short port, std::size_t cores) {
+        load_generator::options opts;
+        opts.port = std::to_string(port);
+        opts.connections = 8 * cores;
+        opts.threads = cores;
+        opts.rate = 0;
+        opts.duration = std::chrono::duration<double>(2);
+        opts.warmup = std::chrono::duration<double>(0.5);
+        opts.pipeline_depth = 16;
+        opts.sizes = {load_generator::size_distribution::kind::fixed, 64, 64};
+        const load_generator::result result = load_generator::run(opts);
+        return result.elapsed_s > 0 ? static_cast<double>(result.completed) / result.elapsed_s : 0.0;
+    }
+
+    double run_shared(std::size_t cores) {
+        asio::io_context io_context(static_cast<int>(cores));
+        tcp_server::server server(io_context, 0);
+        server.start();
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < cores; ++i) {
+            workers.emplace_back([&io_context] { io_context.run(); });
+        }
+        const double rate = messages_per_second(server.port(), cores);
+        io_context.stop();
+        for (auto& worker : workers) worker.join();
+        return rate;
+    }
+
+    double run_sharded(std::size_t cores) {
+        tcp_server::sharded_server server(cores, 0);
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < cores; ++i) {
+            workers.emplace_back([&server, i] { server.run_shard(i); });
+        }
+        const double rate = messages_per_second(server.port(), cores);
+        server.stop();
+        for (auto& worker : workers) worker.join();
+        return rate;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t max_cores = argc > 1 ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    std::cout << std::left << std::setw(8) << "cores"
+              << std::setw(18) << "shared (msg/s)"
+              << std::setw(18) << "sharded (msg/s)" << '\n';
+    for (std::size_t cores = 1; cores <= max_cores; cores *= 2) {
+        const double shared = run_shared(cores);
+        const double sharded = run_sharded(cores);
+        std::cout << std::setw(8) << cores
+                  << std::setw(18) << std::fixed << std::setprecision(0) << shared
+                  << std::setw(18) << sharded << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "window_aggregate.h"
+
+// Coût d'une mise à jour de la fenêtre glissante selon sa taille : agrégation incrémentale
+// contre un recalcul complet (tri partiel pour les quantiles) à chaque publication.
+// Un second thread lit les instantanés en continu pendant la mesure.
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    // Référence : on garde la fenêtre et on recalcule tout à chaque publication
+    struct naive_window {
+        explicit naive_window(window_aggregate::timestamp width) : width(width) {}
+
+        void update(window_aggregate::timestamp t, double v, std::uint32_t publish_every) {
+            samples.push_back({t, v});
+            while (samples.front().first <= t - width) samples.pop_front();
+            if (++since_publish < publish_every) return;
+            since_publish = 0;
+            scratch.clear();
+            double sum = 0;
+            for (const auto& s : samples) {
+                scratch.push_back(s.second);
+                sum += s.second;
+            }
+            const auto [mn, mx] = std::minmax_element(scratch.begin(), scratch.end());
+            result.min = *mn;
+            result.max = *mx;
+            result.mean = sum / static_cast<double>(scratch.size());
+            for (double* q : {&result.p50, &result.p90, &result.p99}) {
+                const double p = q == &result.p50 ? 0.5 : q == &result.p90 ? 0.9 : 0.99;
+                auto nth = scratch.begin() + static_cast<std::ptrdiff_t>(p * static_cast<double>(scratch.size() - 1));
+                std::nth_element(scratch.begin(), nth, scratch.end());
+                *q = *nth;
+            }
+        }
+
+        window_aggregate::timestamp width;
+        std::deque<std::pair<window_aggregate::timestamp, double>> samples;
+        std::vector<double> scratch;
+        std::uint32_t since_publish = 0;
+        window_aggregate::stats result;
+    };
+
+    template <typename Update>
+    double ns_per_update(std::size_t updates, Update&& update) {
+        const auto start = clock_type::now();
+        for (std::size_t i = 0; i < updates; ++i) {
+            update(i);
+        }
+        return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / static_cast<double>(updates);
+    }
+
+}
+
+int main() {
+    constexpr std::size_t updates = 2'000'000;
+    const window_aggregate::options opts;   // fenêtre de 60 s, publication tous les 16 relevés
+
+    std::mt19937 rng(11);
+    std::normal_distribution<double> noise(25.0, 3.0);
+    std::vector<double> values(updates);
+    for (double& v : values) v = noise(rng);
+
+    std::cout << std::left << std::setw(18) << "relevés/fenêtre" << std::right
+              << std::setw(18) << "incrémental (ns)" << std::setw(18) << "recalcul (ns)"
+              << std::setw(16) << "lectures/s" << '\n';
+
+    for (std::size_t window_size : {std::size_t{1'000}, std::size_t{10'000}, std::size_t{100'000}}) {
+        // Un relevé toutes les `step` µs : la fenêtre de 60 s contient `window_size` relevés
+        const auto step = opts.sliding / static_cast<window_aggregate::timestamp>(window_size);
+
+        window_aggregate::window window(opts);
+        std::atomic<bool> done{false};
+        std::uint64_t reads = 0;
+        double sink = 0;
+        std::thread reader([&] {
+            while (!done.load(std::memory_order_relaxed)) {
+                sink += window.read().sliding.p99;
+                ++reads;
+            }
+        });
+        const auto start = clock_type::now();
+        const double incremental = ns_per_update(updates, [&](std::size_t i) {
+            window.update(static_cast<window_aggregate::timestamp>(i) * step, values[i]);
+        });
+        const double elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+        done = true;
+        reader.join();
+
+        naive_window naive(opts.sliding);
+        const double recompute = ns_per_update(updates / 10, [&](std::size_t i) {
+            naive.update(static_cast<window_aggregate::timestamp>(i) * step, values[i], opts.publish_every);
+        });
+
+        std::cout << std::left << std::setw(18) << window_size << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(18) << incremental << std::setw(18) << recompute
+                  << std::setw(16) << std::setprecision(0) << static_cast<double>(reads) / elapsed << '\n';
+        if (sink < 0 || naive.result.p99 < 0) std::cout << "";   // garde les lectures
+    }
+    return 0;
+}
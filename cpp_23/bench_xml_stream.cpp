@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "mapped_file.h"
+#include "xml_stream.h"
+
+// Lecture en flux d'un gros fichier XML (taille en Mio en argument, 2048 par défaut, répertoire
+// en second argument) : lecture par blocs dans un tampon fixe, fichier projeté (mmap), et
+// fichier chargé entier dans un std::string. Chaque variante tourne dans un processus fils
+// pour que le pic de mémoire résidente (ru_maxrss) soit le sien.
+// Le fichier vient d'être écrit : il est dans le cache de pages si la mémoire le permet.
+// Avant la mesure, un texte plus long qu'un petit tampon doit se relire à l'identique
+// (code de sortie 1 sinon).
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    void write_document(const std::string& path, std::size_t size) {
+        std::mt19937 rng(7);
+        std::ofstream out(path, std::ios::binary);
+        std::string chunk;
+        std::size_t written = 0;
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<readings>\n";
+        for (std::size_t i = 0; written < size; ++i) {
+            chunk.clear();
+            chunk += "  <reading id=\"" + std::to_string(i) + "\" sensor=\"s-" + std::to_string(rng() % 1000) +
+                     "\" unit=\"&#176;C\">\n    <value>" + std::to_string(rng() % 10000) +
+                     "</value>\n    <note>hall &amp; floor " + std::to_string(rng() % 10) + "</note>\n";
+            if (i % 64 == 0) chunk += "    <!-- calibrated -->\n    <raw><![CDATA[" + std::string(rng() % 512, 'x') + "]]></raw>\n";
+            chunk += "    <ok/>\n  </reading>\n";
+            out << chunk;
+            written += chunk.size();
+        }
+        out << "</readings>\n";
+    }
+
+    struct counts {
+        std::uint64_t tokens = 0;
+        std::uint64_t elements = 0;
+    };
+
+    counts drain(xml_stream::tokenizer& tokens) {
+        counts c;
+        for (;;) {
+            const auto token = tokens.next();
+            if (!token) throw std::runtime_error(token.error().message);
+            if (token->type == xml_stream::kind::end_document) return c;
+            ++c.tokens;
+            c.elements += token->type == xml_stream::kind::start_element;
+        }
+    }
+
+    // Texte plus long que le tampon de 16 octets, terminé par des blancs, avec une entité
+    // plus longue que le tampon : les morceaux recollés redonnent le texte entier
+    bool split_text_intact() {
+        const std::string text = "abc &#x0000000000000000041; def" + std::string(40, ' ');
+        const std::string document = "<a>" + text + "</a>";
+        std::size_t at = 0;
+        xml_stream::tokenizer tokens([&](char* buffer, std::size_t n) -> std::ptrdiff_t {
+            n = std::min(n, document.size() - at);
+            std::memcpy(buffer, document.data() + at, n);
+            at += n;
+            return static_cast<std::ptrdiff_t>(n);
+        }, {.buffer_size = 16});
+        std::string joined;
+        for (;;) {
+            const auto token = tokens.next();
+            if (!token) return false;
+            if (token->type == xml_stream::kind::end_document) return joined == text;
+            if (token->type == xml_stream::kind::text) joined += token->value;
+        }
+    }
+
+    // Lance la variante dans un processus fils, qui affiche sa ligne
+    template <typename Read>
+    void run(const char* name, std::size_t size, Read&& read) {
+        std::cout.flush();
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            const auto start = clock_type::now();
+            const counts c = read();
+            const double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+            rusage usage{};
+            ::getrusage(RUSAGE_SELF, &usage);
+            std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(0)
+                      << std::setw(10) << static_cast<double>(size) / seconds / 1e6
+                      << std::setw(14) << static_cast<double>(usage.ru_maxrss) / 1024.0
+                      << std::setw(16) << c.tokens << std::setw(14) << c.elements << std::endl;
+            ::_exit(0);
+        }
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    if (!split_text_intact()) {
+        std::cout << "texte découpé en morceaux : perdu ou coupé\n";
+        return 1;
+    }
+
+    const std::size_t mib = argc > 1 ? std::stoul(argv[1]) : 2048;
+    const std::string dir = argc > 2 ? argv[2] : "/tmp";
+    const std::string path = dir + "/bench_xml_stream.xml";
+    write_document(path, mib << 20);
+    const std::size_t size = std::filesystem::file_size(path);
+
+    std::cout << size / (1 << 20) << " Mio\n"
+              << std::left << std::setw(24) << "lecture" << std::right << std::setw(10) << "Mo/s"
+              << std::setw(14) << "pic RSS Mio" << std::setw(16) << "jetons" << std::setw(14) << "éléments" << '\n';
+
+    run("flux (blocs 256 Kio)", size, [&] {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        auto tokens = xml_stream::tokenizer::from_fd(fd);
+        const counts c = drain(tokens);
+        ::close(fd);
+        return c;
+    });
+
+    run("flux (blocs 16 Kio)", size, [&] {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        auto tokens = xml_stream::tokenizer::from_fd(fd, {.buffer_size = 16 << 10});
+        const counts c = drain(tokens);
+        ::close(fd);
+        return c;
+    });
+
+    // Les pages projetées lues comptent dans la RSS (pages du cache partagées, récupérables)
+    run("projection (mmap)", size, [&] {
+        const auto file = file_loader::load_file(path);
+        xml_stream::tokenizer tokens(file->view());
+        return drain(tokens);
+    });
+
+    // Le std::string double plusieurs fois en se remplissant : limité à 1 Gio
+    if (mib <= 1024) {
+        run("std::string entier", size, [&] {
+            std::ifstream in(path, std::ios::binary);
+            const std::string content{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+            xml_stream::tokenizer tokens(content);
+            return drain(tokens);
+        });
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,407 @@
+#ifndef CPP_23_BUFFER_POOL_H
+#define CPP_23_BUFFER_POOL_H
+
+#include <asio.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace buffer_pool {
+
+    // Classes de taille des slabs : la plus petite classe qui contient la demande
+    // est choisie, au-delà de la plus grande on chaîne plusieurs slabs.
+    inline constexpr std::array<std::size_t, 5> size_classes = {1024, 4096, 16384, 65536, 262144};
+    inline constexpr std::size_t default_read_size = 1024;
+
+    // Nombre maximal de segments exposés dans une séquence scatter/gather (readv/writev)
+    inline constexpr std::size_t max_segments = 16;
+
+    // Nombre de slabs gardés en cache par classe et par thread
+    inline constexpr std::size_t max_cached_per_class = 64;
+
+    // Compteurs exportés : en régime permanent allocations et copies restent à zéro
+    struct counters {
+        std::atomic<std::uint64_t> allocations{0};   // slabs alloués sur le tas
+        std::atomic<std::uint64_t> deallocations{0}; // slabs rendus au tas
+        std::atomic<std::uint64_t> bytes_copied{0};  // octets recopiés hors des slabs
+        std::atomic<std::uint64_t> requests{0};      // requêtes servies
+    };
+
+    inline counters& global_counters() {
+        static counters instance;
+        return instance;
+    }
+
+    inline void note_copy(std::size_t bytes) {
+        global_counters().bytes_copied.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    inline void note_request() {
+        global_counters().requests.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    struct snapshot {
+        std::uint64_t allocations;
+        std::uint64_t deallocations;
+        std::uint64_t bytes_copied;
+        std::uint64_t requests;
+    };
+
+    inline snapshot take_snapshot() {
+        const counters& c = global_counters();
+        return {c.allocations.load(std::memory_order_relaxed),
+                c.deallocations.load(std::memory_order_relaxed),
+                c.bytes_copied.load(std::memory_order_relaxed),
+                c.requests.load(std::memory_order_relaxed)};
+    }
+
+    // Export texte : une ligne "nom valeur" par compteur
+    inline void write_counters(std::ostream& out) {
+        const snapshot s = take_snapshot();
+        out << "buffer_pool_allocations_total " << s.allocations << '\n'
+            << "buffer_pool_deallocations_total " << s.deallocations << '\n'
+            << "buffer_pool_bytes_copied_total " << s.bytes_copied << '\n'
+            << "buffer_pool_requests_total " << s.requests << '\n';
+    }
+
+    // Un slab : en-tête suivi directement de ses données
+    struct alignas(64) slab {
+        slab* next = nullptr;
+        std::size_t size = 0;       // octets valides
+        std::uint8_t size_class = 0;
+
+        std::size_t capacity() const { return size_classes[size_class]; }
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+        const char* data() const { return reinterpret_cast<const char*>(this + 1); }
+        std::size_t available() const { return capacity() - size; }
+    };
+
+    // Pool par thread : une liste libre par classe de taille, sans verrou
+    class thread_pool {
+    public:
+        static thread_pool& local() {
+            thread_local thread_pool pool;
+            return pool;
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool() {
+            for (auto& list : free_lists_) {
+                while (list.head) {
+                    slab* s = list.head;
+                    list.head = s->next;
+                    release_to_heap(s);
+                }
+            }
+        }
+
+        slab* acquire(std::uint8_t size_class) {
+            free_list& list = free_lists_[size_class];
+            if (slab* s = list.head) {
+                list.head = s->next;
+                --list.count;
+                s->next = nullptr;
+                s->size = 0;
+                return s;
+            }
+            void* raw = ::operator new(sizeof(slab) + size_classes[size_class], std::align_val_t{alignof(slab)});
+            global_counters().allocations.fetch_add(1, std::memory_order_relaxed);
+            slab* s = ::new (raw) slab{};
+            s->size_class = size_class;
+            return s;
+        }
+
+        void release(slab* s) {
+            free_list& list = free_lists_[s->size_class];
+            if (list.count >= max_cached_per_class) {
+                release_to_heap(s);
+                return;
+            }
+            s->next = list.head;
+            list.head = s;
+            ++list.count;
+        }
+
+        // Classe la plus petite pouvant contenir `bytes`, sinon la plus grande
+        static std::uint8_t class_for(std::size_t bytes) {
+            for (std::uint8_t i = 0; i < size_classes.size(); ++i) {
+                if (bytes <= size_classes[i]) {
+                    return i;
+                }
+            }
+            return static_cast<std::uint8_t>(size_classes.size() - 1);
+        }
+
+    private:
+        thread_pool() = default;
+
+        struct free_list {
+            slab* head = nullptr;
+            std::size_t count = 0;
+        };
+
+        static void release_to_heap(slab* s) {
+            s->~slab();
+            ::operator delete(s, std::align_val_t{alignof(slab)});
+            global_counters().deallocations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::array<free_list, size_classes.size()> free_lists_{};
+    };
+
+    // Séquence de buffers de taille fixe, utilisable directement par asio (readv/writev).
+    // Au-delà de max_segments la séquence s'arrête : `bytes` dit combien d'octets elle couvre.
+    template <typename Buffer>
+    struct buffer_sequence {
+        std::array<Buffer, max_segments> buffers{};
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+
+        bool full() const { return count == max_segments; }
+
+        void push(Buffer buffer) {
+            buffers[count++] = buffer;
+            bytes += buffer.size();
+        }
+
+        const Buffer* begin() const { return buffers.data(); }
+        const Buffer* end() const { return buffers.data() + count; }
+    };
+
+    using mutable_buffers = buffer_sequence<asio::mutable_buffer>;
+    using const_buffers = buffer_sequence<asio::const_buffer>;
+
+    // Chaîne de slabs pour les messages plus grands qu'un slab.
+    // Les octets sont lus et écrits sur place, l'accès se fait par string_view.
+    class buffer_chain {
+    public:
+        buffer_chain() = default;
+        buffer_chain(const buffer_chain&) = delete;
+        buffer_chain& operator=(const buffer_chain&) = delete;
+
+        buffer_chain(buffer_chain&& other) noexcept
+                : head_(std::exchange(other.head_, nullptr)),
+                  tail_(std::exchange(other.tail_, nullptr)),
+                  segments_(std::exchange(other.segments_, 0)),
+                  capacity_(std::exchange(other.capacity_, 0)),
+                  size_(std::exchange(other.size_, 0)),
+                  offset_(std::exchange(other.offset_, 0)) {}
+
+        buffer_chain& operator=(buffer_chain&& other) noexcept {
+            if (this != &other) {
+                clear();
+                head_ = std::exchange(other.head_, nullptr);
+                tail_ = std::exchange(other.tail_, nullptr);
+                segments_ = std::exchange(other.segments_, 0);
+                capacity_ = std::exchange(other.capacity_, 0);
+                size_ = std::exchange(other.size_, 0);
+                offset_ = std::exchange(other.offset_, 0);
+            }
+            return *this;
+        }
+
+        ~buffer_chain() { clear(); }
+
+        // Octets valides dans la chaîne
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        bool contiguous() const { return head_ == tail_; }
+        std::size_t slab_count() const { return segments_; }
+
+        // Octets alloués (slabs de la chaîne), valides ou non
+        std::size_t capacity() const { return capacity_; }
+
+        // Garantit `bytes` octets libres en fin de chaîne et renvoie l'espace libre
+        // sous forme de séquence scatter pour un seul read_some/readv ; limitée à max_segments
+        // slabs, elle peut couvrir moins que `bytes` (result.bytes), le reste au read suivant.
+        // L'espace libre compte tous les slabs non pleins (ils sont toujours en fin de chaîne) :
+        // une lecture courte n'ajoute pas de slab tant que la place restante suffit.
+        mutable_buffers prepare(std::size_t bytes) {
+            std::size_t free_bytes = capacity_ - offset_ - size_;
+            while (free_bytes < bytes) {
+                append(next_class(bytes - free_bytes));
+                free_bytes += tail_->capacity();
+            }
+
+            mutable_buffers result;
+            for (slab* s = head_; s && !result.full(); s = s->next) {
+                if (s->available() == 0) {
+                    continue;
+                }
+                result.push(asio::buffer(s->data() + s->size, s->available()));
+            }
+            return result;
+        }
+
+        // Valide `bytes` octets écrits dans l'espace renvoyé par prepare()
+        void commit(std::size_t bytes) {
+            size_ += bytes;
+            for (slab* s = head_; s && bytes > 0; s = s->next) {
+                const std::size_t n = std::min(bytes, s->available());
+                s->size += n;
+                bytes -= n;
+            }
+        }
+
+        // Séquence gather des octets valides pour un seul write/writev
+        const_buffers data() const {
+            return data(0, size_);
+        }
+
+        // Séquence gather de la plage [offset, offset + length) des octets valides ;
+        // result.bytes < length si la plage s'étend sur plus de max_segments slabs
+        const_buffers data(std::size_t offset, std::size_t length) const {
+            const_buffers result;
+            std::size_t skip = offset_ + offset;
+            for (const slab* s = head_; s && length > 0 && !result.full(); s = s->next) {
+                if (s->size > skip) {
+                    const std::size_t n = std::min(length, s->size - skip);
+                    result.push(asio::buffer(s->data() + skip, n));
+                    length -= n;
+                    skip = 0;
+                } else {
+                    skip -= s->size;
+                }
+            }
+            return result;
+        }
+
+        // Copie au plus `length` octets à partir de `offset` ; réservé aux petits
+        // en-têtes qui peuvent être à cheval sur deux slabs
+        std::size_t peek(std::size_t offset, void* out, std::size_t length) const {
+            std::size_t copied = 0;
+            for (const auto& buffer : data(offset, length)) {
+                std::memcpy(static_cast<char*>(out) + copied, buffer.data(), buffer.size());
+                copied += buffer.size();
+            }
+            return copied;
+        }
+
+        // Retire `bytes` octets en tête ; les slabs pleins et entièrement consommés retournent au pool.
+        // Un slab qui a encore de l'espace libre est gardé : une lecture peut être en cours dedans.
+        void consume(std::size_t bytes) {
+            bytes = std::min(bytes, size_);
+            size_ -= bytes;
+            while (head_ && bytes > 0) {
+                const std::size_t in_head = head_->size - offset_;
+                if (bytes < in_head || head_ == tail_ || head_->available() > 0) {
+                    offset_ += bytes;
+                    break;
+                }
+                bytes -= in_head;
+                pop_front();
+            }
+        }
+
+        void clear() {
+            while (head_) {
+                pop_front();
+            }
+            size_ = 0;
+            capacity_ = 0;
+        }
+
+        // Itération sur les segments valides, sans copie
+        class segment_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::string_view;
+
+            segment_iterator() = default;
+            segment_iterator(const slab* s, std::size_t offset) : slab_(s), offset_(offset) {}
+
+            std::string_view operator*() const {
+                return {slab_->data() + offset_, slab_->size - offset_};
+            }
+            segment_iterator& operator++() {
+                slab_ = slab_->next;
+                offset_ = 0;
+                return *this;
+            }
+            segment_iterator operator++(int) {
+                segment_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            bool operator==(const segment_iterator& other) const { return slab_ == other.slab_; }
+
+        private:
+            const slab* slab_ = nullptr;
+            std::size_t offset_ = 0;
+        };
+
+        struct segment_range {
+            segment_iterator first;
+            segment_iterator begin() const { return first; }
+            segment_iterator end() const { return {}; }
+        };
+
+        segment_range views() const {
+            return {empty() ? segment_iterator{} : segment_iterator{head_, offset_}};
+        }
+
+        // Vue sur le premier segment (tout le message si contiguous())
+        std::string_view front() const {
+            return empty() ? std::string_view{} : *segment_iterator{head_, offset_};
+        }
+
+    private:
+        // Tant qu'un message s'accumule, chaque slab ajouté prend au moins la classe au-dessus
+        // du précédent : une grosse trame tient dans quelques grands slabs, pas des dizaines de petits
+        std::uint8_t next_class(std::size_t missing) const {
+            const std::uint8_t fit = thread_pool::class_for(missing);
+            if (!tail_ || size_ == 0) {
+                return fit;
+            }
+            const std::size_t grown = std::min<std::size_t>(tail_->size_class + 1, size_classes.size() - 1);
+            return std::max(fit, static_cast<std::uint8_t>(grown));
+        }
+
+        void append(std::uint8_t size_class) {
+            slab* s = thread_pool::local().acquire(size_class);
+            if (tail_) {
+                tail_->next = s;
+            } else {
+                head_ = s;
+            }
+            tail_ = s;
+            ++segments_;
+            capacity_ += s->capacity();
+        }
+
+        void pop_front() {
+            slab* s = head_;
+            head_ = s->next;
+            if (!head_) {
+                tail_ = nullptr;
+            }
+            --segments_;
+            capacity_ -= s->capacity();
+            offset_ = 0;
+            thread_pool::local().release(s);
+        }
+
+        slab* head_ = nullptr;
+        slab* tail_ = nullptr;
+        std::size_t segments_ = 0;
+        std::size_t capacity_ = 0;  // somme des capacités des slabs
+        std::size_t size_ = 0;
+        std::size_t offset_ = 0;  // octets déjà consommés dans head_
+    };
+
+}  // namespace buffer_pool
+
+#endif //CPP_23_BUFFER_POOL_H
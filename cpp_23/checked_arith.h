@@ -0,0 +1,231 @@
+#ifndef CPP_23_CHECKED_ARITH_H
+#define CPP_23_CHECKED_ARITH_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <span>
+#include <string_view>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// Opérations entières contrôlées (division, addition et multiplication avec détection du
+// débordement) sur des colonnes entières : résultats dans un span, erreurs dans un masque
+// de bits (bit i du mot i / 64 à 1 si l'élément i est en erreur, résultat mis à 0).
+// Noyaux AVX2 par paquets de 8, choisis à l'exécution ; versions scalaires sinon et pour
+// les restes. Les versions unitaires rendent std::expected<int, errc>.
+//
+// Les colonnes sont traitées sur la longueur de la plus courte ; le masque doit compter au
+// moins (n + 63) / 64 mots.
+namespace checked {
+
+    enum class errc : std::uint8_t {
+        ok,
+        division_by_zero,
+        overflow,
+    };
+
+    inline std::string_view message(errc e) {
+        switch (e) {
+            case errc::ok: return "ok";
+            case errc::division_by_zero: return "Division by zero";
+            case errc::overflow: return "Overflow";
+        }
+        return "?";
+    }
+
+    // --- Versions unitaires ---
+
+    inline std::expected<int, errc> divide(int numerator, int denominator) {
+        if (denominator == 0) return std::unexpected(errc::division_by_zero);
+        if (numerator == std::numeric_limits<int>::min() && denominator == -1) return std::unexpected(errc::overflow);
+        return numerator / denominator;
+    }
+
+    inline std::expected<int, errc> add(int a, int b) {
+        int r;
+        if (__builtin_add_overflow(a, b, &r)) return std::unexpected(errc::overflow);
+        return r;
+    }
+
+    inline std::expected<int, errc> multiply(int a, int b) {
+        int r;
+        if (__builtin_mul_overflow(a, b, &r)) return std::unexpected(errc::overflow);
+        return r;
+    }
+
+    // Cause de l'erreur d'un élément signalé par le masque d'une division
+    inline errc divide_error(int numerator, int denominator) {
+        const auto r = divide(numerator, denominator);
+        return r ? errc::ok : r.error();
+    }
+
+    // Élément i en erreur dans un masque
+    inline bool failed(std::span<const std::uint64_t> errors, std::size_t i) {
+        return (errors[i / 64] >> (i % 64) & 1) != 0;
+    }
+
+    namespace detail {
+
+        // Noyaux scalaires : true si erreur
+        inline bool divide_one(int a, int b, int& out) {
+            const auto r = divide(a, b);
+            out = r.value_or(0);
+            return !r;
+        }
+
+        inline bool add_one(int a, int b, int& out) {
+            if (__builtin_add_overflow(a, b, &out)) {
+                out = 0;
+                return true;
+            }
+            return false;
+        }
+
+        inline bool multiply_one(int a, int b, int& out) {
+            if (__builtin_mul_overflow(a, b, &out)) {
+                out = 0;
+                return true;
+            }
+            return false;
+        }
+
+        using scalar_kernel = bool (*)(int, int, int&);
+
+        // Parcours par blocs de 64 éléments, un mot de masque par bloc
+        template <scalar_kernel Scalar>
+        std::size_t run_scalar(const int* a, const int* b, int* out, std::uint64_t* errors, std::size_t n) {
+            std::size_t count = 0;
+            for (std::size_t base = 0; base < n; base += 64) {
+                const std::size_t end = std::min(n, base + 64);
+                std::uint64_t mask = 0;
+                for (std::size_t i = base; i < end; ++i) {
+                    mask |= std::uint64_t{Scalar(a[i], b[i], out[i])} << (i - base);
+                }
+                errors[base / 64] = mask;
+                count += static_cast<std::size_t>(std::popcount(mask));
+            }
+            return count;
+        }
+
+#if defined(__x86_64__)
+        inline bool has_avx2() {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+
+        __attribute__((target("avx2"))) inline std::uint32_t lane_bits(__m256i mask) {
+            return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+        }
+
+        // Débordement si les deux opérandes ont le même signe et la somme l'autre
+        __attribute__((target("avx2"))) inline std::uint32_t add8(const int* a, const int* b, int* out) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+            const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+            const __m256i sum = _mm256_add_epi32(x, y);
+            const __m256i bad = _mm256_srai_epi32(_mm256_and_si256(_mm256_xor_si256(x, sum), _mm256_xor_si256(y, sum)), 31);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_andnot_si256(bad, sum));
+            return lane_bits(bad);
+        }
+
+        // Produit 64 bits tenant sur 32 bits : le mot haut (impair) est l'extension de signe du mot bas
+        __attribute__((target("avx2"))) inline __m256i high_ok(__m256i p) {
+            return _mm256_cmpeq_epi32(p, _mm256_slli_epi64(_mm256_srai_epi32(p, 31), 32));
+        }
+
+        // Produits 64 bits des voies paires et impaires, contrôlés par high_ok
+        __attribute__((target("avx2"))) inline std::uint32_t multiply8(const int* a, const int* b, int* out) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+            const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+            const __m256i even = _mm256_mul_epi32(x, y);
+            const __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32));
+            const __m256i ok = _mm256_blend_epi32(_mm256_srli_epi64(high_ok(even), 32), high_ok(odd), 0b10101010);
+            const __m256i product = _mm256_mullo_epi32(x, y);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_and_si256(ok, product));
+            return ~lane_bits(ok) & 0xFF;
+        }
+
+        // Quotient exact par les doubles : pour des int32, l'erreur d'arrondi de n / d reste
+        // inférieure à la distance 1 / |d| au plus proche entier, la troncature est donc juste.
+        // Dénominateurs nuls remplacés par 1 avant la division, INT_MIN / -1 signalé à part.
+        __attribute__((target("avx2"))) inline __m128i divide4(__m128i n, __m128i d) {
+            return _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(n), _mm256_cvtepi32_pd(d)));
+        }
+
+        __attribute__((target("avx2"))) inline std::uint32_t divide8(const int* a, const int* b, int* out) {
+            const __m256i n = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+            const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+            const __m256i zero = _mm256_cmpeq_epi32(d, _mm256_setzero_si256());
+            const __m256i overflow = _mm256_and_si256(_mm256_cmpeq_epi32(n, _mm256_set1_epi32(std::numeric_limits<int>::min())),
+                                                      _mm256_cmpeq_epi32(d, _mm256_set1_epi32(-1)));
+            const __m256i bad = _mm256_or_si256(zero, overflow);
+            const __m256i safe_d = _mm256_blendv_epi8(d, _mm256_set1_epi32(1), zero);
+            const __m128i lo = divide4(_mm256_castsi256_si128(n), _mm256_castsi256_si128(safe_d));
+            const __m128i hi = divide4(_mm256_extracti128_si256(n, 1), _mm256_extracti128_si256(safe_d, 1));
+            const __m256i q = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_andnot_si256(bad, q));
+            return lane_bits(bad);
+        }
+
+        using simd_kernel = std::uint32_t (*)(const int*, const int*, int*);
+
+        template <simd_kernel Simd, scalar_kernel Scalar>
+        __attribute__((target("avx2")))
+        std::size_t run_avx2(const int* a, const int* b, int* out, std::uint64_t* errors, std::size_t n) {
+            std::size_t count = 0;
+            for (std::size_t base = 0; base < n; base += 64) {
+                const std::size_t end = std::min(n, base + 64);
+                std::uint64_t mask = 0;
+                std::size_t i = base;
+                for (; i + 8 <= end; i += 8) {
+                    mask |= std::uint64_t{Simd(a + i, b + i, out + i)} << (i - base);
+                }
+                for (; i < end; ++i) {
+                    mask |= std::uint64_t{Scalar(a[i], b[i], out[i])} << (i - base);
+                }
+                errors[base / 64] = mask;
+                count += static_cast<std::size_t>(std::popcount(mask));
+            }
+            return count;
+        }
+#else
+        using simd_kernel = std::uint32_t (*)(const int*, const int*, int*);
+        inline constexpr simd_kernel divide8 = nullptr, add8 = nullptr, multiply8 = nullptr;
+#endif
+
+        template <simd_kernel Simd, scalar_kernel Scalar>
+        std::size_t run(std::span<const int> a, std::span<const int> b, std::span<int> out,
+                        std::span<std::uint64_t> errors, bool allow_simd) {
+            const std::size_t n = std::min({a.size(), b.size(), out.size(), errors.size() * 64});
+#if defined(__x86_64__)
+            if (allow_simd && has_avx2()) return run_avx2<Simd, Scalar>(a.data(), b.data(), out.data(), errors.data(), n);
+#endif
+            return run_scalar<Scalar>(a.data(), b.data(), out.data(), errors.data(), n);
+        }
+
+    }  // namespace detail
+
+    // --- Versions par colonnes : nombre d'éléments en erreur ---
+
+    inline std::size_t divide(std::span<const int> numerators, std::span<const int> denominators, std::span<int> out,
+                              std::span<std::uint64_t> errors, bool allow_simd = true) {
+        return detail::run<detail::divide8, detail::divide_one>(numerators, denominators, out, errors, allow_simd);
+    }
+
+    inline std::size_t add(std::span<const int> a, std::span<const int> b, std::span<int> out,
+                           std::span<std::uint64_t> errors, bool allow_simd = true) {
+        return detail::run<detail::add8, detail::add_one>(a, b, out, errors, allow_simd);
+    }
+
+    inline std::size_t multiply(std::span<const int> a, std::span<const int> b, std::span<int> out,
+                                std::span<std::uint64_t> errors, bool allow_simd = true) {
+        return detail::run<detail::multiply8, detail::multiply_one>(a, b, out, errors, allow_simd);
+    }
+
+}  // namespace checked
+
+#endif //CPP_23_CHECKED_ARITH_H
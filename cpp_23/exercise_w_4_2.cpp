@@ -2,28 +2,29 @@
 #include <string>
 #include <expected>
 #include <iostream>
+#include "mapped_file.h"
 
-std::expected<std::string, std::string> load_file(const std::string& filename) {
-    std::ifstream file(filename);
+// The file is mapped rather than copied: the content is a view on the mapping,
+// valid as long as the returned mapped_file lives
+std::expected<file_loader::mapped_file, std::string> load_file(const std::string& filename) {
+    auto file = file_loader::load_file(filename);
     if (!file) {
-        return std::unexpected("Error: File not found");
+        return std::unexpected("Error: " + file.error().message());
     }
 
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-
-    if (content.empty()) {
+    if (file->empty()) {
         return std::unexpected("Error: File is empty or corrupted");
     }
 
-    return content;
+    return std::move(*file);
 }
 
 int main() {
 
     auto result = load_file("data.txt");
     if(result) {
-        std::cout << "File content " << result.value() << '\n';
+        std::cout << "File content " << result->view() << '\n';
     }else {
         std::cout << result.error() << '\n';
     }
-}
\ No newline at end of file
+}
@@ -1,7 +1,16 @@
+#include <algorithm>
 #include <iostream>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <variant>
 #include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ingest.h"
+#include "json_index.h"
+#include "mapped_file.h"
+#include "xml_stream.h"
 
 struct XmlFile
 {
@@ -15,18 +24,99 @@ struct JsonFile
 
 struct Visitor
 {
+    // Each file's report is written in one go: visitors run on several threads
     void operator()(const XmlFile& file)
     {
-        std::cout << "Reading XML file \"" + file.name + "\"\n";
+        std::ostringstream out;
+        read(file, out);
+        std::cout << out.str();
     }
 
     void operator()(const JsonFile& file)
     {
-        std::cout << "Reading JSON file \"" + file.name + "\"\n";
+        std::ostringstream out;
+        read(file, out);
+        std::cout << out.str();
     }
+
+private:
+    // XML inputs can be several GB: the file is streamed through a fixed-size buffer
+    // and read token by token, never loaded whole. The tokenizer and its buffer are
+    // kept from one XML file to the next
+    void read(const XmlFile& file, std::ostream& out)
+    {
+        out << "Reading XML file \"" + file.name + "\"\n";
+        const file_loader::detail::fd_guard fd{::open(file.name.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (fd.fd < 0)
+        {
+            out << "  Error: " << file_loader::error{errno, "open", file.name}.message() << '\n';
+            return;
+        }
+
+        if (xml)
+            xml->reset(xml_stream::tokenizer::fd_reader(fd.fd));
+        else
+            xml.emplace(xml_stream::tokenizer::from_fd(fd.fd));
+        xml_stream::tokenizer& tokens = *xml;
+        std::size_t elements = 0, attributes = 0, textBytes = 0, maxDepth = 0;
+        for (;;)
+        {
+            auto token = tokens.next();
+            if (!token)
+            {
+                out << "  Error at byte " << token.error().offset << ": " << token.error().message << '\n';
+                break;
+            }
+            if (token->type == xml_stream::kind::end_document)
+            {
+                out << "  " << elements << " elements, " << attributes << " attributes, "
+                    << textBytes << " bytes of text, depth " << maxDepth << '\n';
+                break;
+            }
+            elements += token->type == xml_stream::kind::start_element;
+            attributes += token->type == xml_stream::kind::attribute;
+            if (token->type == xml_stream::kind::text)
+                textBytes += token->value.size();
+            maxDepth = std::max(maxDepth, tokens.depth());
+        }
+    }
+
+    // The file is mapped, then indexed and read into the parser's tape: strings stay views
+    // into the mapping, and the parser's buffers are reused from one JSON file to the next
+    void read(const JsonFile& file, std::ostream& out)
+    {
+        out << "Reading JSON file \"" + file.name + "\"\n";
+        auto content = file_loader::load_file(file.name);
+        if (!content)
+        {
+            out << "  Error: " << content.error().message() << '\n';
+            return;
+        }
+
+        auto document = json.parse(content->view());
+        if (!document)
+        {
+            out << "  Error at byte " << document.error().offset << ": " << document.error().message << '\n';
+            return;
+        }
+
+        std::size_t objects = 0, arrays = 0, values = 0;
+        for (const auto& entry : *document)
+        {
+            objects += entry.type == json_index::kind::object_begin;
+            arrays += entry.type == json_index::kind::array_begin;
+            values += entry.type != json_index::kind::key && entry.type != json_index::kind::object_end &&
+                      entry.type != json_index::kind::array_end;
+        }
+        out << "  " << values << " values, " << objects << " objects, " << arrays << " arrays\n";
+    }
+
+    std::optional<xml_stream::tokenizer> xml;
+    json_index::parser json;
 };
 
-int main()
+// Files given on the command line are added to the list, typed by their extension
+int main(int argc, char* argv[])
 {
     std::vector<std::variant<XmlFile, JsonFile>> files =
             {
@@ -35,8 +125,19 @@ int main()
                     JsonFile{"c.json"},
                     XmlFile{"d.xml"},
             };
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string name = argv[i];
+        if (name.ends_with(".json"))
+            files.emplace_back(JsonFile{name});
+        else
+            files.emplace_back(XmlFile{name});
+    }
 
-    for (const auto& file : files)
-        std::visit(Visitor(), file);
+    // Largest files first across the workers, same-type files together so each worker's
+    // parsers stay warm, idle workers steal from the others
+    const auto report = ingest::run(files, [] { return Visitor(); });
+    std::cout << files.size() << " files on " << report.workers.size() << " workers in "
+              << (report.stat_seconds + report.run_seconds) * 1000 << " ms\n";
 }
 
@@ -0,0 +1,165 @@
+#ifndef CPP_23_FRAMING_H
+#define CPP_23_FRAMING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "buffer_pool.h"
+
+// Découpage du flux TCP en trames :
+//
+//   [longueur du payload : varint LEB128][type : 1 octet][payload]
+//
+// Un read_some peut contenir une partie de trame ou plusieurs trames d'affilée ;
+// le parseur travaille directement sur la chaîne de réception, sans copier les payloads.
+namespace framing {
+
+    enum class message_type : std::uint8_t {
+        echo_request = 1,
+        echo_response = 2,
+        overloaded = 3,     // requête ou connexion refusée par le contrôle d'admission, payload vide
+        error = 0x7f,
+    };
+
+    inline constexpr std::size_t max_varint_size = 10;
+    inline constexpr std::size_t max_header_size = max_varint_size + 1;
+    inline constexpr std::size_t max_payload_size = std::size_t{1} << 20;
+
+    inline std::size_t varint_size(std::uint64_t value) {
+        std::size_t size = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    inline std::size_t encode_varint(std::uint64_t value, std::uint8_t* out) {
+        std::size_t i = 0;
+        while (value >= 0x80) {
+            out[i++] = static_cast<std::uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        out[i++] = static_cast<std::uint8_t>(value);
+        return i;
+    }
+
+    // Écrit l'en-tête dans `out` (au moins max_header_size octets) et renvoie sa taille
+    inline std::size_t encode_header(message_type type, std::size_t payload_size, std::uint8_t* out) {
+        const std::size_t n = encode_varint(payload_size, out);
+        out[n] = static_cast<std::uint8_t>(type);
+        return n + 1;
+    }
+
+    inline std::size_t frame_size(std::size_t payload_size) {
+        return varint_size(payload_size) + 1 + payload_size;
+    }
+
+    enum class decode_status {
+        ok,
+        need_more,
+        malformed,
+        too_large,
+    };
+
+    struct header {
+        message_type type{};
+        std::size_t payload_size = 0;
+        std::size_t header_size = 0;
+    };
+
+    // Décode un en-tête depuis `size` octets contigus
+    inline decode_status decode_header(const std::uint8_t* data, std::size_t size, header& out) {
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < size && i < max_varint_size; ++i) {
+            value |= static_cast<std::uint64_t>(data[i] & 0x7f) << (7 * i);
+            if ((data[i] & 0x80) == 0) {
+                if (value > max_payload_size) {
+                    return decode_status::too_large;
+                }
+                if (i + 1 >= size) {
+                    return decode_status::need_more;
+                }
+                out = {static_cast<message_type>(data[i + 1]), static_cast<std::size_t>(value), i + 2};
+                return decode_status::ok;
+            }
+        }
+        return size >= max_varint_size ? decode_status::malformed : decode_status::need_more;
+    }
+
+    // Trame complète : le payload reste dans les slabs de la chaîne de réception
+    struct frame {
+        message_type type{};
+        std::size_t size = 0;               // octets de la trame, en-tête compris
+        std::size_t payload_size = 0;
+        buffer_pool::const_buffers payload;
+
+        bool contiguous() const { return payload.count <= 1; }
+
+        // Vue sur le payload s'il tient dans un seul slab
+        std::string_view view() const {
+            if (payload.count == 0) {
+                return {};
+            }
+            return {static_cast<const char*>(payload.buffers[0].data()), payload.buffers[0].size()};
+        }
+    };
+
+    // Parseur incrémental : appelé après chaque lecture, il extrait les trames complètes
+    // à partir d'un offset de la chaîne et mémorise l'en-tête d'une trame incomplète.
+    class frame_parser {
+    public:
+        decode_status next(const buffer_pool::buffer_chain& in, std::size_t offset, frame& out) {
+            const std::size_t available = in.size() - offset;
+
+            if (pending_offset_ != offset) {
+                std::uint8_t bytes[max_header_size];
+                const std::size_t n = in.peek(offset, bytes, max_header_size);
+                const decode_status status = decode_header(bytes, n, pending_);
+                if (status != decode_status::ok) {
+                    wanted_ = max_header_size - n;
+                    return status;
+                }
+                pending_offset_ = offset;
+            }
+
+            const std::size_t total = pending_.header_size + pending_.payload_size;
+            if (available < total) {
+                wanted_ = total - available;
+                return decode_status::need_more;
+            }
+
+            out.type = pending_.type;
+            out.size = total;
+            out.payload_size = pending_.payload_size;
+            out.payload = in.data(offset + pending_.header_size, pending_.payload_size);
+            if (out.payload.bytes < pending_.payload_size) {
+                // Payload éparpillé sur plus de max_segments slabs : pas de renvoi sans copie
+                return decode_status::too_large;
+            }
+            pending_offset_ = no_offset;
+            wanted_ = 0;
+            return decode_status::ok;
+        }
+
+        // Octets encore attendus pour compléter la trame en cours (taille de la prochaine lecture)
+        std::size_t wanted() const { return wanted_; }
+
+        // À appeler quand `bytes` octets sont retirés en tête de la chaîne
+        void consumed(std::size_t bytes) {
+            if (pending_offset_ != no_offset) {
+                pending_offset_ -= bytes;
+            }
+        }
+
+    private:
+        static constexpr std::size_t no_offset = static_cast<std::size_t>(-1);
+
+        header pending_;
+        std::size_t pending_offset_ = no_offset;
+        std::size_t wanted_ = 0;
+    };
+
+}  // namespace framing
+
+#endif //CPP_23_FRAMING_H
@@ -0,0 +1,210 @@
+#ifndef CPP_23_INGEST_H
+#define CPP_23_INGEST_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <sys/stat.h>
+
+// Lecture parallèle d'une liste de fichiers de types différents (variant) :
+//
+//   1. les tailles sont relevées (stat) en parallèle ;
+//   2. les fichiers sont répartis du plus gros au plus petit sur le worker le moins chargé (LPT) ;
+//   3. chaque worker range sa part par type, pour enchaîner les fichiers d'un même type avec
+//      un parser déjà chaud, le groupe contenant son plus gros fichier en premier ;
+//   4. un worker sans travail vole la fin de la file d'un autre : un lot de fichiers du même type,
+//      au plus la moitié de ce qui reste.
+//
+// Chaque worker a son propre visiteur, construit par la fabrique passée à run().
+namespace ingest {
+
+    struct options {
+        unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+        std::uint64_t per_file_cost = std::uint64_t{16} << 10;  // coût fixe d'un fichier (open, mmap...) en octets équivalents
+        std::size_t steal_batch = 32;                           // fichiers pris au plus par vol
+    };
+
+    struct worker_stats {
+        std::size_t files = 0;
+        std::uint64_t bytes = 0;
+        std::size_t steals = 0;         // vols réussis par ce worker
+        double busy_seconds = 0;
+    };
+
+    struct report {
+        double stat_seconds = 0;
+        double run_seconds = 0;         // répartition et visite, stat exclus
+        std::size_t missing = 0;        // fichiers dont le stat a échoué (visités quand même)
+        std::vector<worker_stats> workers;
+    };
+
+    namespace detail {
+
+        struct item {
+            std::uint32_t index;
+            std::uint32_t type;
+            std::uint64_t size;
+        };
+
+        struct alignas(64) work_queue {
+            std::mutex mutex;
+            std::deque<item> items;
+        };
+
+        template <typename File>
+        concept named_file = requires(const File& f) { { f.name } -> std::same_as<const std::string&>; };
+
+        // Taille du fichier, -1 si le stat échoue
+        inline std::int64_t file_size(const std::string& path) {
+            struct stat st{};
+            return ::stat(path.c_str(), &st) == 0 ? static_cast<std::int64_t>(st.st_size) : -1;
+        }
+
+        // Range une part par type : groupes triés par leur plus gros fichier, gros fichiers d'abord
+        inline void group_by_type(std::vector<item>& part) {
+            std::vector<std::uint64_t> largest;
+            for (const item& i : part) {
+                if (largest.size() <= i.type) largest.resize(i.type + 1, 0);
+                largest[i.type] = std::max(largest[i.type], i.size);
+            }
+            std::stable_sort(part.begin(), part.end(), [&](const item& a, const item& b) {
+                if (a.type != b.type) {
+                    return largest[a.type] != largest[b.type] ? largest[a.type] > largest[b.type] : a.type < b.type;
+                }
+                return false;   // déjà triés par taille décroissante
+            });
+        }
+
+        // Vole la fin de la file de `victim` : fichiers du même type que le dernier
+        inline bool steal(work_queue& victim, work_queue& thief, std::size_t max_batch) {
+            std::vector<item> stolen;
+            {
+                std::lock_guard lock(victim.mutex);
+                if (victim.items.empty()) return false;
+                const std::uint32_t type = victim.items.back().type;
+                const std::size_t limit = std::min(max_batch, (victim.items.size() + 1) / 2);
+                while (stolen.size() < limit && !victim.items.empty() && victim.items.back().type == type) {
+                    stolen.push_back(victim.items.back());
+                    victim.items.pop_back();
+                }
+            }
+            // Pris du plus petit au plus gros : remis dans l'ordre, gros d'abord
+            std::lock_guard lock(thief.mutex);
+            thief.items.insert(thief.items.end(), stolen.rbegin(), stolen.rend());
+            return true;
+        }
+
+    }  // namespace detail
+
+    template <typename... Files, typename MakeVisitor>
+        requires (detail::named_file<Files> && ...)
+    report run(const std::vector<std::variant<Files...>>& files, MakeVisitor&& make_visitor, const options& opts = {}) {
+        using clock_type = std::chrono::steady_clock;
+        const unsigned workers = std::max(1u, opts.workers);
+        report result;
+        result.workers.resize(workers);
+
+        // 1. Tailles, par paquets pris sur un compteur partagé
+        auto start = clock_type::now();
+        std::vector<std::int64_t> sizes(files.size());
+        {
+            std::atomic<std::size_t> next{0};
+            constexpr std::size_t chunk = 256;
+            std::vector<std::jthread> threads;
+            for (unsigned w = 0; w < workers; ++w) {
+                threads.emplace_back([&] {
+                    for (std::size_t begin; (begin = next.fetch_add(chunk)) < files.size();) {
+                        for (std::size_t i = begin; i < std::min(begin + chunk, files.size()); ++i) {
+                            sizes[i] = detail::file_size(std::visit([](const auto& f) -> const std::string& { return f.name; }, files[i]));
+                        }
+                    }
+                });
+            }
+        }
+        result.stat_seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+        start = clock_type::now();
+
+        // 2. LPT : du plus gros au plus petit, vers le worker le moins chargé
+        std::vector<detail::item> items;
+        items.reserve(files.size());
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            result.missing += sizes[i] < 0;
+            items.push_back({static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(files[i].index()),
+                             static_cast<std::uint64_t>(std::max<std::int64_t>(sizes[i], 0))});
+        }
+        std::stable_sort(items.begin(), items.end(), [](const auto& a, const auto& b) { return a.size > b.size; });
+
+        std::vector<std::vector<detail::item>> parts(workers);
+        using load = std::pair<std::uint64_t, unsigned>;
+        std::priority_queue<load, std::vector<load>, std::greater<>> least_loaded;
+        for (unsigned w = 0; w < workers; ++w) least_loaded.push({0, w});
+        for (const detail::item& i : items) {
+            auto [cost, w] = least_loaded.top();
+            least_loaded.pop();
+            parts[w].push_back(i);
+            least_loaded.push({cost + i.size + opts.per_file_cost, w});
+        }
+
+        // 3. Par type dans chaque part
+        std::vector<detail::work_queue> queues(workers);
+        for (unsigned w = 0; w < workers; ++w) {
+            detail::group_by_type(parts[w]);
+            queues[w].items.assign(parts[w].begin(), parts[w].end());
+        }
+
+        // 4. Visite, avec vol quand la file propre est vide
+        {
+            std::vector<std::jthread> threads;
+            for (unsigned w = 0; w < workers; ++w) {
+                threads.emplace_back([&, w] {
+                    auto visitor = make_visitor();
+                    worker_stats stats;     // local : pas de faux partage entre workers
+                    const auto begin = clock_type::now();
+                    for (;;) {
+                        std::optional<detail::item> job;
+                        {
+                            std::lock_guard lock(queues[w].mutex);
+                            if (!queues[w].items.empty()) {
+                                job = queues[w].items.front();
+                                queues[w].items.pop_front();
+                            }
+                        }
+                        if (!job) {
+                            // Tout a été distribué au départ : plus rien à voler, c'est fini
+                            bool stolen = false;
+                            for (unsigned k = 1; k < workers && !stolen; ++k) {
+                                stolen = detail::steal(queues[(w + k) % workers], queues[w], opts.steal_batch);
+                            }
+                            if (!stolen) break;
+                            ++stats.steals;
+                            continue;
+                        }
+                        std::visit(visitor, files[job->index]);
+                        ++stats.files;
+                        stats.bytes += job->size;
+                    }
+                    stats.busy_seconds = std::chrono::duration<double>(clock_type::now() - begin).count();
+                    result.workers[w] = stats;
+                });
+            }
+        }
+        result.run_seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+        return result;
+    }
+
+}  // namespace ingest
+
+#endif //CPP_23_INGEST_H
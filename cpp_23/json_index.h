@@ -0,0 +1,564 @@
+#ifndef CPP_23_JSON_INDEX_H
+#define CPP_23_JSON_INDEX_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// Lecture JSON en deux passes, à la manière de simdjson :
+//
+//   1. indexation : par blocs de 64 octets, des masques de bits marquent guillemets, antislashs,
+//      caractères structurels et blancs ; on en déduit l'intérieur des chaînes (XOR préfixe)
+//      et la position de chaque élément structurel (AVX2 si le processeur le permet) ;
+//   2. construction d'une bande (tape) plate en suivant ces positions : une entrée par valeur,
+//      les chaînes sont des string_view dans l'entrée, les conteneurs pointent sur leur fin.
+//
+// Le parser garde ses tampons d'un document à l'autre : aucune allocation par nœud, et
+// aucune du tout une fois les tampons à la taille des documents traités.
+namespace json_index {
+
+    enum class kind : std::uint8_t {
+        object_begin,
+        object_end,
+        array_begin,
+        array_end,
+        key,
+        string,
+        integer,
+        number,
+        boolean,
+        null,
+    };
+
+    // Une valeur de la bande. Pour les chaînes et les clés, `text` est le contenu brut entre
+    // guillemets (séquences d'échappement non décodées si `escaped`).
+    struct entry {
+        kind type;
+        bool escaped = false;
+        std::uint32_t link = 0;     // begin : index de la fin correspondante ; end : index du début
+        union {
+            std::string_view text;
+            std::int64_t integer;
+            double number;
+            bool boolean;
+        };
+
+        entry() : type(kind::null), text() {}
+    };
+
+    struct parse_error {
+        std::size_t offset;
+        const char* message;
+    };
+
+    namespace detail {
+
+        struct block_masks {
+            std::uint64_t backslash;
+            std::uint64_t quote;
+            std::uint64_t op;           // { } [ ] : ,
+            std::uint64_t whitespace;
+        };
+
+        inline block_masks classify_scalar(const char* p) {
+            block_masks m{};
+            for (int i = 0; i < 64; ++i) {
+                const std::uint64_t bit = std::uint64_t{1} << i;
+                switch (p[i]) {
+                    case '\\': m.backslash |= bit; break;
+                    case '"': m.quote |= bit; break;
+                    case '{': case '}': case '[': case ']': case ':': case ',': m.op |= bit; break;
+                    case ' ': case '\t': case '\n': case '\r': m.whitespace |= bit; break;
+                    default: break;
+                }
+            }
+            return m;
+        }
+
+#if defined(__x86_64__)
+        __attribute__((target("avx2"))) inline std::uint64_t bits_of(__m256i eq) {
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+        }
+
+        // Blancs et opérateurs par table indexée sur le quartet bas (vpshufb) puis égalité ;
+        // vpshufb rend 0 pour les octets >= 0x80, qui ne correspondent donc jamais. Blancs :
+        // les cases inutilisées contiennent un octet d'un autre quartet bas, le masque est exact.
+        // Opérateurs : on compare `c | 0x20`, ce qui ramène [ ] sur { } mais marque aussi 0x0C
+        // (saut de page) et 0x1A comme opérateurs. Dans une chaîne le masque des chaînes les
+        // efface ; hors chaîne le parseur les refuse comme caractère structurel inattendu,
+        // là où classify_scalar les laisse dans un scalaire que push_scalar refuse.
+        __attribute__((target("avx2"))) inline block_masks classify_avx2(const char* p) {
+            const __m256i whitespace_table = _mm256_setr_epi8(
+                ' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112, 100, '\r', 100, 100,
+                ' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112, 100, '\r', 100, 100);
+            const __m256i op_table = _mm256_setr_epi8(
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0,
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0);
+            const __m256i lower = _mm256_set1_epi8(0x20);
+
+            block_masks m{};
+            for (int half = 0; half < 2; ++half) {
+                const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * half));
+                const int shift = 32 * half;
+                m.backslash |= bits_of(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('\\'))) << shift;
+                m.quote |= bits_of(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('"'))) << shift;
+                m.whitespace |= bits_of(_mm256_cmpeq_epi8(in, _mm256_shuffle_epi8(whitespace_table, in))) << shift;
+                m.op |= bits_of(_mm256_cmpeq_epi8(_mm256_or_si256(in, lower), _mm256_shuffle_epi8(op_table, in))) << shift;
+            }
+            return m;
+        }
+
+        inline bool has_avx2() {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+#endif
+
+        inline std::uint64_t prefix_xor(std::uint64_t x) {
+            x ^= x << 1;
+            x ^= x << 2;
+            x ^= x << 4;
+            x ^= x << 8;
+            x ^= x << 16;
+            x ^= x << 32;
+            return x;
+        }
+
+        // État reporté d'un bloc au suivant
+        struct carry {
+            std::uint64_t escaped = 0;      // premier caractère du bloc échappé
+            std::uint64_t in_string = 0;    // tout à 1 si le bloc commence dans une chaîne
+            std::uint64_t scalar = 0;       // dernier caractère du bloc dans un scalaire (nombre, littéral)
+        };
+
+        // Caractères échappés : ceux qui suivent une suite impaire d'antislashs
+        inline std::uint64_t escaped_chars(std::uint64_t backslash, std::uint64_t& prev_escaped) {
+            constexpr std::uint64_t even_bits = 0x5555555555555555ULL;
+            backslash &= ~prev_escaped;
+            const std::uint64_t follows_escape = backslash << 1 | prev_escaped;
+            const std::uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+            std::uint64_t sequences_on_even;
+            prev_escaped = __builtin_add_overflow(odd_starts, backslash, &sequences_on_even) ? 1 : 0;
+            const std::uint64_t invert = sequences_on_even << 1;
+            return (even_bits ^ invert) & follows_escape;
+        }
+
+        // Positions structurelles d'un bloc : opérateurs hors chaînes, guillemets ouvrants,
+        // premier caractère de chaque nombre ou littéral
+        inline std::uint64_t structurals(const block_masks& m, carry& c) {
+            const std::uint64_t escaped = escaped_chars(m.backslash, c.escaped);
+            const std::uint64_t quote = m.quote & ~escaped;
+            const std::uint64_t in_string = prefix_xor(quote) ^ c.in_string;
+            c.in_string = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+            const std::uint64_t scalar = ~(m.op | m.whitespace);
+            const std::uint64_t non_quote_scalar = scalar & ~quote;
+            const std::uint64_t follows_scalar = non_quote_scalar << 1 | c.scalar;
+            c.scalar = non_quote_scalar >> 63;
+            const std::uint64_t scalar_starts = scalar & ~follows_scalar;
+            // Intérieur des chaînes et guillemet fermant
+            const std::uint64_t string_tail = in_string ^ quote;
+            return (m.op | scalar_starts) & ~string_tail;
+        }
+
+        // Écrit les positions des bits à 1 ; écrit par paquets de 4 sans tester chaque bit,
+        // le tampon a toujours 64 places de marge
+        inline std::uint32_t* flatten(std::uint64_t bits, std::uint32_t base, std::uint32_t* out) {
+            const int count = __builtin_popcountll(bits);
+            std::uint32_t* const end = out + count;
+            while (out < end) {
+                for (int k = 0; k < 4; ++k) {
+                    out[k] = base + static_cast<std::uint32_t>(__builtin_ctzll(bits | (std::uint64_t{1} << 63)));
+                    bits &= bits - 1;
+                }
+                out += 4;
+            }
+            return end;
+        }
+
+        // Renvoie la fin des positions écrites, nullptr si une chaîne n'est pas fermée
+        template <typename Classify>
+        std::uint32_t* index_blocks(std::string_view input, std::uint32_t* out, Classify classify) {
+            carry c;
+            std::size_t i = 0;
+            for (; i + 64 <= input.size(); i += 64) {
+                out = flatten(structurals(classify(input.data() + i), c), static_cast<std::uint32_t>(i), out);
+            }
+            if (i < input.size()) {
+                char tail[64];
+                std::memset(tail, ' ', sizeof(tail));
+                std::memcpy(tail, input.data() + i, input.size() - i);
+                out = flatten(structurals(classify(tail), c), static_cast<std::uint32_t>(i), out);
+            }
+            return c.in_string == 0 ? out : nullptr;
+        }
+
+        inline bool is_whitespace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+        // Grammaire des nombres JSON : -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+        // (from_chars accepte aussi nan, inf et les zéros en tête)
+        inline bool is_json_number(std::string_view token) {
+            const auto digit = [&](std::size_t i) { return i < token.size() && token[i] >= '0' && token[i] <= '9'; };
+            const auto digits = [&](std::size_t i) {
+                const std::size_t start = i;
+                while (digit(i)) ++i;
+                return i - start;
+            };
+            std::size_t i = token.starts_with('-') ? 1 : 0;
+            if (!digit(i)) return false;
+            i += token[i] == '0' ? 1 : digits(i);
+            if (i < token.size() && token[i] == '.') {
+                const std::size_t n = digits(i + 1);
+                if (n == 0) return false;
+                i += 1 + n;
+            }
+            if (i < token.size() && (token[i] == 'e' || token[i] == 'E')) {
+                ++i;
+                if (i < token.size() && (token[i] == '+' || token[i] == '-')) ++i;
+                const std::size_t n = digits(i);
+                if (n == 0) return false;
+                i += n;
+            }
+            return i == token.size();
+        }
+
+        // Contenu d'une chaîne : pas de caractère de contrôle brut (< 0x20) et des séquences
+        // d'échappement bien formées (\" \\ \/ \b \f \n \r \t \uXXXX). Position de la première
+        // faute, npos sinon ; `escaped` dit si le contenu contient au moins une séquence.
+        inline std::size_t string_fault(std::string_view text, bool& escaped) {
+            const auto hex = [](char c) { return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f'); };
+            // Vrai si l'un des 8 octets est < 0x20 ou '\\' (faux positifs possibles, pas de faux négatif)
+            const auto suspect = [](std::uint64_t w) {
+                constexpr std::uint64_t ones = 0x0101010101010101ULL, high = 0x8080808080808080ULL;
+                const std::uint64_t backslash = w ^ (ones * '\\');
+                return (((w - ones * 0x20) & ~w) | ((backslash - ones) & ~backslash)) & high;
+            };
+            escaped = false;
+            for (std::size_t i = 0; i < text.size(); ++i) {
+                for (std::uint64_t w; i + 8 <= text.size(); i += 8) {
+                    std::memcpy(&w, text.data() + i, sizeof w);
+                    if (suspect(w)) break;
+                }
+                if (i == text.size()) break;
+                if (static_cast<unsigned char>(text[i]) < 0x20) return i;
+                if (text[i] != '\\') continue;
+                escaped = true;
+                const std::size_t start = i++;
+                if (i == text.size()) return start;
+                switch (text[i]) {
+                    case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't': break;
+                    case 'u':
+                        if (i + 4 >= text.size() || !hex(text[i + 1]) || !hex(text[i + 2]) || !hex(text[i + 3]) || !hex(text[i + 4])) {
+                            return start;
+                        }
+                        i += 4;
+                        break;
+                    default: return start;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+    }  // namespace detail
+
+    // Passe 1 : positions structurelles, dans un tampon réutilisé d'un document à l'autre
+    class structural_index {
+    public:
+        bool build(std::string_view input, bool allow_simd = true) {
+            // Au plus une position par octet, plus la marge des écritures par paquets
+            const std::size_t needed = input.size() + 64;
+            if (capacity_ < needed) {
+                positions_ = std::make_unique_for_overwrite<std::uint32_t[]>(needed);
+                capacity_ = needed;
+            }
+            std::uint32_t* end = nullptr;
+#if defined(__x86_64__)
+            if (allow_simd && detail::has_avx2()) {
+                end = detail::index_blocks(input, positions_.get(), detail::classify_avx2);
+            } else
+#endif
+            {
+                end = detail::index_blocks(input, positions_.get(), detail::classify_scalar);
+            }
+            count_ = end != nullptr ? static_cast<std::size_t>(end - positions_.get()) : 0;
+            return end != nullptr;
+        }
+
+        std::size_t size() const { return count_; }
+        std::uint32_t operator[](std::size_t i) const { return positions_[i]; }
+
+    private:
+        std::unique_ptr<std::uint32_t[]> positions_;
+        std::size_t capacity_ = 0;
+        std::size_t count_ = 0;
+    };
+
+    // Décodage d'une chaîne marquée `escaped` (\n, \", \uXXXX et paires de substitution vers UTF-8).
+    // Renvoie false sur une séquence invalide.
+    inline bool unescape(std::string_view raw, std::string& out) {
+        out.clear();
+        out.reserve(raw.size());
+        const auto hex4 = [&](std::size_t at, std::uint32_t& code) {
+            if (at + 4 > raw.size()) return false;
+            const auto [ptr, ec] = std::from_chars(raw.data() + at, raw.data() + at + 4, code, 16);
+            return ec == std::errc() && ptr == raw.data() + at + 4;
+        };
+        for (std::size_t i = 0; i < raw.size(); ++i) {
+            if (raw[i] != '\\') {
+                out.push_back(raw[i]);
+                continue;
+            }
+            if (++i == raw.size()) return false;
+            switch (raw[i]) {
+                case '"': case '\\': case '/': out.push_back(raw[i]); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u': {
+                    std::uint32_t code;
+                    if (!hex4(i + 1, code)) return false;
+                    i += 4;
+                    if (code >= 0xD800 && code < 0xDC00) {
+                        std::uint32_t low;
+                        if (i + 2 >= raw.size() || raw[i + 1] != '\\' || raw[i + 2] != 'u' || !hex4(i + 3, low) ||
+                            low < 0xDC00 || low >= 0xE000) {
+                            return false;
+                        }
+                        i += 6;
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    if (code < 0x80) {
+                        out.push_back(static_cast<char>(code));
+                    } else if (code < 0x800) {
+                        out.push_back(static_cast<char>(0xC0 | code >> 6));
+                        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                    } else if (code < 0x10000) {
+                        out.push_back(static_cast<char>(0xE0 | code >> 12));
+                        out.push_back(static_cast<char>(0x80 | (code >> 6 & 0x3F)));
+                        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                    } else {
+                        out.push_back(static_cast<char>(0xF0 | code >> 18));
+                        out.push_back(static_cast<char>(0x80 | (code >> 12 & 0x3F)));
+                        out.push_back(static_cast<char>(0x80 | (code >> 6 & 0x3F)));
+                        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                    }
+                    break;
+                }
+                default: return false;
+            }
+        }
+        return true;
+    }
+
+    // Vue sur la bande d'un document, valable jusqu'au prochain parse du même parser
+    class document {
+    public:
+        explicit document(const std::vector<entry>& tape) : tape_(&tape) {}
+
+        std::size_t size() const { return tape_->size(); }
+        const entry& operator[](std::size_t i) const { return (*tape_)[i]; }
+        const entry& root() const { return tape_->front(); }
+        auto begin() const { return tape_->begin(); }
+        auto end() const { return tape_->end(); }
+
+        // Index de l'entrée qui suit la valeur `i` (saute les conteneurs en entier)
+        std::size_t next(std::size_t i) const {
+            const entry& e = (*tape_)[i];
+            return (e.type == kind::object_begin || e.type == kind::array_begin) ? e.link + 1 : i + 1;
+        }
+
+    private:
+        const std::vector<entry>* tape_;
+    };
+
+    class parser {
+    public:
+        // Limite d'imbrication (taille de la pile de conteneurs)
+        explicit parser(std::size_t max_depth = 1024) : max_depth_(max_depth) {}
+
+        std::expected<document, parse_error> parse(std::string_view input) {
+            if (input.size() >= UINT32_MAX) {
+                return std::unexpected(parse_error{0, "document trop grand"});
+            }
+            if (!structurals_.build(input)) {
+                return std::unexpected(parse_error{input.size(), "chaîne non fermée"});
+            }
+            tape_.clear();
+            tape_.reserve(structurals_.size() + 1);
+            stack_.clear();
+            stack_.reserve(max_depth_);
+            if (auto error = build(input)) {
+                return std::unexpected(*error);
+            }
+            return document(tape_);
+        }
+
+    private:
+        enum class state { value, first_key_or_end, key, colon, first_value_or_end, comma_or_end, done };
+
+        std::optional<parse_error> build(std::string_view input);
+
+        // Fin d'un scalaire ou d'une chaîne : juste avant la position structurelle suivante, blancs exclus
+        static std::size_t token_end(std::string_view input, std::size_t next) {
+            while (next > 0 && detail::is_whitespace(input[next - 1])) --next;
+            return next;
+        }
+
+        std::optional<parse_error> push_string(std::string_view input, std::size_t at, std::size_t next, kind type) {
+            const std::size_t end = token_end(input, next);
+            if (end < at + 2 || input[end - 1] != '"') {
+                return parse_error{at, "chaîne mal formée"};
+            }
+            const std::string_view text = input.substr(at + 1, end - at - 2);
+            bool escaped = false;
+            if (const std::size_t fault = detail::string_fault(text, escaped); fault != std::string_view::npos) {
+                return parse_error{at + 1 + fault, "chaîne invalide"};
+            }
+            entry& e = tape_.emplace_back();
+            e.type = type;
+            e.text = text;
+            e.escaped = escaped;
+            return std::nullopt;
+        }
+
+        std::optional<parse_error> push_scalar(std::string_view input, std::size_t at, std::size_t next) {
+            const std::string_view token = input.substr(at, token_end(input, next) - at);
+            entry& e = tape_.emplace_back();
+            if (token == "true" || token == "false") {
+                e.type = kind::boolean;
+                e.boolean = token[0] == 't';
+                return std::nullopt;
+            }
+            if (token == "null") {
+                e.type = kind::null;
+                return std::nullopt;
+            }
+            if (!detail::is_json_number(token)) {
+                return parse_error{at, "valeur invalide"};
+            }
+            const char* first = token.data();
+            const char* last = first + token.size();
+            if (token.find_first_of(".eE") == std::string_view::npos) {
+                e.type = kind::integer;
+                const auto [ptr, ec] = std::from_chars(first, last, e.integer);
+                if (ec == std::errc() && ptr == last) return std::nullopt;
+            }
+            e.type = kind::number;
+            const auto [ptr, ec] = std::from_chars(first, last, e.number);
+            if (ec != std::errc() || ptr != last) {
+                return parse_error{at, "valeur invalide"};
+            }
+            return std::nullopt;
+        }
+
+        void open(kind type) {
+            stack_.push_back(static_cast<std::uint32_t>(tape_.size()));
+            tape_.emplace_back().type = type;
+        }
+
+        void close(kind type) {
+            const std::uint32_t begin = stack_.back();
+            stack_.pop_back();
+            const auto end = static_cast<std::uint32_t>(tape_.size());
+            entry& e = tape_.emplace_back();
+            e.type = type;
+            e.link = begin;
+            tape_[begin].link = end;
+        }
+
+        std::size_t max_depth_;
+        structural_index structurals_;
+        std::vector<entry> tape_;
+        std::vector<std::uint32_t> stack_;
+    };
+
+    inline std::optional<parse_error> parser::build(std::string_view input) {
+        state s = state::value;
+        const std::size_t count = structurals_.size();
+        auto in_object = [this] { return tape_[stack_.back()].type == kind::object_begin; };
+        auto after_value = [&] { s = stack_.empty() ? state::done : state::comma_or_end; };
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t at = structurals_[i];
+            const std::size_t next = i + 1 < count ? structurals_[i + 1] : input.size();
+            const char c = input[at];
+
+            switch (s) {
+                case state::first_value_or_end:
+                    if (c == ']') {
+                        close(kind::array_end);
+                        after_value();
+                        continue;
+                    }
+                    [[fallthrough]];
+                case state::value:
+                    if (c == '{' || c == '[') {
+                        if (stack_.size() >= max_depth_) return parse_error{at, "imbrication trop profonde"};
+                        open(c == '{' ? kind::object_begin : kind::array_begin);
+                        s = c == '{' ? state::first_key_or_end : state::first_value_or_end;
+                        continue;
+                    }
+                    if (c == '"') {
+                        if (auto error = push_string(input, at, next, kind::string)) return error;
+                    } else if (c == '}' || c == ']' || c == ':' || c == ',') {
+                        return parse_error{at, "valeur attendue"};
+                    } else if (auto error = push_scalar(input, at, next)) {
+                        return error;
+                    }
+                    after_value();
+                    continue;
+                case state::first_key_or_end:
+                    if (c == '}') {
+                        close(kind::object_end);
+                        after_value();
+                        continue;
+                    }
+                    [[fallthrough]];
+                case state::key:
+                    if (c != '"') return parse_error{at, "clé attendue"};
+                    if (auto error = push_string(input, at, next, kind::key)) return error;
+                    s = state::colon;
+                    continue;
+                case state::colon:
+                    if (c != ':') return parse_error{at, "':' attendu"};
+                    s = state::value;
+                    continue;
+                case state::comma_or_end:
+                    if (c == ',') {
+                        s = in_object() ? state::key : state::value;
+                    } else if (c == '}' && in_object()) {
+                        close(kind::object_end);
+                        after_value();
+                    } else if (c == ']' && !in_object()) {
+                        close(kind::array_end);
+                        after_value();
+                    } else {
+                        return parse_error{at, "',' ou fin de conteneur attendue"};
+                    }
+                    continue;
+                case state::done:
+                    return parse_error{at, "contenu après la fin du document"};
+            }
+        }
+        if (s != state::done) {
+            return parse_error{input.size(), "document incomplet"};
+        }
+        return std::nullopt;
+    }
+
+}  // namespace json_index
+
+#endif //CPP_23_JSON_INDEX_H
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include "load_generator.h"
+
+// Générateur de charge en boucle ouverte pour le serveur de with_asio.cpp
+//
+//   load_generator --connections 32 --rate 50000 --duration 10 --depth 4 --size uniform:64:1024 --json out.json
+//
+// --rate 0 passe en boucle fermée (chaque connexion envoie dès qu'elle a de la place dans son pipeline).
+
+namespace {
+
+    void usage() {
+        std::cerr << "Usage: load_generator [--host H] [--port P] [--connections N] [--rate R]\n"
+                     "                      [--duration S] [--warmup S] [--depth D] [--threads T]\n"
+                     "                      [--size fixed:N|uniform:MIN:MAX|exp:MEAN:MAX] [--json FILE]\n";
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    load_generator::options opts;
+    std::string json_path;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            usage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        const std::string value = argv[++i];
+        try {
+            if (arg == "--host") opts.host = value;
+            else if (arg == "--port") opts.port = value;
+            else if (arg == "--connections") opts.connections = std::stoul(value);
+            else if (arg == "--rate") opts.rate = std::stod(value);
+            else if (arg == "--duration") opts.duration = std::chrono::duration<double>(std::stod(value));
+            else if (arg == "--warmup") opts.warmup = std::chrono::duration<double>(std::stod(value));
+            else if (arg == "--depth") opts.pipeline_depth = std::stoul(value);
+            else if (arg == "--threads") opts.threads = std::stoul(value);
+            else if (arg == "--json") json_path = value;
+            else if (arg == "--size") {
+                auto sizes = load_generator::size_distribution::parse(value);
+                if (!sizes) {
+                    std::cerr << "Distribution de taille invalide: " << value << '\n';
+                    return 1;
+                }
+                opts.sizes = *sizes;
+            } else {
+                usage();
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Valeur invalide pour " << arg << ": " << value << '\n';
+            return 1;
+        }
+    }
+    // Au-delà d'une requête par nanoseconde et par connexion, l'intervalle serait arrondi à 0
+    if (opts.connections == 0 || opts.pipeline_depth == 0 || !(opts.rate >= 0) ||
+        opts.rate / static_cast<double>(opts.connections) > 1e9 ||
+        opts.sizes.max_size() > framing::max_payload_size) {
+        usage();
+        return 1;
+    }
+
+    try {
+        const load_generator::result result = load_generator::run(opts);
+        if (json_path.empty()) {
+            result.write_json(std::cout, opts);
+        } else {
+            std::ofstream out(json_path);
+            result.write_json(out, opts);
+        }
+        return result.errors == 0 ? 0 : 2;
+    } catch (std::exception& e) {
+        std::cerr << "Exception: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,497 @@
+#ifndef CPP_23_LOAD_GENERATOR_H
+#define CPP_23_LOAD_GENERATOR_H
+
+#include <asio.hpp>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "framing.h"
+#include "hdr_histogram.h"
+
+namespace load_generator {
+
+    using asio::ip::tcp;
+    using clock = std::chrono::steady_clock;
+
+    // Distribution de la taille des requêtes :
+    //   fixed:64         toujours 64 octets
+    //   uniform:64:1024  uniforme dans [64, 1024]
+    //   exp:512:65536    exponentielle de moyenne 512, bornée à 65536
+    struct size_distribution {
+        enum class kind { fixed, uniform, exponential };
+
+        kind type = kind::fixed;
+        std::size_t a = 64;
+        std::size_t b = 64;
+
+        static std::optional<size_distribution> parse(std::string_view spec) {
+            auto number = [](std::string_view text) -> std::optional<std::size_t> {
+                std::size_t value = 0;
+                auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+                if (ec != std::errc{} || ptr != text.data() + text.size() || value == 0) {
+                    return std::nullopt;
+                }
+                return value;
+            };
+
+            const auto colon = spec.find(':');
+            if (colon == std::string_view::npos) {
+                return std::nullopt;
+            }
+            const std::string_view name = spec.substr(0, colon);
+            std::string_view rest = spec.substr(colon + 1);
+            const auto second = rest.find(':');
+
+            if (name == "fixed" && second == std::string_view::npos) {
+                auto value = number(rest);
+                if (!value) return std::nullopt;
+                return size_distribution{kind::fixed, *value, *value};
+            }
+            if ((name == "uniform" || name == "exp") && second != std::string_view::npos) {
+                auto first = number(rest.substr(0, second));
+                auto last = number(rest.substr(second + 1));
+                if (!first || !last || *first > *last) return std::nullopt;
+                return size_distribution{name == "uniform" ? kind::uniform : kind::exponential, *first, *last};
+            }
+            return std::nullopt;
+        }
+
+        std::size_t sample(std::mt19937_64& rng) const {
+            switch (type) {
+                case kind::fixed:
+                    return a;
+                case kind::uniform:
+                    return std::uniform_int_distribution<std::size_t>(a, b)(rng);
+                case kind::exponential: {
+                    std::exponential_distribution<double> dist(1.0 / static_cast<double>(a));
+                    return std::clamp<std::size_t>(static_cast<std::size_t>(std::ceil(dist(rng))), 1, b);
+                }
+            }
+            return a;
+        }
+
+        std::size_t max_size() const { return b; }
+
+        std::string describe() const {
+            switch (type) {
+                case kind::fixed: return "fixed:" + std::to_string(a);
+                case kind::uniform: return "uniform:" + std::to_string(a) + ":" + std::to_string(b);
+                case kind::exponential: return "exp:" + std::to_string(a) + ":" + std::to_string(b);
+            }
+            return {};
+        }
+    };
+
+    struct options {
+        std::string host = "127.0.0.1";
+        std::string port = "12345";
+        std::size_t connections = 16;
+        double rate = 10000;                  // requêtes/s au total, 0 = boucle fermée (débit max)
+        std::chrono::duration<double> duration{10};
+        std::chrono::duration<double> warmup{1};
+        std::chrono::duration<double> drain{2};
+        std::size_t pipeline_depth = 1;       // requêtes en vol par connexion
+        size_distribution sizes;
+        std::size_t threads = 1;
+    };
+
+    struct result {
+        hdr_histogram latency;                // nanosecondes, depuis l'heure d'envoi prévue
+        std::uint64_t sent = 0;
+        std::uint64_t completed = 0;
+        std::uint64_t rejected = 0;           // réponses overloaded (délestage ou connexion refusée)
+        std::uint64_t unfinished = 0;         // en vol ou jamais envoyées à la fin du test
+        std::uint64_t errors = 0;
+        std::uint64_t bytes_sent = 0;
+        std::uint64_t bytes_received = 0;
+        double elapsed_s = 0;
+
+        void merge(const result& other) {
+            latency.merge(other.latency);
+            sent += other.sent;
+            completed += other.completed;
+            rejected += other.rejected;
+            unfinished += other.unfinished;
+            errors += other.errors;
+            bytes_sent += other.bytes_sent;
+            bytes_received += other.bytes_received;
+            elapsed_s = std::max(elapsed_s, other.elapsed_s);
+        }
+
+        void write_json(std::ostream& out, const options& opts) const {
+            auto us = [this](double percentile) {
+                return static_cast<double>(latency.value_at_percentile(percentile)) / 1000.0;
+            };
+            out << std::fixed << std::setprecision(3)
+                << "{\n"
+                << "  \"connections\": " << opts.connections << ",\n"
+                << "  \"target_rate\": " << opts.rate << ",\n"
+                << "  \"pipeline_depth\": " << opts.pipeline_depth << ",\n"
+                << "  \"payload\": \"" << opts.sizes.describe() << "\",\n"
+                << "  \"duration_s\": " << elapsed_s << ",\n"
+                << "  \"requests_sent\": " << sent << ",\n"
+                << "  \"responses\": " << completed << ",\n"
+                << "  \"rejected\": " << rejected << ",\n"
+                << "  \"unfinished\": " << unfinished << ",\n"
+                << "  \"errors\": " << errors << ",\n"
+                << "  \"throughput_rps\": " << (elapsed_s > 0 ? static_cast<double>(completed) / elapsed_s : 0.0) << ",\n"
+                << "  \"bytes_sent\": " << bytes_sent << ",\n"
+                << "  \"bytes_received\": " << bytes_received << ",\n"
+                << "  \"latency_us\": {\n"
+                << "    \"p50\": " << us(50) << ",\n"
+                << "    \"p90\": " << us(90) << ",\n"
+                << "    \"p99\": " << us(99) << ",\n"
+                << "    \"p99_9\": " << us(99.9) << ",\n"
+                << "    \"max\": " << static_cast<double>(latency.max()) / 1000.0 << ",\n"
+                << "    \"mean\": " << latency.mean() / 1000.0 << "\n"
+                << "  }\n"
+                << "}\n";
+        }
+    };
+
+    // Une connexion en boucle ouverte : la requête k est prévue à start + k * interval,
+    // qu'une réponse soit revenue ou non. La latence est mesurée depuis cette heure prévue,
+    // ce qui corrige l'omission coordonnée quand le serveur (ou la profondeur de pipeline) ralentit l'envoi.
+    class connection : public std::enable_shared_from_this<connection> {
+    public:
+        connection(asio::io_context& io, const options& opts, const tcp::resolver::results_type& endpoints,
+                   clock::time_point start, clock::duration interval, std::uint64_t seed, result& res,
+                   std::function<void()> on_closed)
+                : socket_(io), timer_(io), opts_(opts), endpoints_(endpoints), res_(res),
+                  on_closed_(std::move(on_closed)), rng_(seed),
+                  start_(start), interval_(interval),
+                  warmup_end_(start + std::chrono::duration_cast<clock::duration>(opts.warmup)),
+                  end_(warmup_end_ + std::chrono::duration_cast<clock::duration>(opts.duration)),
+                  payload_(opts.sizes.max_size(), 'x'),
+                  read_buffer_(std::max<std::size_t>(opts.sizes.max_size(), 64 * 1024)),
+                  inflight_(opts.pipeline_depth) {
+            write_buffers_.reserve(2 * opts.pipeline_depth);
+            planned_ = open_loop() ? static_cast<std::uint64_t>((end_ - start_) / interval_) : UINT64_MAX;
+        }
+
+        void start() {
+            asio::async_connect(socket_, endpoints_, [self = shared_from_this()](const asio::error_code& ec, const tcp::endpoint&) {
+                if (ec) {
+                    ++self->res_.errors;
+                    self->close();
+                    return;
+                }
+                self->socket_.set_option(tcp::no_delay(true));
+                self->do_read();
+                self->on_tick();
+            });
+        }
+
+        clock::time_point last_activity() const { return last_activity_; }
+
+        // Fin de test : ce qui n'est pas revenu compte avec sa latence actuelle
+        void finish(clock::time_point now) {
+            if (closed_) {
+                return;
+            }
+            for (std::size_t i = 0; i < inflight_count_; ++i) {
+                record(inflight_[(inflight_head_ + i) % inflight_.size()].intended, now);
+                ++res_.unfinished;
+            }
+            if (open_loop()) {
+                for (std::uint64_t seq = sent_; seq < scheduled_; ++seq) {
+                    record(intended(seq), now);
+                    ++res_.unfinished;
+                }
+            }
+            close();
+        }
+
+    private:
+        struct pending {
+            clock::time_point intended;
+            std::array<std::uint8_t, framing::max_header_size> header;
+        };
+
+        bool open_loop() const { return opts_.rate > 0; }
+        clock::time_point intended(std::uint64_t seq) const { return start_ + interval_ * static_cast<clock::rep>(seq); }
+
+        void on_tick() {
+            if (closed_) {
+                return;
+            }
+            const auto now = clock::now();
+            if (open_loop()) {
+                if (now >= start_) {
+                    scheduled_ = std::min<std::uint64_t>(planned_, static_cast<std::uint64_t>((now - start_) / interval_) + 1);
+                }
+                try_send();
+                if (scheduled_ < planned_) {
+                    timer_.expires_at(intended(scheduled_));
+                    timer_.async_wait([self = shared_from_this()](const asio::error_code& ec) {
+                        if (!ec) self->on_tick();
+                    });
+                }
+            } else {
+                try_send();
+            }
+        }
+
+        void try_send() {
+            if (writing_ || closed_) {
+                return;
+            }
+            const auto now = clock::now();
+            if (!open_loop() && now >= end_) {
+                maybe_close();
+                return;
+            }
+
+            write_buffers_.clear();
+            while (inflight_count_ < inflight_.size()) {
+                clock::time_point when;
+                if (open_loop()) {
+                    if (sent_ >= scheduled_) break;
+                    when = intended(sent_);
+                } else {
+                    when = now;
+                }
+                const std::size_t size = opts_.sizes.sample(rng_);
+                pending& p = inflight_[(inflight_head_ + inflight_count_) % inflight_.size()];
+                const std::size_t header_size = framing::encode_header(framing::message_type::echo_request, size, p.header.data());
+                p.intended = when;
+                ++inflight_count_;
+                ++sent_;
+                if (when >= warmup_end_) {
+                    ++res_.sent;
+                }
+                res_.bytes_sent += header_size + size;
+                write_buffers_.push_back(asio::buffer(p.header.data(), header_size));
+                write_buffers_.push_back(asio::buffer(payload_.data(), size));
+            }
+            if (write_buffers_.empty()) {
+                maybe_close();
+                return;
+            }
+
+            // Toutes les requêtes prêtes partent en un seul write (gather)
+            writing_ = true;
+            asio::async_write(socket_, write_buffers_, [self = shared_from_this()](const asio::error_code& ec, std::size_t) {
+                self->writing_ = false;
+                if (ec) {
+                    self->fail();
+                    return;
+                }
+                self->try_send();
+            });
+        }
+
+        void do_read() {
+            socket_.async_read_some(asio::buffer(read_buffer_), [self = shared_from_this()](const asio::error_code& ec, std::size_t n) {
+                if (ec) {
+                    if (!self->closed_) self->fail();
+                    return;
+                }
+                self->on_bytes(n);
+                self->do_read();
+            });
+        }
+
+        // Le serveur répond à chaque trame echo_request dans l'ordre, par une trame echo_response
+        // de même payload ou par une trame overloaded vide s'il l'a délestée : on découpe le flux
+        // reçu trame par trame (en-tête accumulé, payload sauté)
+        void on_bytes(std::size_t n) {
+            res_.bytes_received += n;
+            const auto now = clock::now();
+            bool freed = false;
+            const std::uint8_t* data = read_buffer_.data();
+            while (n > 0) {
+                if (payload_left_ > 0) {
+                    const std::size_t k = std::min(n, payload_left_);
+                    payload_left_ -= k;
+                    data += k;
+                    n -= k;
+                    if (payload_left_ == 0) {
+                        freed |= complete(framing::message_type::echo_response, now);
+                    }
+                    continue;
+                }
+                response_header_[header_len_++] = *data++;
+                --n;
+                framing::header h;
+                const framing::decode_status status = framing::decode_header(response_header_.data(), header_len_, h);
+                if (status == framing::decode_status::need_more) {
+                    continue;
+                }
+                header_len_ = 0;
+                if (status != framing::decode_status::ok || h.type == framing::message_type::error) {
+                    fail();
+                    return;
+                }
+                payload_left_ = h.payload_size;
+                if (payload_left_ == 0) {
+                    freed |= complete(h.type, now);
+                }
+            }
+            if (freed) {
+                try_send();
+            }
+        }
+
+        bool complete(framing::message_type type, clock::time_point now) {
+            if (inflight_count_ == 0) {
+                // Connexion refusée à l'accept : le serveur ferme juste après
+                if (type == framing::message_type::overloaded) {
+                    ++res_.rejected;
+                }
+                return false;
+            }
+            const pending& p = inflight_[inflight_head_];
+            if (p.intended >= warmup_end_) {
+                if (type == framing::message_type::overloaded) {
+                    ++res_.rejected;
+                } else {
+                    record(p.intended, now);
+                    ++res_.completed;
+                }
+            }
+            inflight_head_ = (inflight_head_ + 1) % inflight_.size();
+            --inflight_count_;
+            return true;
+        }
+
+        void record(clock::time_point intended, clock::time_point now) {
+            if (intended < warmup_end_) {
+                return;
+            }
+            res_.latency.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - intended).count()));
+        }
+
+        void maybe_close() {
+            const bool done = open_loop() ? sent_ >= planned_ : clock::now() >= end_;
+            if (done && inflight_count_ == 0) {
+                close();
+            }
+        }
+
+        void fail() {
+            ++res_.errors;
+            finish(clock::now());
+        }
+
+        void close() {
+            if (closed_) {
+                return;
+            }
+            closed_ = true;
+            asio::error_code ignored;
+            timer_.cancel();
+            socket_.shutdown(tcp::socket::shutdown_both, ignored);
+            socket_.close(ignored);
+            last_activity_ = clock::now();
+            if (on_closed_) on_closed_();
+        }
+
+        tcp::socket socket_;
+        asio::steady_timer timer_;
+        const options& opts_;
+        tcp::resolver::results_type endpoints_;
+        result& res_;
+        std::function<void()> on_closed_;
+        std::mt19937_64 rng_;
+        clock::time_point last_activity_{};
+
+        clock::time_point start_;
+        clock::duration interval_;
+        clock::time_point warmup_end_;
+        clock::time_point end_;
+        std::uint64_t planned_ = 0;
+        std::uint64_t scheduled_ = 0;
+        std::uint64_t sent_ = 0;
+
+        std::string payload_;
+        std::vector<std::uint8_t> read_buffer_;
+        std::array<std::uint8_t, framing::max_header_size> response_header_{};
+        std::size_t header_len_ = 0;
+        std::size_t payload_left_ = 0;    // octets de payload de la réponse en cours encore à sauter
+
+        std::vector<pending> inflight_;       // anneau de taille pipeline_depth
+        std::size_t inflight_head_ = 0;
+        std::size_t inflight_count_ = 0;
+        std::vector<asio::const_buffer> write_buffers_;
+        bool writing_ = false;
+        bool closed_ = false;
+    };
+
+    // Lance le test : les connexions sont réparties sur `threads` io_context indépendants,
+    // chaque thread agrège son propre résultat puis tout est fusionné à la fin.
+    inline result run(const options& opts) {
+        asio::io_context resolve_context;
+        tcp::resolver resolver(resolve_context);
+        const auto endpoints = resolver.resolve(opts.host, opts.port);
+
+        const std::size_t threads = std::max<std::size_t>(1, std::min(opts.threads, opts.connections));
+        const double per_connection_rate = opts.rate / static_cast<double>(opts.connections);
+        const auto interval = per_connection_rate > 0
+                              ? std::max(clock::duration{1}, std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / per_connection_rate)))
+                              : clock::duration::zero();
+        const auto begin = clock::now() + std::chrono::milliseconds(100);
+        const auto stop_at = begin + std::chrono::duration_cast<clock::duration>(opts.warmup + opts.duration + opts.drain);
+
+        std::vector<result> results(threads);
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                asio::io_context io(1);
+                asio::steady_timer deadline(io);
+                std::size_t open = 0;
+                std::vector<std::shared_ptr<connection>> connections;
+                auto on_closed = [&] {
+                    if (--open == 0) deadline.cancel();
+                };
+                for (std::size_t c = t; c < opts.connections; c += threads) {
+                    // Décalage des départs pour ne pas envoyer toutes les connexions en rafale
+                    const auto offset = interval * static_cast<clock::rep>(c) / static_cast<clock::rep>(opts.connections);
+                    connections.push_back(std::make_shared<connection>(io, opts, endpoints, begin + offset, interval, 0x9e3779b97f4a7c15ULL * (c + 1), results[t], on_closed));
+                    ++open;
+                }
+                for (auto& conn : connections) {
+                    conn->start();
+                }
+
+                deadline.expires_at(stop_at);
+                deadline.async_wait([&](const asio::error_code& ec) {
+                    if (ec) return;
+                    const auto now = clock::now();
+                    for (auto& conn : connections) conn->finish(now);
+                });
+                io.run();
+
+                // Fenêtre de mesure : de la fin du warmup à la fermeture de la dernière connexion
+                auto last = begin;
+                for (const auto& conn : connections) last = std::max(last, conn->last_activity());
+                results[t].elapsed_s = std::chrono::duration<double>(last - begin - opts.warmup).count();
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        result total;
+        for (const auto& r : results) {
+            total.merge(r);
+        }
+        return total;
+    }
+
+}  // namespace load_generator
+
+#endif //CPP_23_LOAD_GENERATOR_H
@@ -0,0 +1,23 @@
+#include <fstream>
+#include <iostream>
+#include "async_log.h"
+
+// Usage : log_decode journal.alog
+//
+// Écrit en texte un journal binaire d'async_log (heure UTC, thread, niveau, message).
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage : log_decode journal.alog\n";
+        return 2;
+    }
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        std::cerr << "Impossible d'ouvrir " << argv[1] << '\n';
+        return 1;
+    }
+    if (!async_log::decode(in, std::cout)) {
+        std::cerr << "Journal invalide ou tronqué : " << argv[1] << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -2,13 +2,20 @@
 
 #include <iostream>
 #include <expected>
+#include <numbers>
+#include <string>
+#include <vector>
+#include "checked_arith.h"
+#include "point_batch.h"
 
-
+// Kept for single values; the message is only built on the error path.
+// Whole columns go through checked::divide / add / multiply, which fill an error bitmask.
 std::expected<int, std::string> safe_divide(int numerator, int denominator) {
-    if (denominator == 0) {
-        return std::unexpected("Error: Division by zero");
+    const auto result = checked::divide(numerator, denominator);
+    if (!result) {
+        return std::unexpected("Error: " + std::string(checked::message(result.error())));
     }
-    return numerator / denominator;
+    return *result;
 }
 
 struct Point {
@@ -50,6 +57,11 @@ int main() {
     p.reflect().display();
     cp.reflect().display();
 
+    // Point clouds: same operations on the whole batch, stored as separate x / y columns
+    auto batch = geometry::PointBatch::fromPoints(std::vector<Point>{p, cp, {5, -6}});
+    batch.translate(1, 1).rotate(std::numbers::pi / 2).reflect().display();
+    batch.toPoints<Point>().front().display();
+
     auto result = safe_divide(10, 4);
     if(result) {
         std::cout << "Result : " << result.value() << '\n';
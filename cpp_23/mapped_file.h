@@ -0,0 +1,178 @@
+#ifndef CPP_23_MAPPED_FILE_H
+#define CPP_23_MAPPED_FILE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Chargement de fichiers entiers sans copie : les fichiers réguliers sont projetés en mémoire
+// (mmap), le contenu est exposé en string_view / span sans passer par un std::string.
+// Les pipes, sockets et fichiers de /proc (taille annoncée nulle) sont lus en gros blocs.
+namespace file_loader {
+
+    struct error {
+        int code = 0;               // errno
+        const char* operation = ""; // appel système en échec
+        std::string path;
+
+        std::string message() const {
+            return std::string(operation) + "(" + path + "): " + std::strerror(code);
+        }
+    };
+
+    struct load_options {
+        bool sequential = true;     // MADV_SEQUENTIAL : lecture anticipée agressive, pages libérées derrière
+        bool populate = false;      // MAP_POPULATE : toutes les pages chargées dès le mmap
+        bool allow_mmap = true;     // false force la lecture en blocs
+        std::size_t read_chunk = std::size_t{64} << 10;  // taille initiale des blocs de lecture
+    };
+
+    // Contenu d'un fichier : projection mémoire ou tampon lu, déplaçable, non copiable
+    class mapped_file {
+    public:
+        mapped_file() = default;
+
+        mapped_file(mapped_file&& other) noexcept
+                : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+                  mapping_size_(std::exchange(other.mapping_size_, 0)), buffer_(std::move(other.buffer_)) {}
+
+        mapped_file& operator=(mapped_file&& other) noexcept {
+            if (this != &other) {
+                release();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+                mapping_size_ = std::exchange(other.mapping_size_, 0);
+                buffer_ = std::move(other.buffer_);
+            }
+            return *this;
+        }
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        ~mapped_file() { release(); }
+
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        bool is_mapped() const { return mapping_size_ != 0; }
+
+        std::string_view view() const { return {static_cast<const char*>(data_), size_}; }
+        std::span<const std::byte> bytes() const { return {static_cast<const std::byte*>(data_), size_}; }
+
+        // Prend possession d'une projection (libérée par munmap) ou d'un tampon déjà rempli
+        static mapped_file from_mapping(void* data, std::size_t size) {
+            mapped_file file;
+            file.data_ = data;
+            file.size_ = size;
+            file.mapping_size_ = size;
+            return file;
+        }
+
+        static mapped_file from_buffer(std::unique_ptr<std::byte[]> buffer, std::size_t size) {
+            mapped_file file;
+            file.data_ = buffer.get();
+            file.size_ = size;
+            file.buffer_ = std::move(buffer);
+            return file;
+        }
+
+    private:
+        void release() {
+            if (mapping_size_ != 0) {
+                ::munmap(data_, mapping_size_);
+            }
+            data_ = nullptr;
+            size_ = 0;
+            mapping_size_ = 0;
+            buffer_.reset();
+        }
+
+        void* data_ = nullptr;
+        std::size_t size_ = 0;
+        std::size_t mapping_size_ = 0;
+        std::unique_ptr<std::byte[]> buffer_;
+    };
+
+    namespace detail {
+
+        struct fd_guard {
+            int fd;
+            ~fd_guard() { if (fd >= 0) ::close(fd); }
+        };
+
+        // Lecture en blocs jusqu'à EOF, tampon doublé au besoin (pipes, procfs, mmap refusé)
+        inline std::expected<mapped_file, error> read_all(int fd, std::size_t hint, const std::string& path,
+                                                          std::size_t chunk) {
+            std::size_t capacity = std::max<std::size_t>(hint + 1, chunk);
+            auto buffer = std::make_unique_for_overwrite<std::byte[]>(capacity);
+            std::size_t size = 0;
+            for (;;) {
+                if (size == capacity) {
+                    auto bigger = std::make_unique_for_overwrite<std::byte[]>(2 * capacity);
+                    std::memcpy(bigger.get(), buffer.get(), size);
+                    buffer = std::move(bigger);
+                    capacity *= 2;
+                }
+                const ssize_t n = ::read(fd, buffer.get() + size, capacity - size);
+                if (n == 0) {
+                    break;
+                }
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    return std::unexpected(error{errno, "read", path});
+                }
+                size += static_cast<std::size_t>(n);
+            }
+            return mapped_file::from_buffer(std::move(buffer), size);
+        }
+
+    }  // namespace detail
+
+    inline std::expected<mapped_file, error> load_file(const std::string& path, const load_options& options = {}) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return std::unexpected(error{errno, "open", path});
+        }
+        detail::fd_guard guard{fd};
+
+        struct stat st{};
+        if (::fstat(fd, &st) < 0) {
+            return std::unexpected(error{errno, "fstat", path});
+        }
+
+        const auto size = static_cast<std::size_t>(st.st_size);
+        if (!S_ISREG(st.st_mode) || size == 0 || !options.allow_mmap) {
+            // Taille inconnue (pipe) ou fausse (procfs annonce 0) : lecture jusqu'à EOF
+            return detail::read_all(fd, S_ISREG(st.st_mode) ? size : 0, path, options.read_chunk);
+        }
+
+        int flags = MAP_PRIVATE;
+        if (options.populate) {
+            flags |= MAP_POPULATE;
+        }
+        void* data = ::mmap(nullptr, size, PROT_READ, flags, fd, 0);
+        if (data == MAP_FAILED) {
+            // Certains systèmes de fichiers refusent mmap : on lit
+            return detail::read_all(fd, size, path, options.read_chunk);
+        }
+        if (options.sequential) {
+            ::madvise(data, size, MADV_SEQUENTIAL);
+        }
+        // La projection reste valide après la fermeture du descripteur
+        return mapped_file::from_mapping(data, size);
+    }
+
+}  // namespace file_loader
+
+#endif //CPP_23_MAPPED_FILE_H
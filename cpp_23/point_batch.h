@@ -0,0 +1,288 @@
+#ifndef CPP_23_POINT_BATCH_H
+#define CPP_23_POINT_BATCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <span>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// Nuage de points en structure de tableaux (SoA) : x et y dans deux tableaux alignés sur 64
+// octets, pour appliquer une même transformation à des millions de points par paquets AVX2
+// (8 entiers ou 4 doubles), sur plusieurs threads si demandé.
+// Les coordonnées restent entières comme dans Point : translate et reflect calculent en
+// entiers (modulo 2^32), scale, rotate et affine en double, arrondis au plus proche et
+// bornés à l'intervalle de int.
+namespace geometry {
+
+    template <typename T, std::size_t Alignment = 64>
+    struct aligned_allocator {
+        using value_type = T;
+
+        aligned_allocator() = default;
+        template <typename U>
+        aligned_allocator(const aligned_allocator<U, Alignment>&) {}
+
+        template <typename U>
+        struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+        }
+
+        void deallocate(T* p, std::size_t) {
+            ::operator delete(p, std::align_val_t{Alignment});
+        }
+
+        friend bool operator==(const aligned_allocator&, const aligned_allocator&) { return true; }
+    };
+
+    // x' = a x + b y + tx, y' = c x + d y + ty
+    struct Affine {
+        double a = 1, b = 0, c = 0, d = 1, tx = 0, ty = 0;
+
+        static Affine scaling(double sx, double sy) { return {sx, 0, 0, sy, 0, 0}; }
+
+        static Affine rotation(double radians) {
+            const double cos = std::cos(radians), sin = std::sin(radians);
+            return {cos, -sin, sin, cos, 0, 0};
+        }
+    };
+
+    // Découpage en tranches d'au moins minChunk points, une par thread
+    struct Parallel {
+        unsigned threads = 1;
+        std::size_t minChunk = std::size_t{1} << 16;
+        bool simd = true;
+    };
+
+    namespace detail {
+
+        inline int round_to_int(double v) {
+            v = std::clamp(std::nearbyint(v), static_cast<double>(std::numeric_limits<int>::min()),
+                           static_cast<double>(std::numeric_limits<int>::max()));
+            return static_cast<int>(v);
+        }
+
+        inline int wrapping_add(int a, int b) {
+            return static_cast<int>(static_cast<std::uint32_t>(a) + static_cast<std::uint32_t>(b));
+        }
+
+        inline void translate_scalar(int* x, int* y, std::size_t n, int dx, int dy) {
+            for (std::size_t i = 0; i < n; ++i) {
+                x[i] = wrapping_add(x[i], dx);
+                y[i] = wrapping_add(y[i], dy);
+            }
+        }
+
+        inline void reflect_scalar(int* x, int* y, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                x[i] = wrapping_add(~x[i], 1);
+                y[i] = wrapping_add(~y[i], 1);
+            }
+        }
+
+        inline void affine_scalar(int* x, int* y, std::size_t n, const Affine& m) {
+            for (std::size_t i = 0; i < n; ++i) {
+                const double px = x[i], py = y[i];
+                x[i] = round_to_int(m.a * px + m.b * py + m.tx);
+                y[i] = round_to_int(m.c * px + m.d * py + m.ty);
+            }
+        }
+
+#if defined(__x86_64__)
+        inline bool has_avx2() {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+
+        __attribute__((target("avx2"))) inline void translate_avx2(int* x, int* y, std::size_t n, int dx, int dy) {
+            const __m256i vx = _mm256_set1_epi32(dx), vy = _mm256_set1_epi32(dy);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                auto* px = reinterpret_cast<__m256i*>(x + i);
+                auto* py = reinterpret_cast<__m256i*>(y + i);
+                _mm256_storeu_si256(px, _mm256_add_epi32(_mm256_loadu_si256(px), vx));
+                _mm256_storeu_si256(py, _mm256_add_epi32(_mm256_loadu_si256(py), vy));
+            }
+            translate_scalar(x + i, y + i, n - i, dx, dy);
+        }
+
+        __attribute__((target("avx2"))) inline void reflect_avx2(int* x, int* y, std::size_t n) {
+            const __m256i zero = _mm256_setzero_si256();
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                auto* px = reinterpret_cast<__m256i*>(x + i);
+                auto* py = reinterpret_cast<__m256i*>(y + i);
+                _mm256_storeu_si256(px, _mm256_sub_epi32(zero, _mm256_loadu_si256(px)));
+                _mm256_storeu_si256(py, _mm256_sub_epi32(zero, _mm256_loadu_si256(py)));
+            }
+            reflect_scalar(x + i, y + i, n - i);
+        }
+
+        // 4 points par tour ; cvtpd arrondit au plus proche pair comme nearbyint
+        __attribute__((target("avx2"))) inline void affine_avx2(int* x, int* y, std::size_t n, const Affine& m) {
+            const __m256d a = _mm256_set1_pd(m.a), b = _mm256_set1_pd(m.b), c = _mm256_set1_pd(m.c);
+            const __m256d d = _mm256_set1_pd(m.d), tx = _mm256_set1_pd(m.tx), ty = _mm256_set1_pd(m.ty);
+            const __m256d lo = _mm256_set1_pd(std::numeric_limits<int>::min());
+            const __m256d hi = _mm256_set1_pd(std::numeric_limits<int>::max());
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                const __m256d px = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+                const __m256d py = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i)));
+                // Même ordre d'opérations que la version scalaire, (a x + b y) + t, sans FMA :
+                // les arrondis sont identiques
+                const __m256d rx = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a, px), _mm256_mul_pd(b, py)), tx);
+                const __m256d ry = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(c, px), _mm256_mul_pd(d, py)), ty);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(x + i),
+                                 _mm256_cvtpd_epi32(_mm256_min_pd(_mm256_max_pd(_mm256_round_pd(rx, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), lo), hi)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(y + i),
+                                 _mm256_cvtpd_epi32(_mm256_min_pd(_mm256_max_pd(_mm256_round_pd(ry, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), lo), hi)));
+            }
+            affine_scalar(x + i, y + i, n - i, m);
+        }
+#endif
+
+        // Applique kernel(x, y, n) par tranches, sur plusieurs threads si la taille le justifie
+        template <typename Kernel>
+        void for_chunks(int* x, int* y, std::size_t n, const Parallel& parallel, Kernel&& kernel) {
+            const std::size_t chunks = std::clamp<std::size_t>(n / std::max<std::size_t>(parallel.minChunk, 1), 1,
+                                                               std::max(1u, parallel.threads));
+            if (chunks == 1) {
+                kernel(x, y, n);
+                return;
+            }
+            // Bornes multiples de 16 : chaque tranche commence sur une ligne de cache
+            const std::size_t step = (n / chunks + 15) & ~std::size_t{15};
+            std::vector<std::jthread> threads;
+            for (std::size_t begin = step; begin < n; begin += step) {
+                threads.emplace_back([=, &kernel] { kernel(x + begin, y + begin, std::min(step, n - begin)); });
+            }
+            kernel(x, y, std::min(step, n));
+        }
+
+    }  // namespace detail
+
+    class PointBatch {
+    public:
+        using column = std::vector<int, aligned_allocator<int>>;
+
+        PointBatch() = default;
+
+        // Depuis n'importe quel point à membres x et y (Point de main.cpp)
+        template <typename P>
+        static PointBatch fromPoints(std::span<const P> points) {
+            PointBatch batch;
+            batch.x_.resize(points.size());
+            batch.y_.resize(points.size());
+            for (std::size_t i = 0; i < points.size(); ++i) {
+                batch.x_[i] = points[i].x;
+                batch.y_[i] = points[i].y;
+            }
+            return batch;
+        }
+
+        template <typename P>
+        static PointBatch fromPoints(const std::vector<P>& points) {
+            return fromPoints(std::span<const P>(points));
+        }
+
+        template <typename P>
+        std::vector<P> toPoints() const {
+            std::vector<P> points(size());
+            for (std::size_t i = 0; i < size(); ++i) {
+                points[i].x = x_[i];
+                points[i].y = y_[i];
+            }
+            return points;
+        }
+
+        std::size_t size() const { return x_.size(); }
+        bool empty() const { return x_.empty(); }
+        void reserve(std::size_t n) { x_.reserve(n); y_.reserve(n); }
+        void push_back(int x, int y) { x_.push_back(x); y_.push_back(y); }
+
+        std::span<int> x() { return x_; }
+        std::span<int> y() { return y_; }
+        std::span<const int> x() const { return x_; }
+        std::span<const int> y() const { return y_; }
+
+        // Comme Point::move : place chaque point en (x, y) ; translate déplace
+        PointBatch& move(int x, int y) {
+            std::fill(x_.begin(), x_.end(), x);
+            std::fill(y_.begin(), y_.end(), y);
+            return *this;
+        }
+
+        // Symétrie par rapport à l'origine, sur place (pas de copie, contrairement à Point::reflect)
+        PointBatch& reflect(const Parallel& parallel = {}) {
+            detail::for_chunks(x_.data(), y_.data(), size(), parallel, [&](int* x, int* y, std::size_t n) {
+#if defined(__x86_64__)
+                if (parallel.simd && detail::has_avx2()) return detail::reflect_avx2(x, y, n);
+#endif
+                detail::reflect_scalar(x, y, n);
+            });
+            return *this;
+        }
+
+        PointBatch reflected(const Parallel& parallel = {}) const {
+            PointBatch copy = *this;
+            copy.reflect(parallel);
+            return copy;
+        }
+
+        PointBatch& translate(int dx, int dy, const Parallel& parallel = {}) {
+            detail::for_chunks(x_.data(), y_.data(), size(), parallel, [&](int* x, int* y, std::size_t n) {
+#if defined(__x86_64__)
+                if (parallel.simd && detail::has_avx2()) return detail::translate_avx2(x, y, n, dx, dy);
+#endif
+                detail::translate_scalar(x, y, n, dx, dy);
+            });
+            return *this;
+        }
+
+        PointBatch& affine(const Affine& m, const Parallel& parallel = {}) {
+            detail::for_chunks(x_.data(), y_.data(), size(), parallel, [&](int* x, int* y, std::size_t n) {
+#if defined(__x86_64__)
+                if (parallel.simd && detail::has_avx2()) return detail::affine_avx2(x, y, n, m);
+#endif
+                detail::affine_scalar(x, y, n, m);
+            });
+            return *this;
+        }
+
+        PointBatch& scale(double sx, double sy, const Parallel& parallel = {}) {
+            return affine(Affine::scaling(sx, sy), parallel);
+        }
+
+        // Rotation autour de l'origine, angle en radians
+        PointBatch& rotate(double radians, const Parallel& parallel = {}) {
+            return affine(Affine::rotation(radians), parallel);
+        }
+
+        // Les `limit` premiers points, au format de Point::display
+        void display(std::size_t limit = 10, std::ostream& out = std::cout) const {
+            for (std::size_t i = 0; i < std::min(limit, size()); ++i) {
+                out << "Point(" << x_[i] << ", " << y_[i] << ")\n";
+            }
+            if (size() > limit) {
+                out << "... (" << size() - limit << " more)\n";
+            }
+        }
+
+    private:
+        column x_;
+        column y_;
+    };
+
+}  // namespace geometry
+
+#endif //CPP_23_POINT_BATCH_H
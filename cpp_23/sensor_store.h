@@ -0,0 +1,511 @@
+#ifndef CPP_23_SENSOR_STORE_H
+#define CPP_23_SENSOR_STORE_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+// Stockage en mémoire des relevés de capteurs, par capteur et en colonnes compressées :
+//
+//   - horodatages : delta-of-delta (Gorilla), un relevé périodique coûte 1 bit ;
+//   - flottants   : XOR avec la valeur précédente (Gorilla), une valeur stable coûte 1 bit ;
+//   - entiers     : delta zigzag en champs de taille variable ;
+//   - chaînes     : dictionnaire partagé, un état inchangé coûte 1 bit.
+//
+// Chaque série est un anneau de blocs de taille fixe : quand il est plein, le bloc le plus
+// ancien est réutilisé. Chaque bloc garde son intervalle de temps, ce qui permet de sauter
+// les blocs hors de la plage demandée sans les décoder. Une série n'a qu'un écrivain.
+namespace sensor_store {
+
+    using value = std::variant<float, int, std::string>;
+    using value_view = std::variant<float, int, std::string_view>;
+    using timestamp = std::int64_t;   // microsecondes
+
+    struct sample_view {
+        timestamp time;
+        value_view data;
+    };
+
+    namespace detail {
+
+        inline std::uint64_t zigzag(std::int64_t v) {
+            return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+        }
+
+        inline std::int64_t unzigzag(std::uint64_t v) {
+            return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+        }
+
+        // Flux de bits de capacité fixe, bits de poids fort d'abord
+        template <std::size_t Words>
+        class bit_stream {
+        public:
+            static constexpr std::size_t capacity_bits = Words * 64;
+
+            std::size_t size_bits() const { return bits_; }
+            std::size_t free_bits() const { return capacity_bits - bits_; }
+
+            void clear() {
+                bits_ = 0;
+                words_.fill(0);
+            }
+
+            // `count` <= 64, les bits au-delà de `count` dans `v` doivent être nuls
+            void write(std::uint64_t v, unsigned count) {
+                if (count == 0) {
+                    return;
+                }
+                const std::size_t word = bits_ / 64;
+                const unsigned used = bits_ % 64;
+                const unsigned room = 64 - used;
+                if (count <= room) {
+                    words_[word] |= count == 64 ? v : v << (room - count);
+                } else {
+                    words_[word] |= v >> (count - room);
+                    words_[word + 1] |= v << (64 - (count - room));
+                }
+                bits_ += count;
+            }
+
+            void write_bit(bool bit) { write(bit ? 1 : 0, 1); }
+
+            class reader {
+            public:
+                explicit reader(const bit_stream& s) : words_(s.words_.data()) {}
+
+                std::uint64_t read(unsigned count) {
+                    if (count == 0) {
+                        return 0;
+                    }
+                    const std::size_t word = pos_ / 64;
+                    const unsigned used = pos_ % 64;
+                    const unsigned room = 64 - used;
+                    std::uint64_t v;
+                    if (count <= room) {
+                        v = words_[word] << used;
+                        v = count == 64 ? v : v >> (64 - count);
+                    } else {
+                        const unsigned rest = count - room;
+                        v = (words_[word] << used) >> (64 - room) << rest;
+                        v |= words_[word + 1] >> (64 - rest);
+                    }
+                    pos_ += count;
+                    return v;
+                }
+
+                bool read_bit() { return read(1) != 0; }
+
+                // Nombre de bits 1 consécutifs, au plus `max` (préfixes des codes à longueur variable)
+                unsigned read_ones(unsigned max) {
+                    unsigned n = 0;
+                    while (n < max && read_bit()) {
+                        ++n;
+                    }
+                    return n;
+                }
+
+            private:
+                const std::uint64_t* words_;
+                std::size_t pos_ = 0;
+            };
+
+        private:
+            std::array<std::uint64_t, Words + 1> words_{};   // un mot de garde pour les écritures à cheval
+            std::size_t bits_ = 0;
+        };
+
+        // Code à longueur variable : préfixe unaire (0, 10, 110, ...) puis un champ de la largeur choisie
+        template <std::size_t N>
+        struct varfield {
+            std::array<unsigned, N> widths;
+
+            template <typename Stream>
+            void write(Stream& out, std::uint64_t v) const {
+                for (std::size_t i = 0; i < N; ++i) {
+                    if (i + 1 == N || v < (std::uint64_t{1} << widths[i])) {
+                        // i bits à 1, puis un 0 sauf pour le dernier code
+                        out.write((std::uint64_t{1} << i) - 1, static_cast<unsigned>(i));
+                        if (i + 1 < N) out.write_bit(false);
+                        out.write(v, widths[i]);
+                        return;
+                    }
+                }
+            }
+
+            template <typename Reader>
+            std::uint64_t read(Reader& in) const {
+                return in.read(widths[in.read_ones(N - 1)]);
+            }
+        };
+
+        // 0 : champ vide (valeur nulle), puis 7, 9, 12, 32 et 64 bits
+        inline constexpr varfield<6> dod_field{{0, 7, 9, 12, 32, 64}};
+        // 0 : même valeur, puis 8, 16 et 64 bits
+        inline constexpr varfield<4> int_field{{0, 8, 16, 64}};
+        // 0 : identifiant 0, puis 8 et 32 bits
+        inline constexpr varfield<3> dict_field{{0, 8, 32}};
+
+        // Pire cas d'un relevé : de quoi décider si un bloc peut encore l'accepter
+        inline constexpr unsigned max_time_bits = 5 + 64;
+        inline constexpr unsigned max_value_bits = 3 + 2 + 5 + 5 + 64;
+
+    }  // namespace detail
+
+    // Dictionnaire des chaînes, partagé par toutes les séries d'un store
+    class dictionary {
+    public:
+        std::uint32_t intern(std::string_view s) {
+            const auto it = ids_.find(s);
+            if (it != ids_.end()) {
+                return it->second;
+            }
+            const auto id = static_cast<std::uint32_t>(strings_.size());
+            strings_.emplace_back(s);
+            ids_.emplace(strings_.back(), id);
+            return id;
+        }
+
+        std::string_view at(std::uint32_t id) const { return strings_[id]; }
+        std::size_t size() const { return strings_.size(); }
+
+        std::size_t memory_bytes() const {
+            std::size_t bytes = strings_.capacity() * sizeof(std::string) + ids_.size() * (sizeof(std::string) + 32);
+            for (const auto& s : strings_) bytes += s.capacity();
+            return bytes;
+        }
+
+    private:
+        // Recherche par string_view sans construire de std::string
+        struct string_hash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+
+        std::vector<std::string> strings_;
+        std::unordered_map<std::string, std::uint32_t, string_hash, std::equal_to<>> ids_;
+    };
+
+    // Bloc de taille fixe : une colonne d'horodatages et une colonne de valeurs.
+    // Le décodage repart toujours du début du bloc ; l'état de l'encodeur reste dans le bloc.
+    class block {
+    public:
+        static constexpr std::size_t time_words = 128;    // 1 Kio
+        static constexpr std::size_t value_words = 384;   // 3 Kio
+
+        // Vide le bloc et remet l'encodeur à zéro
+        void clear() {
+            times_.clear();
+            values_.clear();
+            count_ = 0;
+            delta_ = 0;
+            kind_ = kind::none;
+            float_bits_ = 0;
+            leading_ = 0;
+            meaningful_ = 0;
+            int_value_ = 0;
+            string_id_ = 0;
+            has_string_ = false;
+        }
+
+        std::size_t count() const { return count_; }
+        timestamp first_time() const { return first_time_; }
+        timestamp last_time() const { return last_time_; }
+
+        bool has_room() const {
+            return times_.free_bits() >= detail::max_time_bits && values_.free_bits() >= detail::max_value_bits;
+        }
+
+        // Le bloc doit avoir de la place (has_room) et les temps être croissants
+        void append(timestamp t, const value& v, dictionary& dict) {
+            append_time(t);
+            std::visit([&](const auto& x) { append_value(x, dict); }, v);
+            ++count_;
+        }
+
+        std::size_t bits_used() const { return times_.size_bits() + values_.size_bits(); }
+
+        template <typename F>
+        void scan(timestamp from, timestamp to, const dictionary& dict, F&& f) const {
+            time_stream::reader times(times_);
+            value_stream::reader values(values_);
+            timestamp t = 0;
+            std::int64_t delta = 0;
+            kind k = kind::none;
+            std::uint32_t float_bits = 0;
+            unsigned leading = 0;
+            unsigned meaningful = 0;
+            std::int64_t int_value = 0;
+            std::uint32_t string_id = 0;
+
+            for (std::size_t i = 0; i < count_; ++i) {
+                if (i == 0) {
+                    t = static_cast<timestamp>(times.read(64));
+                } else {
+                    delta += detail::unzigzag(detail::dod_field.read(times));
+                    t += delta;
+                }
+
+                if (values.read_bit()) {
+                    k = static_cast<kind>(values.read(2));
+                }
+                switch (k) {
+                    case kind::floating:
+                        if (values.read_bit()) {
+                            if (values.read_bit()) {
+                                leading = static_cast<unsigned>(values.read(5));
+                                meaningful = static_cast<unsigned>(values.read(5)) + 1;
+                            }
+                            const auto x = static_cast<std::uint32_t>(values.read(meaningful));
+                            float_bits ^= x << (32 - leading - meaningful);
+                        }
+                        break;
+                    case kind::integer:
+                        int_value += detail::unzigzag(detail::int_field.read(values));
+                        break;
+                    case kind::string:
+                        if (values.read_bit()) {
+                            string_id = static_cast<std::uint32_t>(detail::dict_field.read(values));
+                        }
+                        break;
+                    case kind::none:
+                        break;
+                }
+
+                if (t > to) {
+                    return;
+                }
+                if (t < from) {
+                    continue;
+                }
+                switch (k) {
+                    case kind::floating: f(sample_view{t, std::bit_cast<float>(float_bits)}); break;
+                    case kind::integer: f(sample_view{t, static_cast<int>(int_value)}); break;
+                    case kind::string: f(sample_view{t, dict.at(string_id)}); break;
+                    case kind::none: break;
+                }
+            }
+        }
+
+    private:
+        enum class kind : std::uint8_t { none = 0, floating = 1, integer = 2, string = 3 };
+
+        using time_stream = detail::bit_stream<time_words>;
+        using value_stream = detail::bit_stream<value_words>;
+
+        void append_time(timestamp t) {
+            if (count_ == 0) {
+                times_.write(static_cast<std::uint64_t>(t), 64);
+                first_time_ = t;
+                delta_ = 0;
+            } else {
+                const std::int64_t delta = t - last_time_;
+                detail::dod_field.write(times_, detail::zigzag(delta - delta_));
+                delta_ = delta;
+            }
+            last_time_ = t;
+        }
+
+        // Un bit « changement de type », suivi du type sur 2 bits s'il a changé
+        void append_kind(kind k) {
+            if (k == kind_ && count_ > 0) {
+                values_.write_bit(false);
+                return;
+            }
+            // Les valeurs précédentes de chaque type restent valables pour le décodeur
+            values_.write_bit(true);
+            values_.write(static_cast<std::uint64_t>(k), 2);
+            kind_ = k;
+        }
+
+        // XOR Gorilla sur 32 bits : 0 si identique, 10 si les bits significatifs tiennent dans
+        // la fenêtre précédente, 11 + fenêtre (5 + 5 bits) sinon
+        void append_value(float v, dictionary&) {
+            append_kind(kind::floating);
+            const auto bits = std::bit_cast<std::uint32_t>(v);
+            const std::uint32_t x = bits ^ float_bits_;
+            float_bits_ = bits;
+            if (x == 0) {
+                values_.write_bit(false);
+                return;
+            }
+            values_.write_bit(true);
+            const auto leading = static_cast<unsigned>(std::min(std::countl_zero(x), 31));
+            const auto trailing = static_cast<unsigned>(std::countr_zero(x));
+            if (meaningful_ != 0 && leading >= leading_ && trailing >= 32 - leading_ - meaningful_) {
+                values_.write_bit(false);
+            } else {
+                leading_ = leading;
+                meaningful_ = 32 - leading - trailing;
+                values_.write_bit(true);
+                values_.write(leading_, 5);
+                values_.write(meaningful_ - 1, 5);
+            }
+            values_.write(x >> (32 - leading_ - meaningful_), meaningful_);
+        }
+
+        void append_value(int v, dictionary&) {
+            append_kind(kind::integer);
+            detail::int_field.write(values_, detail::zigzag(static_cast<std::int64_t>(v) - int_value_));
+            int_value_ = v;
+        }
+
+        void append_value(const std::string& v, dictionary& dict) {
+            append_kind(kind::string);
+            if (has_string_ && dict.at(string_id_) == v) {
+                values_.write_bit(false);
+                return;
+            }
+            const std::uint32_t id = dict.intern(v);
+            values_.write_bit(true);
+            detail::dict_field.write(values_, id);
+            string_id_ = id;
+            has_string_ = true;
+        }
+
+        time_stream times_;
+        value_stream values_;
+        std::size_t count_ = 0;
+        timestamp first_time_ = 0;
+        timestamp last_time_ = 0;
+
+        // État de l'encodeur, remis à zéro par clear() à l'ouverture du bloc
+        std::int64_t delta_ = 0;
+        kind kind_ = kind::none;
+        std::uint32_t float_bits_ = 0;
+        unsigned leading_ = 0;
+        unsigned meaningful_ = 0;
+        std::int64_t int_value_ = 0;
+        std::uint32_t string_id_ = 0;
+        bool has_string_ = false;
+    };
+
+    // Série d'un capteur : anneau d'au plus `retention` blocs, alloués au fur et à mesure
+    class series {
+    public:
+        explicit series(std::size_t retention_blocks = 64) : retention_(std::max<std::size_t>(1, retention_blocks)) {}
+
+        // Refuse un relevé plus ancien que le dernier
+        bool append(timestamp t, const value& v, dictionary& dict) {
+            if (count_ > 0 && t < current().last_time()) {
+                return false;
+            }
+            if (count_ == 0 || !current().has_room()) {
+                open_block();
+            }
+            current().append(t, v, dict);
+            ++samples_;
+            return true;
+        }
+
+        // Appelle f(sample_view) pour chaque relevé de [from, to], dans l'ordre des temps
+        template <typename F>
+        void scan(timestamp from, timestamp to, const dictionary& dict, F&& f) const {
+            for (std::size_t i = 0; i < count_; ++i) {
+                const block& b = at(i);
+                if (b.last_time() < from) {
+                    continue;
+                }
+                if (b.first_time() > to) {
+                    break;
+                }
+                b.scan(from, to, dict, f);
+            }
+        }
+
+        std::size_t size() const {
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < count_; ++i) n += at(i).count();
+            return n;
+        }
+
+        std::uint64_t appended() const { return samples_; }
+        std::size_t memory_bytes() const { return blocks_.size() * sizeof(block) + blocks_.capacity() * sizeof(blocks_[0]); }
+
+        // Octets réellement occupés par les colonnes compressées
+        std::size_t encoded_bytes() const {
+            std::size_t bits = 0;
+            for (std::size_t i = 0; i < count_; ++i) bits += at(i).bits_used();
+            return (bits + 7) / 8;
+        }
+
+    private:
+        const block& at(std::size_t i) const { return *blocks_[(head_ + i) % blocks_.size()]; }
+        block& current() { return *blocks_[(head_ + count_ - 1) % blocks_.size()]; }
+        const block& current() const { return at(count_ - 1); }
+
+        void open_block() {
+            if (blocks_.size() < retention_) {
+                blocks_.push_back(std::make_unique<block>());
+                ++count_;
+                return;
+            }
+            // Anneau plein : le bloc le plus ancien est réutilisé
+            head_ = (head_ + 1) % blocks_.size();
+            current().clear();
+        }
+
+        std::size_t retention_;
+        std::vector<std::unique_ptr<block>> blocks_;
+        std::size_t head_ = 0;
+        std::size_t count_ = 0;
+        std::uint64_t samples_ = 0;
+    };
+
+    // Toutes les séries, indexées par identifiant de capteur
+    class store {
+    public:
+        explicit store(std::size_t retention_blocks = 64) : retention_(retention_blocks) {}
+
+        bool append(int sensor, timestamp t, const value& v) {
+            auto it = series_.find(sensor);
+            if (it == series_.end()) {
+                it = series_.emplace(sensor, series(retention_)).first;
+            }
+            return it->second.append(t, v, dictionary_);
+        }
+
+        template <typename F>
+        void scan(int sensor, timestamp from, timestamp to, F&& f) const {
+            const auto it = series_.find(sensor);
+            if (it != series_.end()) {
+                it->second.scan(from, to, dictionary_, f);
+            }
+        }
+
+        const series* find(int sensor) const {
+            const auto it = series_.find(sensor);
+            return it == series_.end() ? nullptr : &it->second;
+        }
+
+        std::size_t sensors() const { return series_.size(); }
+
+        std::size_t memory_bytes() const {
+            std::size_t bytes = dictionary_.memory_bytes();
+            for (const auto& [id, s] : series_) bytes += s.memory_bytes();
+            return bytes;
+        }
+
+        std::size_t encoded_bytes() const {
+            std::size_t bytes = 0;
+            for (const auto& [id, s] : series_) bytes += s.encoded_bytes();
+            return bytes;
+        }
+
+    private:
+        std::size_t retention_;
+        dictionary dictionary_;
+        std::unordered_map<int, series> series_;
+    };
+
+}  // namespace sensor_store
+
+#endif //CPP_23_SENSOR_STORE_H
@@ -0,0 +1,130 @@
+#ifndef CPP_23_STATIC_THREAD_POOL_H
+#define CPP_23_STATIC_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "runtime_metrics.h"
+
+namespace std {
+    namespace execution {
+
+        class static_thread_pool {
+        public:
+            // instrumented = false : aucune mesure (comparaison du coût des métriques)
+            explicit static_thread_pool(size_t numThreads, std::string name = "static_thread_pool", bool instrumented = true)
+                    : metrics_(std::move(name), numThreads), instrumented_(instrumented) {
+                start(numThreads);
+            }
+
+            ~static_thread_pool() {
+                stop();
+            }
+
+            // Mettre la tâche en file : les threads du pool vivent longtemps,
+            // ce qui garde leurs caches de buffers chauds
+            template <typename F>
+            void execute(F&& f) {
+                {
+                    std::unique_lock<std::mutex> lock(queueMutex);
+                    // Heure d'entrée en file pour les tâches chronométrées, 0 pour les autres
+                    const std::uint64_t enqueued = instrumented_ ? metrics_.on_submit(tasks.size() + 1) : 0;
+                    tasks.push({std::forward<F>(f), enqueued});
+                }
+                condition.notify_one();
+            }
+
+            // Attendre la fin de toutes les tâches
+            void wait() {
+                stop();
+            }
+
+            // File, attente et exécution des tâches, occupation des workers ; lisible à tout moment
+            runtime_metrics::pool_snapshot metrics() const {
+                return metrics_.snapshot();
+            }
+
+        private:
+            struct queued_task {
+                std::move_only_function<void()> run;
+                std::uint64_t enqueued_ns;      // 0 : tâche non chronométrée
+            };
+
+            std::vector<std::thread> threads;
+            std::queue<queued_task> tasks;
+            std::mutex queueMutex;
+            std::condition_variable condition;
+            bool stopPool = false;
+            runtime_metrics::pool_metrics metrics_;
+            const bool instrumented_;
+
+            // Démarrer le pool de threads
+            void start(size_t numThreads) {
+                for (size_t i = 0; i < numThreads; ++i) {
+                    threads.emplace_back([this, i] {
+                        while (true) {
+                            queued_task task;
+                            {
+                                std::unique_lock<std::mutex> lock(this->queueMutex);
+
+                                // Attendre qu'il y ait une tâche ou que le pool soit arrêté
+                                const auto ready = [this] {
+                                    return this->stopPool || !this->tasks.empty();
+                                };
+                                if (instrumented_ && !ready()) {
+                                    metrics_.on_idle_begin(i);
+                                    this->condition.wait(lock, ready);
+                                    metrics_.on_idle_end(i);
+                                } else {
+                                    this->condition.wait(lock, ready);
+                                }
+
+                                if (this->stopPool && this->tasks.empty()) {
+                                    if (instrumented_) metrics_.on_exit(i);
+                                    return;
+                                }
+
+                                task = std::move(this->tasks.front());
+                                this->tasks.pop();
+                                if (instrumented_) metrics_.on_depth(this->tasks.size());
+                            }
+                            if (task.enqueued_ns == 0) {
+                                task.run(); // Exécuter la tâche
+                            } else {
+                                const std::uint64_t started = runtime_metrics::now_ns();
+                                task.run();
+                                metrics_.on_sample(i, started - task.enqueued_ns, runtime_metrics::now_ns() - started);
+                            }
+                            if (instrumented_) metrics_.on_task(i);
+                        }
+                    });
+                }
+            }
+
+
+            void stop() {
+                {
+                    std::unique_lock<std::mutex> lock(queueMutex);
+                    stopPool = true;
+                }
+
+                condition.notify_all();
+
+                for (std::thread &thread : threads) {
+                    if (thread.joinable()) {
+                        thread.join();
+                    }
+                }
+            }
+        };
+
+    }  // namespace execution
+}  // namespace std
+
+#endif //CPP_23_STATIC_THREAD_POOL_H
@@ -0,0 +1,568 @@
+#ifndef CPP_23_TCP_SERVER_H
+#define CPP_23_TCP_SERVER_H
+
+#include <asio.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "admission.h"
+#include "async_log.h"
+#include "buffer_pool.h"
+#include "framing.h"
+
+namespace tcp_server {
+
+    using asio::ip::tcp;
+
+    // Nombre maximal de réponses regroupées dans un même write
+    inline constexpr std::size_t max_batch_frames = 256;
+
+    struct options {
+        admission::limits limits;
+        std::chrono::nanoseconds simulated_work{0};   // coût de traitement simulé par requête (benchmarks)
+    };
+
+    // Réponse envoyée quand le serveur refuse une connexion ou une requête
+    inline const std::array<std::uint8_t, 2> overloaded_frame = {0, static_cast<std::uint8_t>(framing::message_type::overloaded)};
+
+    // Une connexion : les requêtes peuvent être envoyées en pipeline, les réponses partent
+    // dans l'ordre. Toutes les trames complètes après une lecture sont traitées ensemble et
+    // leurs réponses regroupées dans un seul write (gather) par tour de boucle d'événements.
+    //
+    // Contre-pression : la lecture est suspendue tant que la connexion a trop d'octets en
+    // attente d'envoi ou de requêtes non traitées ; elle reprend à la fin du write en cours.
+    // Délestage : une requête qui a trop attendu reçoit tout de suite une réponse `overloaded`.
+    class connection : public std::enable_shared_from_this<connection> {
+    public:
+        connection(tcp::socket socket, std::shared_ptr<admission::controller> admission,
+                   std::chrono::nanoseconds simulated_work = {})
+                : socket_(std::move(socket)), admission_(std::move(admission)), simulated_work_(simulated_work) {
+            gather_.reserve(max_batch_frames * (1 + buffer_pool::max_segments));
+        }
+
+        void start() {
+            asio::error_code ignored;
+            socket_.set_option(tcp::no_delay(true), ignored);
+            do_read();
+        }
+
+    private:
+        using clock = admission::clock;
+
+        // Heure d'arrivée des octets : fin de la plage (offset dans input_) et instant de la lecture
+        struct arrival {
+            std::size_t end;
+            clock::time_point at;
+        };
+        static constexpr std::size_t max_arrivals = 64;
+        static constexpr std::size_t max_read_size = 64 * 1024;
+
+        void do_read() {
+            if (reading_ || closing_) {
+                return;
+            }
+            const admission::limits& limits = admission_->config();
+            // La limite porte sur la mémoire allouée (slabs), pas seulement sur les octets valides.
+            // Sans write en cours rien ne reprendrait la lecture : la trame incomplète doit finir.
+            if (writing_ && (input_.capacity() >= limits.max_buffered_input || outbound_bytes_ >= limits.max_outbound_bytes)) {
+                // Reprise à la fin du write en cours
+                admission_->note_paused_read();
+                return;
+            }
+            reading_ = true;
+            const std::size_t want = std::max(read_size_, parser_.wanted());
+            socket_.async_read_some(input_.prepare(want), [self = shared_from_this(), want](const asio::error_code& ec, std::size_t n) {
+                self->reading_ = false;
+                if (ec) {
+                    self->close();
+                    return;
+                }
+                // Lecture pleine : le noyau a sans doute encore des octets en attente. On lit plus
+                // gros la fois suivante pour que cette file devienne visible au délestage.
+                self->read_size_ = n == want ? std::min(2 * self->read_size_, max_read_size)
+                                             : std::max(self->read_size_ / 2, buffer_pool::default_read_size);
+                self->input_.commit(n);
+                self->mark_arrival(clock::now());
+                self->flush();
+                self->do_read();
+            });
+        }
+
+        // Découpe les trames complètes qui ne sont pas déjà en cours d'envoi et
+        // envoie toutes les réponses en un seul write
+        void flush() {
+            if (writing_ || closed_) {
+                return;
+            }
+            gather_.clear();
+            outbound_bytes_ = 0;
+            admitted_ = 0;
+            std::size_t offset = 0;
+            std::size_t frames = 0;
+            while (frames < max_batch_frames && !closing_ && outbound_bytes_ < admission_->config().max_outbound_bytes) {
+                framing::frame request;
+                const framing::decode_status status = parser_.next(input_, offset, request);
+                if (status == framing::decode_status::need_more) {
+                    break;
+                }
+                if (status != framing::decode_status::ok) {
+                    append_error(frames);
+                    closing_ = true;
+                    ++frames;
+                    break;
+                }
+                offset += request.size;
+                // Le séjour compte aussi le traitement des trames précédentes du même lot
+                const auto now = clock::now();
+                if (admission_->should_shed(now - arrival_of(offset), now) || !admission_->try_begin_request()) {
+                    append_overloaded();
+                } else {
+                    ++admitted_;
+                    handle(request, frames);
+                }
+                ++frames;
+                buffer_pool::note_request();
+            }
+
+            if (gather_.empty()) {
+                if (closing_) close();
+                return;
+            }
+
+            batch_input_ = offset;
+            writing_ = true;
+            asio::async_write(socket_, gather_, [self = shared_from_this()](const asio::error_code& ec, std::size_t) {
+                self->writing_ = false;
+                self->admission_->end_requests(self->admitted_);
+                self->admitted_ = 0;
+                self->outbound_bytes_ = 0;
+                if (ec) {
+                    self->close();
+                    return;
+                }
+                // Les payloads envoyés référençaient la chaîne de réception : on ne la libère qu'ici
+                self->input_.consume(self->batch_input_);
+                self->parser_.consumed(self->batch_input_);
+                self->consume_arrivals(self->batch_input_);
+                self->batch_input_ = 0;
+                if (self->closing_) {
+                    self->close();
+                    return;
+                }
+                self->flush();
+                self->do_read();
+            });
+        }
+
+        // Réponse à une requête : l'en-tête est écrit dans headers_, le payload
+        // est renvoyé directement depuis les slabs de réception
+        void handle(const framing::frame& request, std::size_t slot) {
+            if (request.type != framing::message_type::echo_request) {
+                append_error(slot);
+                closing_ = true;
+                return;
+            }
+            if (simulated_work_.count() > 0) {
+                const auto until = clock::now() + simulated_work_;
+                while (clock::now() < until) {
+                }
+            }
+            const std::size_t n = framing::encode_header(framing::message_type::echo_response, request.payload_size, headers_[slot].data());
+            gather_.push_back(asio::buffer(headers_[slot].data(), n));
+            for (const auto& buffer : request.payload) {
+                gather_.push_back(buffer);
+            }
+            outbound_bytes_ += n + request.payload_size;
+        }
+
+        void append_error(std::size_t slot) {
+            const std::size_t n = framing::encode_header(framing::message_type::error, 0, headers_[slot].data());
+            gather_.push_back(asio::buffer(headers_[slot].data(), n));
+            outbound_bytes_ += n;
+        }
+
+        void append_overloaded() {
+            gather_.push_back(asio::buffer(overloaded_frame));
+            outbound_bytes_ += overloaded_frame.size();
+        }
+
+        void mark_arrival(clock::time_point now) {
+            if (arrival_count_ == max_arrivals) {
+                // Anneau plein (client qui envoie par petits morceaux) : la dernière plage absorbe les
+                // nouveaux octets et prend l'heure de cette lecture. La tête garde l'heure la plus
+                // ancienne ; une trame qui se termine maintenant n'a pas encore attendu.
+                arrivals_[(arrival_head_ + arrival_count_ - 1) % max_arrivals] = {input_.size(), now};
+                return;
+            }
+            arrivals_[(arrival_head_ + arrival_count_) % max_arrivals] = {input_.size(), now};
+            ++arrival_count_;
+        }
+
+        // Instant de la lecture qui a apporté l'octet `end - 1`
+        clock::time_point arrival_of(std::size_t end) const {
+            for (std::size_t i = 0; i < arrival_count_; ++i) {
+                const arrival& a = arrivals_[(arrival_head_ + i) % max_arrivals];
+                if (a.end >= end) {
+                    return a.at;
+                }
+            }
+            return clock::now();
+        }
+
+        void consume_arrivals(std::size_t bytes) {
+            while (arrival_count_ > 0 && arrivals_[arrival_head_].end <= bytes) {
+                arrival_head_ = (arrival_head_ + 1) % max_arrivals;
+                --arrival_count_;
+            }
+            for (std::size_t i = 0; i < arrival_count_; ++i) {
+                arrivals_[(arrival_head_ + i) % max_arrivals].end -= bytes;
+            }
+        }
+
+        void close() {
+            if (closed_) {
+                return;
+            }
+            closed_ = true;
+            closing_ = true;
+            asio::error_code ignored;
+            socket_.shutdown(tcp::socket::shutdown_both, ignored);
+            socket_.close(ignored);
+            admission_->close_connection();
+        }
+
+        tcp::socket socket_;
+        std::shared_ptr<admission::controller> admission_;
+        std::chrono::nanoseconds simulated_work_;
+        buffer_pool::buffer_chain input_;
+        framing::frame_parser parser_;
+        std::size_t read_size_ = buffer_pool::default_read_size;
+        std::array<arrival, max_arrivals> arrivals_{};
+        std::size_t arrival_head_ = 0;
+        std::size_t arrival_count_ = 0;
+        std::array<std::array<std::uint8_t, framing::max_header_size>, max_batch_frames> headers_{};
+        std::vector<asio::const_buffer> gather_;
+        std::size_t batch_input_ = 0;     // octets d'entrée référencés par le write en cours
+        std::size_t outbound_bytes_ = 0;  // octets du write en cours
+        std::size_t admitted_ = 0;        // requêtes admises dans le write en cours
+        bool reading_ = false;
+        bool writing_ = false;
+        bool closing_ = false;
+        bool closed_ = false;
+    };
+
+    // Mesure le retard de la boucle d'événements : un timer périodique note l'écart entre son
+    // échéance et l'exécution de son handler. C'est l'attente, invisible depuis les connexions,
+    // des lectures prêtes dans le noyau pendant que le thread est occupé ailleurs.
+    class lag_probe {
+    public:
+        lag_probe(asio::io_context& io, std::shared_ptr<admission::controller> admission,
+                  std::chrono::milliseconds period = std::chrono::milliseconds(1))
+                : timer_(io), admission_(std::move(admission)), period_(period) {}
+
+        void start() {
+            if (!admission_->config().shedding) {
+                return;
+            }
+            timer_.expires_after(period_);
+            timer_.async_wait([this](const asio::error_code& ec) {
+                if (ec) {
+                    return;
+                }
+                admission_->note_loop_lag(admission::clock::now() - timer_.expiry());
+                start();
+            });
+        }
+
+        void stop() { timer_.cancel(); }
+
+    private:
+        asio::steady_timer timer_;
+        std::shared_ptr<admission::controller> admission_;
+        std::chrono::milliseconds period_;
+    };
+
+    // Accepte une connexion si la limite le permet, sinon répond `overloaded` et ferme aussitôt
+    inline void admit(tcp::socket socket, const std::shared_ptr<admission::controller>& admission,
+                      const options& opts) {
+        if (admission->try_open_connection()) {
+            std::make_shared<connection>(std::move(socket), admission, opts.simulated_work)->start();
+            return;
+        }
+        auto rejected = std::make_shared<tcp::socket>(std::move(socket));
+        asio::async_write(*rejected, asio::buffer(overloaded_frame), [rejected](const asio::error_code&, std::size_t) {
+            asio::error_code ignored;
+            rejected->shutdown(tcp::socket::shutdown_both, ignored);
+            rejected->close(ignored);
+        });
+    }
+
+    // Accepteur asynchrone : chaque connexion reçoit son propre strand, les threads
+    // qui exécutent io_context.run() se partagent toutes les connexions.
+    class server {
+    public:
+        server(asio::io_context& io, unsigned short port, options opts = {})
+                : io_(io), acceptor_(io, tcp::endpoint(tcp::v4(), port)), options_(opts),
+                  admission_(std::make_shared<admission::controller>(opts.limits)), probe_(io, admission_) {}
+
+        unsigned short port() const { return acceptor_.local_endpoint().port(); }
+        const admission::controller& admission() const { return *admission_; }
+
+        void start() {
+            probe_.start();
+            do_accept();
+        }
+
+        void stop() {
+            asio::error_code ignored;
+            acceptor_.close(ignored);
+            probe_.stop();
+        }
+
+    private:
+        void do_accept() {
+            acceptor_.async_accept(asio::make_strand(io_), [this](const asio::error_code& ec, tcp::socket socket) {
+                if (ec == asio::error::operation_aborted) {
+                    return;
+                }
+                if (!ec) {
+                    admit(std::move(socket), admission_, options_);
+                } else {
+                    async_log::error("Erreur: {}", ec.message());
+                }
+                do_accept();
+            });
+        }
+
+        asio::io_context& io_;
+        tcp::acceptor acceptor_;
+        options options_;
+        std::shared_ptr<admission::controller> admission_;
+        lag_probe probe_;
+    };
+
+    // File de messages entre shards : MPSC bornée sans verrou (cellules numérotées à la Vyukov).
+    // Réservée aux opérations partagées, rares ; le chemin des requêtes n'y passe jamais.
+    template <typename T>
+    class cross_shard_queue {
+    public:
+        explicit cross_shard_queue(std::size_t capacity) : cells_(std::bit_ceil(capacity)), mask_(cells_.size() - 1) {
+            for (std::size_t i = 0; i < cells_.size(); ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        // Appelable depuis n'importe quel thread ; false si la file est pleine
+        bool try_push(T value) {
+            std::size_t pos = tail_.load(std::memory_order_relaxed);
+            for (;;) {
+                cell& c = cells_[pos & mask_];
+                const std::size_t seq = c.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        c.value = std::move(value);
+                        c.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Réservé au thread du shard destinataire
+        bool try_pop(T& out) {
+            cell& c = cells_[head_ & mask_];
+            if (c.sequence.load(std::memory_order_acquire) != head_ + 1) {
+                return false;
+            }
+            out = std::move(c.value);
+            c.sequence.store(head_ + cells_.size(), std::memory_order_release);
+            ++head_;
+            return true;
+        }
+
+    private:
+        struct cell {
+            std::atomic<std::size_t> sequence{0};
+            T value{};
+        };
+
+        std::vector<cell> cells_;
+        std::size_t mask_;
+        alignas(64) std::atomic<std::size_t> tail_{0};
+        alignas(64) std::size_t head_ = 0;
+    };
+
+    inline bool pin_current_thread(std::size_t cpu) {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu % CPU_SETSIZE, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+    // Mode un shard par cœur : chaque shard a son io_context à un seul thread, son propre
+    // acceptor sur le même port (SO_REUSEPORT, le noyau répartit les connexions) et son
+    // thread épinglé. L'état des connexions reste local au shard, sans verrou ni strand.
+    class sharded_server {
+    public:
+        using message = std::move_only_function<void()>;
+
+        class shard {
+        public:
+            shard(std::size_t index, unsigned short port, const options& opts)
+                    : index_(index), io_(1), acceptor_(io_), inbox_(1024), options_(opts),
+                      admission_(std::make_shared<admission::controller>(opts.limits)), probe_(io_, admission_) {
+                using reuse_port = asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+                const tcp::endpoint endpoint(tcp::v4(), port);
+                acceptor_.open(endpoint.protocol());
+                acceptor_.set_option(tcp::acceptor::reuse_address(true));
+                acceptor_.set_option(reuse_port(true));
+                acceptor_.bind(endpoint);
+                acceptor_.listen();
+            }
+
+            std::size_t index() const { return index_; }
+            unsigned short port() const { return acceptor_.local_endpoint().port(); }
+            asio::io_context& context() { return io_; }
+
+            // Compteurs locaux : écrits uniquement par le thread du shard
+            std::size_t active_connections() const { return admission_->connections(); }
+            std::uint64_t accepted_connections() const { return accepted_; }
+            const admission::controller& admission() const { return *admission_; }
+
+            // Dépose un message pour ce shard ; le shard n'est réveillé que si sa file était au repos
+            bool post(message m) {
+                if (!inbox_.try_push(std::move(m))) {
+                    return false;
+                }
+                if (!drain_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+                    asio::post(io_, [this] { drain(); });
+                }
+                return true;
+            }
+
+            void run(bool pin) {
+                if (pin) {
+                    pin_current_thread(index_);
+                }
+                probe_.start();
+                do_accept();
+                io_.run();
+            }
+
+            void stop() {
+                asio::post(io_, [this] {
+                    asio::error_code ignored;
+                    acceptor_.close(ignored);
+                    io_.stop();
+                });
+            }
+
+        private:
+            void do_accept() {
+                acceptor_.async_accept(io_, [this](const asio::error_code& ec, tcp::socket socket) {
+                    if (ec == asio::error::operation_aborted) {
+                        return;
+                    }
+                    if (!ec) {
+                        ++accepted_;
+                        admit(std::move(socket), admission_, options_);
+                    } else {
+                        async_log::error("Erreur: {}", ec.message());
+                    }
+                    do_accept();
+                });
+            }
+
+            void drain() {
+                drain_scheduled_.store(false, std::memory_order_release);
+                message m;
+                while (inbox_.try_pop(m)) {
+                    m();
+                }
+            }
+
+            std::size_t index_;
+            asio::io_context io_;
+            tcp::acceptor acceptor_;
+            cross_shard_queue<message> inbox_;
+            std::atomic<bool> drain_scheduled_{false};
+            options options_;
+            std::shared_ptr<admission::controller> admission_;   // limites propres au shard
+            lag_probe probe_;
+            std::uint64_t accepted_ = 0;
+        };
+
+        // Le port 0 est résolu par le premier shard, les suivants se lient au même port.
+        // Les limites de connexions et de requêtes en vol sont réparties entre les shards.
+        sharded_server(std::size_t shards, unsigned short port, options opts = {}) {
+            options per_shard = opts;
+            per_shard.limits.max_connections = std::max<std::size_t>(1, opts.limits.max_connections / shards);
+            per_shard.limits.max_inflight_requests = std::max<std::size_t>(1, opts.limits.max_inflight_requests / shards);
+            for (std::size_t i = 0; i < shards; ++i) {
+                shards_.push_back(std::make_unique<shard>(i, i == 0 ? port : shards_.front()->port(), per_shard));
+            }
+        }
+
+        unsigned short port() const { return shards_.front()->port(); }
+        std::size_t size() const { return shards_.size(); }
+        shard& at(std::size_t i) { return *shards_[i]; }
+
+        // À appeler depuis le thread dédié au shard i
+        void run_shard(std::size_t i, bool pin = true) { shards_[i]->run(pin); }
+
+        void stop() {
+            for (auto& s : shards_) {
+                s->stop();
+            }
+        }
+
+        // Exemple d'opération partagée : chaque shard lit ses compteurs sur son propre thread
+        // et renvoie le résultat au demandeur par un message, sans verrou partagé.
+        void collect_active_connections(std::function<void(std::size_t)> done) {
+            struct gather {
+                std::atomic<std::size_t> remaining;
+                std::atomic<std::size_t> total{0};
+                std::function<void(std::size_t)> done;
+            };
+            auto state = std::make_shared<gather>();
+            state->remaining = shards_.size();
+            state->done = std::move(done);
+            for (auto& s : shards_) {
+                shard* target = s.get();
+                target->post([target, state] {
+                    state->total.fetch_add(target->active_connections(), std::memory_order_relaxed);
+                    if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        state->done(state->total.load(std::memory_order_relaxed));
+                    }
+                });
+            }
+        }
+
+    private:
+        std::vector<std::unique_ptr<shard>> shards_;
+    };
+
+}  // namespace tcp_server
+
+#endif //CPP_23_TCP_SERVER_H
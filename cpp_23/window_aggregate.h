@@ -0,0 +1,477 @@
+#ifndef CPP_23_WINDOW_AGGREGATE_H
+#define CPP_23_WINDOW_AGGREGATE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Agrégats glissants et par fenêtres fixes (tumbling) sur le flux des capteurs, mis à jour
+// en O(1) amorti par relevé :
+//
+//   - count / moyenne / écart-type : sommes soustraites à l'éviction ;
+//   - min / max : deques monotones ;
+//   - quantiles : DDSketch, dont les compteurs se décrémentent aussi à l'éviction.
+//
+// Un seul thread alimente une fenêtre ; les autres lisent le dernier instantané publié
+// sans verrou (seqlock), au plus `publish_every` relevés en retard. Les quantiles de la
+// fenêtre glissante (un parcours des buckets) ne sont recalculés qu'après autant de
+// relevés que le sketch compte de buckets, et à chaque publish() explicite.
+namespace window_aggregate {
+
+    using timestamp = std::int64_t;   // microsecondes
+
+    // Instantané lisible depuis n'importe quel thread ; T doit être trivialement copiable
+    template <typename T>
+    class seqlock {
+        static_assert(std::is_trivially_copyable_v<T>);
+        static constexpr std::size_t words = (sizeof(T) + 7) / 8;
+
+    public:
+        void store(const T& value) {
+            std::uint64_t raw[words] = {};
+            std::memcpy(raw, &value, sizeof(T));
+            const std::uint64_t seq = seq_.load(std::memory_order_relaxed);
+            seq_.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (std::size_t i = 0; i < words; ++i) {
+                data_[i].store(raw[i], std::memory_order_relaxed);
+            }
+            seq_.store(seq + 2, std::memory_order_release);
+        }
+
+        T load() const {
+            std::uint64_t raw[words];
+            for (;;) {
+                const std::uint64_t before = seq_.load(std::memory_order_acquire);
+                if (before & 1) {
+                    continue;
+                }
+                for (std::size_t i = 0; i < words; ++i) {
+                    raw[i] = data_[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq_.load(std::memory_order_relaxed) == before) {
+                    break;
+                }
+            }
+            T value;
+            std::memcpy(&value, raw, sizeof(T));
+            return value;
+        }
+
+    private:
+        std::atomic<std::uint64_t> seq_{0};
+        std::atomic<std::uint64_t> data_[words] = {};
+    };
+
+    // DDSketch : buckets logarithmiques de précision relative `alpha`. Les compteurs
+    // s'ajoutent (merge de fenêtres) et se retirent (éviction d'une fenêtre glissante).
+    class ddsketch {
+    public:
+        explicit ddsketch(double alpha = 0.01)
+                : gamma_((1 + alpha) / (1 - alpha)), inv_log_gamma_(1.0 / std::log(gamma_)) {}
+
+        // Bucket d'une valeur : 0 pour zéro, index + 1 signé pour les autres. Calculé une fois
+        // par relevé (un logarithme) puis réutilisé pour l'éviction et par les autres sketches.
+        int key_of(double v) const {
+            if (std::abs(v) < min_indexable) {
+                return 0;
+            }
+            return v > 0 ? index_of(v) + key_bias : -(index_of(-v) + key_bias);
+        }
+
+        void add_key(int key, std::int64_t n = 1) {
+            if (key == 0) {
+                zero_ += n;
+            } else if (key > 0) {
+                positive_.add(key - key_bias, n);
+            } else {
+                negative_.add(-key - key_bias, n);
+            }
+            count_ += n;
+        }
+
+        void add(double v, std::int64_t n = 1) { add_key(key_of(v), n); }
+        void remove(double v) { add(v, -1); }
+
+        void merge(const ddsketch& other) {
+            positive_.merge(other.positive_);
+            negative_.merge(other.negative_);
+            zero_ += other.zero_;
+            count_ += other.count_;
+        }
+
+        void clear() {
+            positive_.clear();
+            negative_.clear();
+            zero_ = 0;
+            count_ = 0;
+        }
+
+        std::int64_t count() const { return count_; }
+
+        // Nombre de buckets parcourus par quantile()
+        std::size_t buckets() const { return negative_.counts.size() + 1 + positive_.counts.size(); }
+
+        // Quantile q dans [0, 1], à alpha près en relatif
+        double quantile(double q) const {
+            if (count_ <= 0) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            const auto rank = static_cast<std::int64_t>(q * static_cast<double>(count_ - 1));
+            std::int64_t seen = 0;
+            // Négatifs : du plus grand module au plus petit
+            for (std::size_t i = negative_.counts.size(); i-- > 0;) {
+                seen += negative_.counts[i];
+                if (seen > rank) return -value_of(negative_.offset + static_cast<int>(i));
+            }
+            seen += zero_;
+            if (seen > rank) return 0.0;
+            for (std::size_t i = 0; i < positive_.counts.size(); ++i) {
+                seen += positive_.counts[i];
+                if (seen > rank) return value_of(positive_.offset + static_cast<int>(i));
+            }
+            return value_of(positive_.offset + static_cast<int>(positive_.counts.size()) - 1);
+        }
+
+    private:
+        static constexpr double min_indexable = 1e-9;
+        // Décalage qui garde les clés non nulles : index_of(min_indexable) vaut environ -1036
+        static constexpr int key_bias = 1 << 20;
+
+        // Compteurs denses pour les index [offset, offset + counts.size())
+        struct store {
+            int offset = 0;
+            std::vector<std::int64_t> counts;
+
+            void add(int index, std::int64_t n) {
+                if (counts.empty()) {
+                    offset = index;
+                    counts.assign(1, 0);
+                } else if (index < offset) {
+                    counts.insert(counts.begin(), static_cast<std::size_t>(offset - index), 0);
+                    offset = index;
+                } else if (index >= offset + static_cast<int>(counts.size())) {
+                    counts.resize(static_cast<std::size_t>(index - offset + 1), 0);
+                }
+                counts[static_cast<std::size_t>(index - offset)] += n;
+            }
+
+            void merge(const store& other) {
+                for (std::size_t i = 0; i < other.counts.size(); ++i) {
+                    if (other.counts[i] != 0) add(other.offset + static_cast<int>(i), other.counts[i]);
+                }
+            }
+
+            void clear() { std::fill(counts.begin(), counts.end(), 0); }
+        };
+
+        int index_of(double v) const { return static_cast<int>(std::ceil(std::log(v) * inv_log_gamma_)); }
+        double value_of(int index) const { return 2.0 * std::pow(gamma_, index) / (gamma_ + 1.0); }
+
+        double gamma_;
+        double inv_log_gamma_;
+        store positive_;
+        store negative_;
+        std::int64_t zero_ = 0;
+        std::int64_t count_ = 0;
+    };
+
+    // File circulaire à capacité doublée au besoin : push/pop aux deux bouts sans allocation
+    // en régime établi (std::deque libère et réalloue ses blocs en oscillant autour d'une frontière)
+    template <typename T>
+    class ring {
+    public:
+        bool empty() const { return size_ == 0; }
+        std::size_t size() const { return size_; }
+
+        T& front() { return items_[head_]; }
+        const T& front() const { return items_[head_]; }
+        T& back() { return items_[(head_ + size_ - 1) & mask_]; }
+        const T& back() const { return items_[(head_ + size_ - 1) & mask_]; }
+        const T& operator[](std::size_t i) const { return items_[(head_ + i) & mask_]; }
+
+        void push_back(const T& item) {
+            if (size_ == items_.size()) {
+                grow();
+            }
+            items_[(head_ + size_) & mask_] = item;
+            ++size_;
+        }
+
+        void pop_front() {
+            head_ = (head_ + 1) & mask_;
+            --size_;
+        }
+
+        void pop_back() { --size_; }
+
+    private:
+        void grow() {
+            std::vector<T> bigger(std::max<std::size_t>(16, 2 * items_.size()));
+            for (std::size_t i = 0; i < size_; ++i) {
+                bigger[i] = (*this)[i];
+            }
+            items_ = std::move(bigger);
+            mask_ = items_.size() - 1;
+            head_ = 0;
+        }
+
+        std::vector<T> items_;
+        std::size_t head_ = 0;
+        std::size_t size_ = 0;
+        std::size_t mask_ = 0;
+    };
+
+    struct stats {
+        std::uint64_t count = 0;
+        double mean = 0;
+        double stddev = 0;
+        double min = 0;
+        double max = 0;
+        double p50 = 0;
+        double p90 = 0;
+        double p99 = 0;
+        timestamp from = 0;    // fenêtre couverte
+        timestamp to = 0;
+    };
+
+    // Ce que les lecteurs voient : la fenêtre glissante courante et la dernière fenêtre fixe terminée
+    struct snapshot {
+        stats sliding;
+        stats tumbling;
+    };
+
+    struct options {
+        timestamp sliding = 60'000'000;     // largeur de la fenêtre glissante
+        timestamp tumbling = 60'000'000;    // largeur des fenêtres fixes, alignées sur 0
+        double alpha = 0.01;                // précision relative des quantiles
+        std::uint32_t publish_every = 16;   // relevés entre deux instantanés
+    };
+
+    // Agrégats d'une série de valeurs numériques horodatées (temps croissants)
+    class window {
+    public:
+        explicit window(const options& opts = {}) : opts_(opts), sketch_(opts.alpha), tumbling_sketch_(opts.alpha) {}
+
+        void update(timestamp t, double v) {
+            // Fenêtre fixe terminée : on publie son résumé et on repart de zéro
+            if (tumbling_count_ > 0 && t >= tumbling_start_ + opts_.tumbling) {
+                close_tumbling();
+                since_publish_ = opts_.publish_every;    // le résumé terminé part avec ce relevé
+            }
+            if (tumbling_count_ == 0) {
+                tumbling_start_ = t - ((t % opts_.tumbling) + opts_.tumbling) % opts_.tumbling;
+            }
+            ++tumbling_count_;
+            tumbling_sum_ += v;
+            tumbling_sum_sq_ += v * v;
+            tumbling_min_ = tumbling_count_ == 1 ? v : std::min(tumbling_min_, v);
+            tumbling_max_ = tumbling_count_ == 1 ? v : std::max(tumbling_max_, v);
+            const int key = sketch_.key_of(v);
+            tumbling_sketch_.add_key(key);
+
+            // Fenêtre glissante
+            const std::uint64_t seq = pushed_++;
+            samples_.push_back({t, v, key});
+            sum_ += v;
+            sum_sq_ += v * v;
+            sketch_.add_key(key);
+            while (!min_.empty() && min_.back().value > v) min_.pop_back();
+            min_.push_back({seq, v});
+            while (!max_.empty() && max_.back().value < v) max_.pop_back();
+            max_.push_back({seq, v});
+            evict(t - opts_.sliding);
+
+            ++since_quantiles_;
+            if (++since_publish_ >= opts_.publish_every) {
+                publish(false);
+            }
+        }
+
+        // Horloge qui avance sans données : ferme la fenêtre fixe échue et retire les relevés
+        // antérieurs à `t - sliding`
+        void advance(timestamp t) {
+            if (tumbling_count_ > 0 && t >= tumbling_start_ + opts_.tumbling) {
+                close_tumbling();
+            }
+            evict(t - opts_.sliding);
+            publish();
+        }
+
+        // Publie l'instantané. Avec `exact`, les quantiles sont recalculés (O(nombre de buckets)) ;
+        // sinon seulement si assez de relevés sont arrivés pour amortir ce parcours.
+        void publish(bool exact = true) {
+            since_publish_ = 0;
+            const bool quantiles = exact || since_quantiles_ >= sketch_.buckets();
+            if (quantiles) {
+                since_quantiles_ = 0;
+            }
+            update_sliding(quantiles);
+            published_.store(current_);
+        }
+
+        // Lecture sans verrou depuis n'importe quel thread
+        snapshot read() const { return published_.load(); }
+
+        std::size_t size() const { return samples_.size(); }
+
+    private:
+        struct sample {
+            timestamp time;
+            double value;
+            int key;        // bucket du sketch
+        };
+
+        // Entrée des deques monotones : numéro d'ordre du relevé dans la série
+        struct extremum {
+            std::uint64_t seq;
+            double value;
+        };
+
+        void evict(timestamp horizon) {
+            while (!samples_.empty() && samples_.front().time <= horizon) {
+                const sample s = samples_.front();
+                const std::uint64_t seq = popped_++;
+                samples_.pop_front();
+                sum_ -= s.value;
+                sum_sq_ -= s.value * s.value;
+                sketch_.add_key(s.key, -1);
+                if (!min_.empty() && min_.front().seq == seq) min_.pop_front();
+                if (!max_.empty() && max_.front().seq == seq) max_.pop_front();
+                ++evicted_since_rebase_;
+            }
+            // Les soustractions accumulent des erreurs d'arrondi : on recalcule les sommes
+            // une fois qu'autant de relevés ont été retirés que la fenêtre en contient (O(1) amorti)
+            if (evicted_since_rebase_ >= std::max<std::size_t>(samples_.size(), 1024)) {
+                sum_ = 0;
+                sum_sq_ = 0;
+                for (std::size_t i = 0; i < samples_.size(); ++i) {
+                    sum_ += samples_[i].value;
+                    sum_sq_ += samples_[i].value * samples_[i].value;
+                }
+                evicted_since_rebase_ = 0;
+            }
+        }
+
+        static double stddev_of(double sum, double sum_sq, std::uint64_t n) {
+            if (n < 2) return 0;
+            const double mean = sum / static_cast<double>(n);
+            return std::sqrt(std::max(0.0, sum_sq / static_cast<double>(n) - mean * mean));
+        }
+
+        // Sans `quantiles`, p50 / p90 / p99 gardent leur dernière valeur calculée
+        void update_sliding(bool quantiles) {
+            stats& s = current_.sliding;
+            s.count = samples_.size();
+            if (s.count == 0) {
+                s = {};
+                return;
+            }
+            s.mean = sum_ / static_cast<double>(s.count);
+            s.stddev = stddev_of(sum_, sum_sq_, s.count);
+            s.min = min_.front().value;
+            s.max = max_.front().value;
+            if (quantiles) {
+                s.p50 = sketch_.quantile(0.50);
+                s.p90 = sketch_.quantile(0.90);
+                s.p99 = sketch_.quantile(0.99);
+            }
+            s.from = samples_.front().time;
+            s.to = samples_.back().time;
+        }
+
+        void close_tumbling() {
+            stats& s = current_.tumbling;
+            s.count = tumbling_count_;
+            s.mean = tumbling_sum_ / static_cast<double>(tumbling_count_);
+            s.stddev = stddev_of(tumbling_sum_, tumbling_sum_sq_, tumbling_count_);
+            s.min = tumbling_min_;
+            s.max = tumbling_max_;
+            s.p50 = tumbling_sketch_.quantile(0.50);
+            s.p90 = tumbling_sketch_.quantile(0.90);
+            s.p99 = tumbling_sketch_.quantile(0.99);
+            s.from = tumbling_start_;
+            s.to = tumbling_start_ + opts_.tumbling;
+            tumbling_count_ = 0;
+            tumbling_sum_ = 0;
+            tumbling_sum_sq_ = 0;
+            tumbling_sketch_.clear();
+        }
+
+        options opts_;
+
+        ring<sample> samples_;
+        ring<extremum> min_;    // valeurs croissantes : le minimum est en tête
+        ring<extremum> max_;    // valeurs décroissantes : le maximum est en tête
+        std::uint64_t pushed_ = 0;
+        std::uint64_t popped_ = 0;
+        double sum_ = 0;
+        double sum_sq_ = 0;
+        ddsketch sketch_;
+        std::size_t evicted_since_rebase_ = 0;
+
+        timestamp tumbling_start_ = 0;
+        std::uint64_t tumbling_count_ = 0;
+        double tumbling_sum_ = 0;
+        double tumbling_sum_sq_ = 0;
+        double tumbling_min_ = 0;
+        double tumbling_max_ = 0;
+        ddsketch tumbling_sketch_;
+
+        std::uint32_t since_publish_ = 0;
+        std::size_t since_quantiles_ = 0;
+        snapshot current_;
+        seqlock<snapshot> published_;
+    };
+
+    // Une fenêtre par capteur, identifiants denses dans [0, capacity). Les fenêtres sont créées
+    // par le thread qui alimente ; un lecteur qui voit un pointeur non nul peut lire sans verrou.
+    class engine {
+    public:
+        explicit engine(std::size_t capacity, const options& opts = {})
+                : opts_(opts),
+                  owned_(std::make_unique<std::unique_ptr<window>[]>(capacity)),
+                  windows_(std::make_unique<std::atomic<window*>[]>(capacity)),
+                  capacity_(capacity) {}
+
+        std::size_t capacity() const { return capacity_; }
+
+        // Côté écrivain ; les identifiants hors capacité sont ignorés
+        void update(int sensor, timestamp t, double v) {
+            if (sensor < 0 || static_cast<std::size_t>(sensor) >= capacity_) {
+                return;
+            }
+            std::unique_ptr<window>& w = owned_[sensor];
+            if (w == nullptr) {
+                w = std::make_unique<window>(opts_);
+                windows_[sensor].store(w.get(), std::memory_order_release);
+            }
+            w->update(t, v);
+        }
+
+        // Côté lecteurs : aucun verrou, nullptr si le capteur n'a encore rien envoyé
+        const window* find(int sensor) const {
+            if (sensor < 0 || static_cast<std::size_t>(sensor) >= capacity_) {
+                return nullptr;
+            }
+            return windows_[sensor].load(std::memory_order_acquire);
+        }
+
+    private:
+        options opts_;
+        std::unique_ptr<std::unique_ptr<window>[]> owned_;     // côté écrivain
+        std::unique_ptr<std::atomic<window*>[]> windows_;      // publiés aux lecteurs
+        std::size_t capacity_;
+    };
+
+}  // namespace window_aggregate
+
+#endif //CPP_23_WINDOW_AGGREGATE_H
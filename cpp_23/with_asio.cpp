@@ -1,148 +1,73 @@
 #include <iostream>
 #include <asio.hpp>
 #include <execution>
+#include <optional>
 #include <thread>
 #include <vector>
-#include <queue>
-#include <mutex>
-#include <functional>
-#include <condition_variable>
-
-namespace std {
-    namespace execution {
-
-        class static_thread_pool {
-        public:
-            explicit static_thread_pool(size_t numThreads) {
-                start(numThreads);
-            }
-
-            ~static_thread_pool() {
-                stop();
-            }
-
-            template <typename F>
-            void execute(F&& f) {
-                std::thread(std::forward<F>(f)).detach();  // Détacher le thread pour l'exécution
-            }
-
-            // Attendre la fin de toutes les tâches
-            void wait() {
-                stop();
+#include "runtime_metrics.h"
+#include "static_thread_pool.h"
+#include "tcp_server.h"
+
+// Usage : with_asio [port] [threads] [shared|sharded] [métriques]
+//
+// Le protocole (trames avec longueur en varint, requêtes en pipeline) et la gestion
+// des connexions sont dans tcp_server.h.
+//   shared  : les threads du pool exécutent tous le même io_context (un strand par connexion)
+//   sharded : un shard par cœur (io_context, acceptor SO_REUSEPORT et thread épinglé)
+// métriques : un numéro de port (servies en HTTP sur 127.0.0.1) ou un chemin de fichier,
+//             réécrit chaque seconde ; format texte de Prometheus
+int main(int argc, char* argv[]) {
+    // Journal asynchrone : les threads du réseau ne prennent jamais le verrou de std::cout
+    async_log::session logging;
+    try {
+        const unsigned short port = argc > 1 ? static_cast<unsigned short>(std::stoi(argv[1])) : 12345;
+        const std::size_t threads = argc > 2 ? std::stoul(argv[2]) : 4;
+        const std::string mode = argc > 3 ? argv[3] : "shared";
+
+        // Créer un pool d'exécuteurs qui font tourner les boucles d'événements
+        std::execution::static_thread_pool pool(threads, "with_asio");
+
+        std::optional<runtime_metrics::exporter> metrics;
+        if (argc > 4) {
+            const std::string target = argv[4];
+            runtime_metrics::export_options options;
+            if (target.find_first_not_of("0123456789") == std::string::npos) {
+                options.port = static_cast<std::uint16_t>(std::stoi(target));
+            } else {
+                options.path = target;
             }
-
-        private:
-            std::vector<std::thread> threads;
-            std::queue<std::function<void()>> tasks;
-            std::mutex queueMutex;
-            std::condition_variable condition;
-            bool stopPool = false;
-
-            // Démarrer le pool de threads
-            void start(size_t numThreads) {
-                for (size_t i = 0; i < numThreads; ++i) {
-                    threads.emplace_back([this] {
-                        while (true) {
-                            std::function<void()> task;
-                            {
-                                std::unique_lock<std::mutex> lock(this->queueMutex);
-
-                                // Attendre qu'il y ait une tâche ou que le pool soit arrêté
-                                this->condition.wait(lock, [this] {
-                                    return this->stopPool || !this->tasks.empty();
-                                });
-
-                                if (this->stopPool && this->tasks.empty()) {
-                                    return;
-                                }
-
-                                task = std::move(this->tasks.front());
-                                this->tasks.pop();
-                            }
-                            task(); // Exécuter la tâche
-                        }
-                    });
-                }
+            metrics.emplace(std::vector<runtime_metrics::exporter::source>{
+                    [&pool] { return runtime_metrics::to_prometheus(pool.metrics()); }}, options);
+            if (options.port != 0 && !metrics->listening()) {
+                async_log::error("Métriques : port {} indisponible", options.port);
             }
+        }
 
-
-            void stop() {
-                {
-                    std::unique_lock<std::mutex> lock(queueMutex);
-                    stopPool = true;
-                }
-
-                condition.notify_all();
-
-                for (std::thread &thread : threads) {
-                    if (thread.joinable()) {
-                        thread.join();
-                    }
-                }
+        if (mode == "sharded") {
+            tcp_server::sharded_server server(threads, port);
+            async_log::info("Serveur démarré ({} shards)...", threads);
+            for (std::size_t i = 0; i < threads; ++i) {
+                pool.execute([&server, i] {
+                    server.run_shard(i);
+                });
             }
-        };
-
-    }  // namespace execution
-}  // namespace std
-
-using asio::ip::tcp;
-
-// Fonction pour gérer une connexion
-void handle_connection(tcp::socket socket) {
-    try {
-        std::vector<char> data(1024);
-        // Lire des données
-        std::size_t length = socket.read_some(asio::buffer(data));
-        std::cout << "Données reçues: " << std::string(data.data(), length) << std::endl;
-    } catch (std::exception& e) {
-        std::cerr << "Erreur: " << e.what() << std::endl;
-    }
-}
-
-int main() {
-    try {
-        asio::io_context io_context;
-        tcp::acceptor acceptor(io_context, tcp::endpoint(tcp::v4(), 12345));
-
-        // Créer un pool d'exécuteurs
-        std::execution::static_thread_pool pool(4); // 4 threads dans le pool
+            pool.wait();
+            return 0;
+        }
 
-        std::cout << "Serveur démarré..." << std::endl;
+        asio::io_context io_context(static_cast<int>(threads));
+        tcp_server::server server(io_context, port);
+        server.start();
 
-        while (true) {
-            tcp::socket socket(io_context);
-            acceptor.accept(socket);
+        async_log::info("Serveur démarré...");
 
-            // Distribuer la gestion de la connexion à un exécuteur
-            pool.execute([socket = std::move(socket)]() mutable {
-                handle_connection(std::move(socket));
+        for (std::size_t i = 0; i < threads; ++i) {
+            pool.execute([&io_context] {
+                io_context.run();
             });
         }
+        pool.wait();
     } catch (std::exception& e) {
-        std::cerr << "Exception: " << e.what() << std::endl;
-    }
-
-    try {
-        asio::io_context io_context;
-
-        // Résoudre l'adresse et le port du serveur
-        tcp::resolver resolver(io_context);
-        tcp::resolver::results_type endpoints = resolver.resolve("127.0.0.1", "12345");
-
-        // Créer un socket
-        tcp::socket socket(io_context);
-
-        // Se connecter à l'un des endpoints
-        asio::connect(socket, endpoints);
-
-        // Message à envoyer au serveur
-        std::string message = "Hello from client!";
-
-        // Envoyer le message
-        asio::write(socket, asio::buffer(message));
-
-        std::cout << "Message envoyé: " << message << std::endl;
-    } catch (std::exception& e) {
-        std::cerr << "Exception: " << e.what() << std::endl;
+        async_log::error("Exception: {}", e.what());
     }
-}
\ No newline at end of file
+}
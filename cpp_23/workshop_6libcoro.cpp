@@ -1,66 +1,190 @@
+#include <atomic>
 #include <iostream>
 #include <variant>
 #include <vector>
 #include <string>
 #include <thread>
 #include <random>
+#include <memory>
+#include <optional>
 #include <coro/task.hpp>
+#include <coro/event.hpp>
 #include <coro/sync_wait.hpp>
+#include <coro/when_all.hpp>
+#include <coro/io_scheduler.hpp>
 #include <chrono>
+#include "async_log.h"
+#include "sensor_store.h"
+#include "window_aggregate.h"
 
 // Definition of sensor data types
 using SensorData = std::variant<float, int, std::string>;
 
-// Simulates asynchronous retrieval of sensor data using coroutines
-coro::task<SensorData> fetchSensorDataAsync(int sensorID) {
-    // Simulate delay
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+using Scheduler = std::shared_ptr<coro::io_scheduler>;
+
+// Simulated sensor: how long it takes to answer and how long we are willing to wait for it
+struct Sensor {
+    int id;
+    std::chrono::milliseconds latency;
+    std::chrono::milliseconds timeout;
+};
+
+// Result of one poll: no value if the sensor did not answer before its timeout
+struct SensorReading {
+    int sensorID;
+    std::optional<SensorData> data;
+};
+
+// One race between a sensor's answer and its timeout: the first side to finish stores the
+// outcome and wakes the poller, the other one runs to its end and is ignored
+struct FetchRace {
+    std::atomic<bool> decided{false};
+    std::optional<SensorData> data;
+    coro::event done;
+
+    void finish(std::optional<SensorData> outcome) {
+        if (decided.exchange(true, std::memory_order_acq_rel)) return;
+        data = std::move(outcome);
+        done.set();
+    }
+};
+
+// The simulated device answers after its latency
+coro::task<void> sensorAnswer(Scheduler scheduler, Sensor sensor, std::shared_ptr<FetchRace> race) {
+    co_await scheduler->yield_for(sensor.latency);
+    if (race->decided.load(std::memory_order_acquire)) co_return;  // too late, the timer won
 
     // Simulate different types of data based on sensor ID
-    if (sensorID % 3 == 0) co_return 25.3f;  // Temperature
-    if (sensorID % 3 == 1) co_return 1013;   // Pressure
-    co_return std::string("OK");             // Operating state
+    if (sensor.id % 3 == 0) race->finish(25.3f);  // Temperature
+    else if (sensor.id % 3 == 1) race->finish(1013);  // Pressure
+    else race->finish(std::string("OK"));  // Operating state
 }
 
-// Function to process sensor data using std::variant and pattern matching
+coro::task<void> sensorTimeout(Scheduler scheduler, std::chrono::milliseconds timeout, std::shared_ptr<FetchRace> race) {
+    co_await scheduler->yield_for(timeout);
+    race->finish(std::nullopt);
+}
+
+// Simulates asynchronous retrieval of sensor data using coroutines.
+// The delays are awaitable timers of the io_scheduler: the pool thread is released
+// while the sensor "answers", so thousands of fetches can wait at the same time.
+// Like a poll() with a timeout on a real socket, the fetch and a timer start together and
+// whichever finishes first decides: a stuck sensor yields no value at the deadline.
+// Both sides are owned by the scheduler and share the race state, so the loser may end
+// after this task without touching freed memory.
+coro::task<std::optional<SensorData>> fetchSensorDataAsync(Scheduler scheduler, Sensor sensor) {
+    auto race = std::make_shared<FetchRace>();
+    scheduler->spawn(sensorAnswer(scheduler, sensor, race));
+    scheduler->spawn(sensorTimeout(scheduler, sensor.timeout, race));
+    co_await race->done;
+    co_return std::move(race->data);
+}
+
+// Polls one sensor with its own timeout
+coro::task<SensorReading> pollSensor(Scheduler scheduler, Sensor sensor) {
+    co_return SensorReading{sensor.id, co_await fetchSensorDataAsync(scheduler, sensor)};
+}
+
+// Function to process sensor data using std::variant and pattern matching.
+// Lines go through the asynchronous logger: the caller only copies the value into its ring.
 void processSensorData(const SensorData& data) {
     std::visit([](auto&& value) {
         using T = std::remove_cvref_t<decltype(value)>;
         if constexpr (std::is_same_v<T, float>) {
-            std::cout << "Temperature: " << value << " °C\n";
+            async_log::info("Temperature: {} °C", value);
         } else if constexpr (std::is_same_v<T, int>) {
-            std::cout << "Pressure: " << value << " Pa\n";
+            async_log::info("Pressure: {} Pa", value);
         } else if constexpr (std::is_same_v<T, std::string>) {
-            std::cout << "Operating state: " << value << "\n";
+            async_log::info("Operating state: {}", value);
         } else {
-            std::cout << "Unknown type\n";
+            async_log::warning("Unknown type");
         }
     }, data);
 }
 
-// Main function of the real-time data monitoring system with coroutines
-coro::task<void> runSensorTasks(int sensorCount) {
-    std::vector<coro::task<SensorData>> sensorTasks;
-
-    // Retrieve sensor data asynchronously using coroutines
+// Simulated fleet: latencies around 200 ms, and one sensor in 20 that hangs far beyond its timeout
+std::vector<Sensor> makeSensors(int sensorCount) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> jitter(150, 250);
+    std::vector<Sensor> sensors;
+    sensors.reserve(sensorCount);
     for (int i = 0; i < sensorCount; ++i) {
-        sensorTasks.push_back(fetchSensorDataAsync(i));
+        const bool stuck = i % 20 == 19;
+        sensors.push_back({i, std::chrono::milliseconds(stuck ? 5000 : jitter(rng)), std::chrono::milliseconds(500)});
     }
+    return sensors;
+}
 
-    // Wait and process the results from all sensors
-    for (int i = 0; i < sensorCount; ++i) {
-        SensorData data = co_await sensorTasks[i];
-        processSensorData(data);
+// Main function of the real-time data monitoring system with coroutines:
+// all sensors are polled concurrently and gathered with when_all,
+// so the whole round takes about one sensor latency (bounded by the timeouts).
+// Every answer is also kept in the compressed history store, and numeric values
+// feed the rolling aggregates that other threads can read at any time.
+coro::task<void> runSensorTasks(Scheduler scheduler, int sensorCount, bool verbose, sensor_store::store& history,
+                                window_aggregate::engine& windows) {
+    std::vector<coro::task<SensorReading>> sensorTasks;
+    sensorTasks.reserve(sensorCount);
+
+    for (const Sensor& sensor : makeSensors(sensorCount)) {
+        sensorTasks.push_back(pollSensor(scheduler, sensor));
     }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto results = co_await coro::when_all(std::move(sensorTasks));
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    const auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    int answered = 0;
+    int timedOut = 0;
+    for (auto& result : results) {
+        const SensorReading& reading = result.return_value();
+        if (!reading.data) {
+            ++timedOut;
+            if (verbose) async_log::warning("Sensor {}: timeout", reading.sensorID);
+            continue;
+        }
+        ++answered;
+        history.append(reading.sensorID, now, *reading.data);
+        if (const float* temperature = std::get_if<float>(&*reading.data)) {
+            windows.update(reading.sensorID, now, *temperature);
+        } else if (const int* pressure = std::get_if<int>(&*reading.data)) {
+            windows.update(reading.sensorID, now, *pressure);
+        }
+        if (verbose) processSensorData(*reading.data);
+    }
+
+    async_log::info("{} sensors: {} answered, {} timed out in {} ms", sensorCount, answered, timedOut, elapsed.count());
 }
 
 int main() {
-    const int sensorCount = 10;
+    async_log::session logging;
+
+    // Timers run on the scheduler's own thread, resumed coroutines on the pool
+    auto scheduler = coro::io_scheduler::make_shared(coro::io_scheduler::options{
+            .thread_strategy = coro::io_scheduler::thread_strategy_t::spawn,
+            .pool = coro::thread_pool::options{.thread_count = std::max(1u, std::thread::hardware_concurrency())},
+            .execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_on_thread_pool});
 
-    // Run the sensor tasks and wait for their completion
-    coro::sync_wait(runSensorTasks(sensorCount));
+    // Run the sensor tasks and wait for their completion; the duration stays
+    // close to one timeout whatever the number of sensors
+    sensor_store::store history;
+    // One poll per round and per sensor: publish every sample
+    window_aggregate::engine windows(100000, {.publish_every = 1});
+    for (int sensorCount : {10, 1000, 100000}) {
+        coro::sync_wait(runSensorTasks(scheduler, sensorCount, sensorCount <= 10, history, windows));
+    }
+    // The report below goes straight to std::cout: write the logged lines first
+    async_log::flush();
+    // Read from the main thread while the pool owns the writers
+    if (const auto* temperature = windows.find(0)) {
+        const auto rolling = temperature->read().sliding;
+        std::cout << "Sensor 0 over the last minute: " << rolling.count << " samples, mean " << rolling.mean
+                  << " °C, min " << rolling.min << ", max " << rolling.max << ", p99 " << rolling.p99 << '\n';
+    }
+    std::cout << "History: " << history.sensors() << " sensors, " << history.encoded_bytes() << " bytes encoded\n";
 
     std::cout << "Real-time data monitoring system completed.\n";
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,530 @@
+#ifndef CPP_23_XML_STREAM_H
+#define CPP_23_XML_STREAM_H
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// Lecture XML en flux, à la demande (pull) : chaque appel de next() rend le jeton suivant
+// (ouverture d'élément, attribut, fermeture, texte) sous forme de string_view dans le tampon.
+// L'entrée est soit un document entier en mémoire (fichier projeté), soit une fonction de
+// lecture appelée par blocs : le tampon garde alors une taille fixe quelle que soit la taille
+// du document, un jeton à cheval sur deux blocs est recollé en tête de tampon, et un texte
+// plus long que le tampon est rendu en plusieurs morceaux.
+// La recherche de '<', '&', '>' et des guillemets se fait par blocs de 32 octets (AVX2).
+namespace xml_stream {
+
+    enum class kind : std::uint8_t {
+        start_element,  // name
+        attribute,      // name, value (brute, entités non décodées)
+        end_element,    // name ; aussi rendu pour <a/>
+        text,           // value ; CDATA compris
+        end_document,
+    };
+
+    struct token {
+        kind type = kind::end_document;
+        std::string_view name;
+        std::string_view value;
+        bool has_entities = false;  // value contient '&' : voir decode()
+        bool partial = false;       // morceau de texte, la suite vient au jeton suivant
+    };
+
+    struct error {
+        std::uint64_t offset;       // position dans le document
+        const char* message;
+    };
+
+    struct options {
+        std::size_t buffer_size = std::size_t{256} << 10;   // lecture par blocs
+        std::size_t max_token = std::size_t{16} << 20;      // balise la plus longue acceptée
+        bool skip_whitespace_text = true;                   // blancs entre éléments ignorés
+    };
+
+    // Lit au plus n octets dans buffer : nombre lu, 0 en fin de flux, négatif (-errno) en erreur
+    using read_function = std::function<std::ptrdiff_t(char* buffer, std::size_t n)>;
+
+    namespace detail {
+
+        template <char... C>
+        inline const char* find_scalar(const char* p, const char* end) {
+            for (; p < end; ++p) {
+                if (((*p == C) || ...)) return p;
+            }
+            return end;
+        }
+
+#if defined(__x86_64__)
+        template <char... C>
+        __attribute__((target("avx2"))) const char* find_avx2(const char* p, const char* end) {
+            for (; p + 32 <= end; p += 32) {
+                const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                const __m256i hits = (_mm256_cmpeq_epi8(in, _mm256_set1_epi8(C)) | ...);
+                if (const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits))) {
+                    return p + __builtin_ctz(mask);
+                }
+            }
+            return find_scalar<C...>(p, end);
+        }
+
+        inline bool has_avx2() {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+#endif
+
+        // Premier des caractères C dans [p, end), end sinon
+        template <char... C>
+        inline const char* find(const char* p, const char* end) {
+#if defined(__x86_64__)
+            if (has_avx2()) return find_avx2<C...>(p, end);
+#endif
+            return find_scalar<C...>(p, end);
+        }
+
+        inline bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+        inline bool is_name_end(char c) { return is_space(c) || c == '/' || c == '>' || c == '='; }
+
+        inline bool all_space(std::string_view s) {
+            return std::all_of(s.begin(), s.end(), is_space);
+        }
+
+    }  // namespace detail
+
+    // Décodage des entités prédéfinies et des références numériques vers UTF-8.
+    // Renvoie false sur une entité inconnue ou mal formée.
+    inline bool decode(std::string_view raw, std::string& out) {
+        out.clear();
+        out.reserve(raw.size());
+        for (std::size_t i = 0; i < raw.size(); ++i) {
+            if (raw[i] != '&') {
+                out.push_back(raw[i]);
+                continue;
+            }
+            const std::size_t semicolon = raw.find(';', i);
+            if (semicolon == std::string_view::npos) return false;
+            const std::string_view name = raw.substr(i + 1, semicolon - i - 1);
+            i = semicolon;
+            if (name == "lt") out.push_back('<');
+            else if (name == "gt") out.push_back('>');
+            else if (name == "amp") out.push_back('&');
+            else if (name == "quot") out.push_back('"');
+            else if (name == "apos") out.push_back('\'');
+            else if (name.size() > 1 && name[0] == '#') {
+                const bool hex = name[1] == 'x';
+                const std::string_view digits = name.substr(hex ? 2 : 1);
+                std::uint32_t code = 0;
+                const auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), code, hex ? 16 : 10);
+                if (ec != std::errc() || ptr != digits.data() + digits.size() || digits.empty() || code > 0x10FFFF) {
+                    return false;
+                }
+                if (code < 0x80) {
+                    out.push_back(static_cast<char>(code));
+                } else if (code < 0x800) {
+                    out.push_back(static_cast<char>(0xC0 | code >> 6));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                } else if (code < 0x10000) {
+                    out.push_back(static_cast<char>(0xE0 | code >> 12));
+                    out.push_back(static_cast<char>(0x80 | (code >> 6 & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                } else {
+                    out.push_back(static_cast<char>(0xF0 | code >> 18));
+                    out.push_back(static_cast<char>(0x80 | (code >> 12 & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (code >> 6 & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                }
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Les vues rendues restent valides jusqu'au prochain appel de next(), sauf pour une balise
+    // ouvrante : son nom et ses attributs restent valides jusqu'au jeton qui suit la balise.
+    class tokenizer {
+    public:
+        // Document entier déjà en mémoire (fichier projeté) : aucune copie
+        explicit tokenizer(std::string_view document, const options& opts = {})
+                : options_(opts), data_(document.data()), end_(document.size()), eof_(true) {}
+
+        // Lecture par blocs dans un tampon de taille fixe
+        explicit tokenizer(read_function read, const options& opts = {})
+                : options_(opts), read_(std::move(read)),
+                  storage_(std::make_unique_for_overwrite<char[]>(opts.buffer_size)),
+                  capacity_(opts.buffer_size) {
+            data_ = storage_.get();
+        }
+
+        static tokenizer from_fd(int fd, const options& opts = {}) { return tokenizer(fd_reader(fd), opts); }
+
+        static read_function fd_reader(int fd) {
+            return [fd](char* buffer, std::size_t n) -> std::ptrdiff_t {
+                for (;;) {
+                    const ssize_t r = ::read(fd, buffer, n);
+                    if (r >= 0) return r;
+                    if (errno != EINTR) return -errno;
+                }
+            };
+        }
+
+        // Document suivant lu par blocs : le tampon de lecture, les attributs et la pile des
+        // noms gardent leur capacité d'un document à l'autre
+        void reset(read_function read) {
+            read_ = std::move(read);
+            if (!storage_) {
+                storage_ = std::make_unique_for_overwrite<char[]>(options_.buffer_size);
+                capacity_ = options_.buffer_size;
+            }
+            data_ = storage_.get();
+            pos_ = end_ = 0;
+            consumed_ = 0;
+            eof_ = false;
+            in_cdata_ = false;
+            in_text_ = false;
+            failed_.reset();
+            attributes_.clear();
+            next_attribute_ = 0;
+            pending_close_ = false;
+            pending_name_ = {};
+            names_.clear();
+            name_ends_.clear();
+        }
+
+        std::expected<token, error> next();
+
+        // Profondeur d'imbrication courante
+        std::size_t depth() const { return name_ends_.size(); }
+
+        // Octets consommés depuis le début du document
+        std::uint64_t offset() const { return consumed_ + pos_; }
+
+    private:
+        struct attribute {
+            std::string_view name;
+            std::string_view value;
+            bool has_entities;
+        };
+
+        std::unexpected<error> fail(const char* message) {
+            failed_ = error{offset(), message};
+            return std::unexpected(*failed_);
+        }
+
+        std::string_view available() const { return {data_ + pos_, end_ - pos_}; }
+
+        // Recolle le reste non consommé en tête et lit la suite ; false si rien de plus à lire
+        bool refill();
+
+        std::expected<token, error> read_text();
+        std::expected<token, error> read_cdata();
+        std::expected<bool, error> skip_declaration();
+        std::expected<token, error> read_markup();
+        std::expected<token, error> read_start_tag(std::size_t tag_end);
+        std::expected<token, error> read_end_tag(std::size_t tag_end);
+        bool skip_until(std::string_view terminator);
+
+        void push_name(std::string_view name) {
+            names_.append(name);
+            name_ends_.push_back(names_.size());
+        }
+
+        std::string_view top_name() const {
+            const std::size_t begin = name_ends_.size() > 1 ? name_ends_[name_ends_.size() - 2] : 0;
+            return std::string_view(names_).substr(begin, name_ends_.back() - begin);
+        }
+
+        void pop_name() {
+            name_ends_.pop_back();
+            names_.resize(name_ends_.empty() ? 0 : name_ends_.back());
+        }
+
+        options options_;
+        read_function read_;
+        std::unique_ptr<char[]> storage_;
+        std::size_t capacity_ = 0;
+        const char* data_ = nullptr;
+        std::size_t pos_ = 0;           // premier octet non consommé
+        std::size_t end_ = 0;           // fin des octets valides
+        std::uint64_t consumed_ = 0;    // octets déjà sortis du tampon
+        bool eof_ = false;
+        bool in_cdata_ = false;
+        bool in_text_ = false;          // dernier jeton rendu : morceau partiel d'un texte
+        std::optional<error> failed_;
+
+        // Balise ouvrante en cours de restitution
+        std::vector<attribute> attributes_;
+        std::size_t next_attribute_ = 0;
+        bool pending_close_ = false;
+        std::string_view pending_name_;
+
+        // Pile des éléments ouverts, noms mis bout à bout (mémoire bornée par la profondeur)
+        std::string names_;
+        std::vector<std::size_t> name_ends_;
+    };
+
+    inline bool tokenizer::refill() {
+        if (eof_) return false;
+        if (pos_ > 0) {
+            std::memmove(storage_.get(), data_ + pos_, end_ - pos_);
+            consumed_ += pos_;
+            end_ -= pos_;
+            pos_ = 0;
+        }
+        if (end_ == capacity_) {
+            // Jeton plus grand que le tampon : on l'agrandit, dans la limite de max_token
+            if (capacity_ >= options_.max_token) return false;
+            const std::size_t bigger = std::min(2 * capacity_, options_.max_token);
+            auto storage = std::make_unique_for_overwrite<char[]>(bigger);
+            std::memcpy(storage.get(), storage_.get(), end_);
+            storage_ = std::move(storage);
+            data_ = storage_.get();
+            capacity_ = bigger;
+        }
+        const std::ptrdiff_t n = read_(storage_.get() + end_, capacity_ - end_);
+        if (n <= 0) {
+            eof_ = true;
+            if (n < 0) {
+                failed_ = error{offset(), "lecture impossible"};
+            }
+            return false;
+        }
+        end_ += static_cast<std::size_t>(n);
+        return true;
+    }
+
+    inline std::expected<token, error> tokenizer::next() {
+        if (failed_) return std::unexpected(*failed_);
+
+        // Suite de la balise ouvrante déjà découpée
+        if (next_attribute_ < attributes_.size()) {
+            const attribute& a = attributes_[next_attribute_++];
+            return token{kind::attribute, a.name, a.value, a.has_entities};
+        }
+        if (pending_close_) {
+            pending_close_ = false;
+            pop_name();
+            return token{kind::end_element, pending_name_, {}};
+        }
+        if (in_cdata_) return read_cdata();
+
+        for (;;) {
+            if (pos_ == end_ && !refill()) {
+                if (failed_) return std::unexpected(*failed_);
+                if (!name_ends_.empty()) return fail("document incomplet");
+                return token{kind::end_document, {}, {}};
+            }
+            if (data_[pos_] == '<') {
+                // Commentaire, instruction de traitement ou DOCTYPE : sautés
+                const auto skipped = skip_declaration();
+                if (!skipped) return std::unexpected(skipped.error());
+                if (*skipped) continue;
+                return read_markup();
+            }
+            // Seul un texte entier peut être sauté : la fin d'un texte rendu en morceaux est
+            // toujours rendue, même blanche, pour que le dernier morceau ne soit jamais perdu
+            auto text = read_text();
+            if (!text) return text;
+            const bool continued = std::exchange(in_text_, text->partial);
+            if (!options_.skip_whitespace_text || text->partial || continued || !detail::all_space(text->value)) {
+                return text;
+            }
+        }
+    }
+
+    inline std::expected<token, error> tokenizer::read_text() {
+        for (;;) {
+            const char* begin = data_ + pos_;
+            const char* const end = data_ + end_;
+            const char* stop = detail::find<'<', '&'>(begin, end);
+            bool has_entities = false;
+            while (stop != end && *stop == '&') {
+                has_entities = true;
+                stop = detail::find<'<'>(stop + 1, end);
+            }
+            if (stop != end || eof_) {
+                token t{kind::text, {}, std::string_view(begin, static_cast<std::size_t>(stop - begin)), has_entities};
+                pos_ += t.value.size();
+                return t;
+            }
+            if (pos_ > 0 || end_ < capacity_) {
+                // Le texte continue peut-être dans le bloc suivant
+                if (refill()) continue;
+                if (failed_) return std::unexpected(*failed_);
+                continue;   // fin de flux : rendu au tour suivant
+            }
+            // Tampon plein de texte : on rend un morceau, coupé avant une entité incomplète.
+            // Le dernier octet reste : le morceau final n'est jamais vide et n'est pas partiel.
+            std::string_view piece(begin, end_ - 1);
+            if (has_entities) {
+                const std::size_t amp = piece.rfind('&');
+                if (piece.find(';', amp) == std::string_view::npos) {
+                    if (amp == 0) {
+                        // Entité plus longue que le tampon : on l'agrandit plutôt que de la couper
+                        if (refill()) continue;
+                        if (failed_) return std::unexpected(*failed_);
+                        return fail("entité trop longue");
+                    }
+                    piece = piece.substr(0, amp);
+                }
+            }
+            pos_ += piece.size();
+            return token{kind::text, {}, piece, has_entities, true};
+        }
+    }
+
+    inline std::expected<token, error> tokenizer::read_cdata() {
+        constexpr std::string_view terminator = "]]>";
+        for (;;) {
+            const std::string_view rest = available();
+            const std::size_t close = rest.find(terminator);
+            if (close != std::string_view::npos) {
+                in_cdata_ = false;
+                pos_ += close + terminator.size();
+                return token{kind::text, {}, rest.substr(0, close)};
+            }
+            if (eof_) return fail("CDATA non fermé");
+            if (rest.size() >= capacity_ / 2) {
+                // Morceau rendu en gardant de quoi reconnaître "]]>" à cheval sur deux blocs
+                const std::size_t keep = terminator.size() - 1;
+                pos_ += rest.size() - keep;
+                return token{kind::text, {}, rest.substr(0, rest.size() - keep), false, true};
+            }
+            if (!refill() && failed_) return std::unexpected(*failed_);
+        }
+    }
+
+    inline bool tokenizer::skip_until(std::string_view terminator) {
+        for (;;) {
+            const std::size_t hit = available().find(terminator);
+            if (hit != std::string_view::npos) {
+                pos_ += hit + terminator.size();
+                return true;
+            }
+            pos_ = std::max(pos_, end_ - std::min(end_, terminator.size() - 1));
+            if (!refill()) return false;
+        }
+    }
+
+    inline std::expected<bool, error> tokenizer::skip_declaration() {
+        // Il faut au moins le début de la balise pour savoir de quoi il s'agit
+        while (end_ - pos_ < 9 && refill()) {}
+        const std::string_view head = available();
+
+        if (head.starts_with("<!--")) {
+            pos_ += 4;
+            if (!skip_until("-->")) return fail("commentaire non fermé");
+            return true;
+        }
+        if (head.starts_with("<?")) {
+            pos_ += 2;
+            if (!skip_until("?>")) return fail("instruction de traitement non fermée");
+            return true;
+        }
+        if (head.starts_with("<!") && !head.starts_with("<![CDATA[")) {
+            // DOCTYPE : le '>' final est hors du sous-ensemble interne entre crochets
+            pos_ += 2;
+            for (int brackets = 0;;) {
+                if (pos_ == end_ && !refill()) return fail("déclaration non fermée");
+                const char c = data_[pos_++];
+                if (c == '[') ++brackets;
+                else if (c == ']') --brackets;
+                else if (c == '>' && brackets == 0) return true;
+            }
+        }
+        return false;
+    }
+
+    inline std::expected<token, error> tokenizer::read_markup() {
+        if (available().starts_with("<![CDATA[")) {
+            pos_ += 9;
+            in_cdata_ = true;
+            return read_cdata();
+        }
+
+        // Fin de la balise : premier '>' hors des valeurs entre guillemets
+        for (;;) {
+            const char* const end = data_ + end_;
+            const char* p = data_ + pos_ + 1;
+            for (;;) {
+                p = detail::find<'>', '"', '\''>(p, end);
+                if (p == end || *p == '>') break;
+                const char* close = static_cast<const char*>(std::memchr(p + 1, *p, static_cast<std::size_t>(end - p - 1)));
+                p = close != nullptr ? close + 1 : end;
+            }
+            if (p != end) {
+                const auto tag_end = static_cast<std::size_t>(p - data_);
+                return data_[pos_ + 1] == '/' ? read_end_tag(tag_end) : read_start_tag(tag_end);
+            }
+            if (!refill()) {
+                if (failed_) return std::unexpected(*failed_);
+                return fail(eof_ ? "balise non fermée" : "balise trop longue");
+            }
+        }
+    }
+
+    inline std::expected<token, error> tokenizer::read_end_tag(std::size_t tag_end) {
+        std::string_view name(data_ + pos_ + 2, tag_end - pos_ - 2);
+        while (!name.empty() && detail::is_space(name.back())) name.remove_suffix(1);
+        if (name_ends_.empty() || name != top_name()) return fail("balise fermante inattendue");
+        pop_name();
+        pos_ = tag_end + 1;
+        return token{kind::end_element, name, {}};
+    }
+
+    inline std::expected<token, error> tokenizer::read_start_tag(std::size_t tag_end) {
+        std::string_view tag(data_ + pos_ + 1, tag_end - pos_ - 1);
+        const bool self_closing = tag.ends_with('/');
+        if (self_closing) tag.remove_suffix(1);
+
+        std::size_t i = 0;
+        while (i < tag.size() && !detail::is_name_end(tag[i])) ++i;
+        const std::string_view name = tag.substr(0, i);
+        if (name.empty()) return fail("nom d'élément attendu");
+
+        attributes_.clear();
+        next_attribute_ = 0;
+        for (;;) {
+            while (i < tag.size() && detail::is_space(tag[i])) ++i;
+            if (i == tag.size()) break;
+            const std::size_t name_begin = i;
+            while (i < tag.size() && !detail::is_name_end(tag[i])) ++i;
+            const std::string_view attribute_name = tag.substr(name_begin, i - name_begin);
+            while (i < tag.size() && detail::is_space(tag[i])) ++i;
+            if (attribute_name.empty() || i == tag.size() || tag[i] != '=') return fail("attribut mal formé");
+            ++i;
+            while (i < tag.size() && detail::is_space(tag[i])) ++i;
+            if (i == tag.size() || (tag[i] != '"' && tag[i] != '\'')) return fail("valeur d'attribut attendue");
+            const std::size_t close = tag.find(tag[i], i + 1);
+            if (close == std::string_view::npos) return fail("valeur d'attribut non fermée");
+            const std::string_view value = tag.substr(i + 1, close - i - 1);
+            attributes_.push_back({attribute_name, value, value.find('&') != std::string_view::npos});
+            i = close + 1;
+        }
+
+        push_name(name);
+        pending_close_ = self_closing;
+        pending_name_ = name;
+        pos_ = tag_end + 1;
+        return token{kind::start_element, name, {}};
+    }
+
+}  // namespace xml_stream
+
+#endif //CPP_23_XML_STREAM_H